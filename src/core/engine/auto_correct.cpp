@@ -1,51 +1,218 @@
 #include <string>
 #include <vector>
 #include <unordered_map>
+#include <unordered_set>
 #include <memory>
+#include <algorithm>
+#include <optional>
+#include <functional>
+#include <cctype>
 #include "auto_correct.h"
-#include "language_manager.h"
+#include "auto_correct_matcher.h"
+#include "language_resources.h"
 #include "user_preferences.h"
-#include "text_processing.h"
+#include "word_table.h"
 
 const int MAX_AUTOCORRECT_LENGTH = 50;
+const size_t TYPING_TRIM_SLACK = 64; // Typed text kept beyond the longest rule before trimming
+
+// The user rules and the language rules are matched by two automata, stepped
+// side by side over the same text
+struct AutoCorrect::Scan {
+    std::shared_ptr<const AutoCorrectMatcher> userRules;
+    std::shared_ptr<const LanguageResources> languageResources; // Null without language rules
+    uint32_t userState = 0;
+    uint32_t languageState = 0;
+
+    bool empty() const {
+        return userRules->empty() && (!languageResources || languageResources->autoCorrectMatcher().empty());
+    }
+
+    size_t maxRuleLength() const {
+        size_t length = userRules->maxRuleLength();
+        return languageResources ? std::max(length, languageResources->autoCorrectMatcher().maxRuleLength()) : length;
+    }
+
+    void step(unsigned char c) {
+        userState = userRules->step(userState, c);
+        if (languageResources) {
+            languageState = languageResources->autoCorrectMatcher().step(languageState, c);
+        }
+    }
+
+    // Puts the automata in the state reached after the given text
+    void restart(std::string_view text) {
+        userState = 0;
+        languageState = 0;
+        for (char c : text) {
+            step(static_cast<unsigned char>(c));
+        }
+    }
+};
+
+// Text typed since the last reset is followed one character at a time. Only
+// its tail is kept: enough to hold the longest rule and the byte before it.
+// Offsets count bytes since the reset, in the text as corrected.
+struct AutoCorrect::Typing {
+    Scan scan;
+    std::string recent;
+    size_t recentStart = 0;  // Offset of the first byte of recent
+    size_t correctedEnd = 0; // Text before this offset was corrected already
+    std::vector<AutoCorrectMatcher::Match> matches;
+};
 
 AutoCorrect::AutoCorrect() {
     // Initialize components
-    m_languageManager = std::make_shared<LanguageManager>();
     m_userPreferences = std::make_shared<UserPreferences>();
-    m_textProcessor = std::make_shared<TextProcessing>();
 
-    // Load default auto-correct rules
-    // TODO: Implement loading of default rules from a configuration file
+    // Default auto-correct rules are the generated table of the default
+    // language, shared by every instance instead of parsed and copied
+    auto& registry = LanguageResourceRegistry::global();
+    m_languageResources = registry.acquire(registry.defaultLanguage());
+    m_removedLanguageRules = std::make_shared<const std::unordered_set<std::string>>();
 
-    // Load user-defined auto-correct rules from preferences
-    auto userRules = m_userPreferences->getAutoCorrectRules();
-    m_autoCorrectRules.insert(userRules.begin(), userRules.end());
+    // Layer the user-defined auto-correct rules from preferences on top
+    m_autoCorrectRules = std::make_shared<const std::unordered_map<std::string, std::string>>(m_userPreferences->getAutoCorrectRules());
+
+    m_typing = std::make_unique<Typing>();
+    m_typing->scan = currentScan();
 }
 
+AutoCorrect::~AutoCorrect() = default;
+
 void AutoCorrect::applyAutoCorrect(std::string& text) {
-    // Tokenize the input text
-    std::vector<std::string> tokens = m_textProcessor->tokenizeText(text);
-
-    // Apply auto-correct rules to each token
-    for (auto& token : tokens) {
-        auto it = m_autoCorrectRules.find(token);
-        if (it != m_autoCorrectRules.end()) {
-            token = it->second;
+    // Scan the text once, stepping the automata of the user rules and of the
+    // language rules side by side
+    Scan scan = currentScan();
+    if (scan.empty()) {
+        return;
+    }
+    std::vector<AutoCorrectMatcher::Match> matches;
+    for (size_t pos = 0; pos < text.size(); ++pos) {
+        scan.step(static_cast<unsigned char>(text[pos]));
+        collectMatches(scan, text, pos + 1, matches);
+    }
+
+    // Replace by offset, so the original spacing and punctuation of the text
+    // are preserved
+    applyAutoCorrectMatches(text, matches);
+}
+
+std::optional<AutoCorrectReplacement> AutoCorrect::typeCharacter(char c) {
+    // Follow rule changes made since the last character with the new automata
+    Typing& typing = *m_typing;
+    Scan scan = currentScan();
+    if (scan.userRules != typing.scan.userRules || scan.languageResources != typing.scan.languageResources) {
+        typing.scan = std::move(scan);
+        typing.scan.restart(typing.recent);
+    }
+
+    // Word characters only advance the automata; a boundary may complete a rule
+    typing.recent.push_back(c);
+    std::optional<AutoCorrectReplacement> replacement;
+    if (!AutoCorrectMatcher::isWordByte(static_cast<unsigned char>(c))) {
+        replacement = correctBeforeBoundary(typing);
+    }
+    if (!replacement) {
+        typing.scan.step(static_cast<unsigned char>(c));
+    }
+
+    // Drop the text no rule can reach any more, in steps large enough to keep
+    // the cost per character constant
+    size_t keep = typing.scan.maxRuleLength() + 2;
+    if (typing.recent.size() > 2 * keep + TYPING_TRIM_SLACK) {
+        size_t drop = typing.recent.size() - keep;
+        typing.recent.erase(0, drop);
+        typing.recentStart += drop;
+    }
+    return replacement;
+}
+
+void AutoCorrect::resetTyping() {
+    // Called when the caret moves, so the next character starts a new stream
+    m_typing->recent.clear();
+    m_typing->recentStart = 0;
+    m_typing->correctedEnd = 0;
+    m_typing->scan.restart(std::string_view());
+}
+
+std::optional<AutoCorrectReplacement> AutoCorrect::correctBeforeBoundary(Typing& typing) {
+    // Rules ending just before the boundary, found from the automata's state
+    // before they step over it
+    size_t end = typing.recent.size() - 1;
+    typing.matches.clear();
+    collectMatches(typing.scan, typing.recent, end, typing.matches);
+
+    // The longest wins; of equal ones, the first collected. Text corrected
+    // already is not corrected again.
+    const AutoCorrectMatcher::Match* best = nullptr;
+    for (const auto& match : typing.matches) {
+        if (typing.recentStart + match.offset >= typing.correctedEnd && (!best || match.length > best->length)) {
+            best = &match;
         }
     }
+    if (!best) {
+        return std::nullopt;
+    }
+
+    AutoCorrectReplacement replacement;
+    replacement.offset = typing.recentStart + best->offset;
+    replacement.length = best->length;
+    replacement.text = *best->replacement;
+    if (best->capitalized && !replacement.text.empty()) {
+        replacement.text[0] = static_cast<char>(std::toupper(static_cast<unsigned char>(replacement.text[0])));
+    }
+
+    // Continue from the corrected text, boundary included
+    typing.recent.replace(best->offset, best->length, replacement.text);
+    typing.correctedEnd = replacement.offset + replacement.text.size();
+    typing.scan.restart(typing.recent);
+    return replacement;
+}
 
-    // Reconstruct the text from modified tokens
-    text = "";
-    for (const auto& token : tokens) {
-        text += token + " ";
+void AutoCorrect::collectMatches(const Scan& scan, std::string_view text, size_t end,
+                                 std::vector<AutoCorrectMatcher::Match>& matches) const {
+    // User rules are collected first, so they win over a language rule
+    // matching the same text
+    scan.userRules->collectMatches(scan.userState, text, end, matches);
+    if (!scan.languageResources) {
+        return;
     }
-    // Remove the trailing space
-    if (!text.empty()) {
-        text.pop_back();
+    size_t userMatches = matches.size();
+    scan.languageResources->autoCorrectMatcher().collectMatches(scan.languageState, text, end, matches);
+
+    // Language rules removed for this instance are skipped
+    if (!m_removedLanguageRules->empty()) {
+        matches.erase(std::remove_if(matches.begin() + userMatches, matches.end(),
+                                     [this](const auto& match) { return m_removedLanguageRules->count(*match.pattern) != 0; }),
+                      matches.end());
     }
 }
 
+AutoCorrect::Scan AutoCorrect::currentScan() {
+    Scan scan;
+    scan.userRules = userMatcher();
+    scan.languageResources = m_languageResources;
+    return scan;
+}
+
+std::optional<std::string_view> AutoCorrect::findCorrection(uint32_t wordId) const {
+    // Callers look up words the table did not intern by their text
+    if (wordId == INVALID_WORD_ID) {
+        return std::nullopt;
+    }
+    return getAutoCorrectRules().find(WordTable::global().text(wordId));
+}
+
+std::shared_ptr<const AutoCorrectMatcher> AutoCorrect::userMatcher() {
+    // Rules change rarely, so the user rules are compiled again as a whole
+    if (!m_userMatcher) {
+        m_userMatcher = std::make_shared<AutoCorrectMatcher>(
+            std::vector<std::pair<std::string_view, std::string_view>>(m_autoCorrectRules->begin(), m_autoCorrectRules->end()));
+    }
+    return m_userMatcher;
+}
+
 bool AutoCorrect::addAutoCorrectRule(const std::string& incorrect, const std::string& correct) {
     // Validate input strings
     if (incorrect.empty() || correct.empty() || 
@@ -54,8 +221,12 @@ bool AutoCorrect::addAutoCorrectRule(const std::string& incorrect, const std::st
         return false;
     }
 
-    // Add the rule to m_autoCorrectRules
-    m_autoCorrectRules[incorrect] = correct;
+    // Add the rule to a copy of m_autoCorrectRules, so snapshots taken
+    // earlier keep the rules they saw; the matcher is recompiled on next use
+    auto rules = std::make_shared<std::unordered_map<std::string, std::string>>(*m_autoCorrectRules);
+    (*rules)[incorrect] = correct;
+    m_autoCorrectRules = std::move(rules);
+    m_userMatcher.reset();
 
     // Update user preferences with the new rule
     m_userPreferences->addAutoCorrectRule(incorrect, correct);
@@ -64,14 +235,27 @@ bool AutoCorrect::addAutoCorrectRule(const std::string& incorrect, const std::st
 }
 
 bool AutoCorrect::removeAutoCorrectRule(const std::string& incorrect) {
-    // Check if the rule exists
-    auto it = m_autoCorrectRules.find(incorrect);
-    if (it == m_autoCorrectRules.end()) {
+    // Check if the rule exists, either as a user rule or as a language rule
+    bool isUserRule = m_autoCorrectRules->count(incorrect) != 0;
+    bool isLanguageRule = m_languageResources && m_languageResources->findAutoCorrection(incorrect) &&
+                          !m_removedLanguageRules->count(incorrect);
+    if (!isUserRule && !isLanguageRule) {
         return false;
     }
 
-    // Remove the rule from m_autoCorrectRules
-    m_autoCorrectRules.erase(it);
+    // Remove the rule from a copy of m_autoCorrectRules; shared language
+    // rules are masked for this instance instead
+    if (isUserRule) {
+        auto rules = std::make_shared<std::unordered_map<std::string, std::string>>(*m_autoCorrectRules);
+        rules->erase(incorrect);
+        m_autoCorrectRules = std::move(rules);
+        m_userMatcher.reset();
+    }
+    if (isLanguageRule) {
+        auto removed = std::make_shared<std::unordered_set<std::string>>(*m_removedLanguageRules);
+        removed->insert(incorrect);
+        m_removedLanguageRules = std::move(removed);
+    }
 
     // Update user preferences to remove the rule
     m_userPreferences->removeAutoCorrectRule(incorrect);
@@ -80,20 +264,66 @@ bool AutoCorrect::removeAutoCorrectRule(const std::string& incorrect) {
 }
 
 void AutoCorrect::loadLanguageSpecificRules(const std::string& languageCode) {
-    // Get language-specific auto-correct rules
-    auto languageRules = m_languageManager->getAutoCorrectRules(languageCode);
-
-    // Merge language-specific rules with m_autoCorrectRules
-    for (const auto& rule : languageRules) {
-        // Prioritize user-defined rules over language-specific rules
-        if (m_autoCorrectRules.find(rule.first) == m_autoCorrectRules.end()) {
-            m_autoCorrectRules[rule.first] = rule.second;
+    // Use the language's shared rule table instead of copying it; user-defined
+    // rules are looked up first, so they keep priority over language rules
+    m_languageResources = LanguageResourceRegistry::global().acquire(languageCode);
+    m_removedLanguageRules = std::make_shared<const std::unordered_set<std::string>>();
+}
+
+AutoCorrectRules AutoCorrect::getAutoCorrectRules() const {
+    // The snapshot shares the rule tables instead of merging them into a copy
+    return AutoCorrectRules(m_autoCorrectRules, m_removedLanguageRules, m_languageResources);
+}
+
+AutoCorrectRules::AutoCorrectRules(std::shared_ptr<const std::unordered_map<std::string, std::string>> userRules,
+                                   std::shared_ptr<const std::unordered_set<std::string>> removedLanguageRules,
+                                   std::shared_ptr<const LanguageResources> languageResources)
+    : m_userRules(std::move(userRules)),
+      m_removedLanguageRules(std::move(removedLanguageRules)),
+      m_languageResources(std::move(languageResources)) {
+}
+
+std::optional<std::string_view> AutoCorrectRules::find(std::string_view incorrect) const {
+    // User rules first, then the language rules this instance did not remove
+    std::string key(incorrect);
+    auto rule = m_userRules->find(key);
+    if (rule != m_userRules->end()) {
+        return std::string_view(rule->second);
+    }
+    if (!m_languageResources || m_removedLanguageRules->count(key)) {
+        return std::nullopt;
+    }
+    return m_languageResources->findAutoCorrection(incorrect);
+}
+
+size_t AutoCorrectRules::size() const {
+    // Only language rules are ever removed, and a language rule with a user
+    // rule of its own is counted once
+    size_t size = m_userRules->size();
+    if (m_languageResources) {
+        size += m_languageResources->autoCorrectRuleCount() - m_removedLanguageRules->size();
+        for (const auto& rule : *m_userRules) {
+            if (!m_removedLanguageRules->count(rule.first) && m_languageResources->findAutoCorrection(rule.first)) {
+                --size;
+            }
         }
     }
+    return size;
 }
 
-std::unordered_map<std::string, std::string> AutoCorrect::getAutoCorrectRules() const {
-    return m_autoCorrectRules;
+void AutoCorrectRules::forEach(const std::function<void(std::string_view, std::string_view)>& visit) const {
+    for (const auto& rule : *m_userRules) {
+        visit(rule.first, rule.second);
+    }
+    if (!m_languageResources) {
+        return;
+    }
+    m_languageResources->forEachAutoCorrection([this, &visit](std::string_view incorrect, std::string_view correct) {
+        std::string key(incorrect);
+        if (!m_userRules->count(key) && !m_removedLanguageRules->count(key)) {
+            visit(incorrect, correct);
+        }
+    });
 }
 
 std::string sanitizeAutoCorrectInput(const std::string& input) {
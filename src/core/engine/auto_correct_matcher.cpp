@@ -0,0 +1,238 @@
+#include <string>
+#include <string_view>
+#include <vector>
+#include <map>
+#include <algorithm>
+#include <cstdint>
+#include <cctype>
+#include "auto_correct_matcher.h"
+#include "char_classifier.h"
+
+// Auto-correct rules are compiled into an Aho-Corasick automaton over the
+// bytes of their incorrect text, so a text is scanned once whatever the number
+// of rules, and rules may span several words or contain punctuation. A rule
+// only matches where its ends fall on word boundaries, so "teh" corrects
+// "teh" but not "tehran". Rules starting with a lowercase letter also match
+// with that letter capitalised, and their replacement is capitalised too.
+const size_t MAX_LINEAR_EDGE_SCAN = 8; // Wider states are searched by bisection
+
+struct AutoCorrectMatcher::State {
+    uint32_t firstEdge = 0;
+    uint32_t edgeCount = 0;
+    uint32_t failure = 0;
+    uint32_t depth = 0;
+    uint32_t rule = NO_RULE;
+    uint32_t outputLink = 0;  // Nearest state on the failure chain with a rule
+    bool capitalized = false; // Matched through the capitalised form of the rule
+};
+
+struct AutoCorrectMatcher::Edge {
+    unsigned char byte;
+    uint32_t target;
+};
+
+AutoCorrectMatcher::AutoCorrectMatcher()
+    : m_states(1) {
+    m_rootTransitions.fill(0);
+}
+
+AutoCorrectMatcher::AutoCorrectMatcher(const std::vector<std::pair<std::string_view, std::string_view>>& rules)
+    : AutoCorrectMatcher() {
+    // Sort the rules so the automaton does not depend on their order
+    for (const auto& rule : rules) {
+        if (!rule.first.empty()) {
+            m_rules.emplace_back(rule.first, rule.second);
+        }
+    }
+    std::sort(m_rules.begin(), m_rules.end());
+
+    // Build the trie with ordered child maps, which are flattened below. The
+    // capitalised forms go in after every rule, so a rule written with a
+    // capital keeps its own replacement.
+    std::vector<std::map<unsigned char, uint32_t>> children(1);
+    auto insert = [this, &children](const std::string& pattern, uint32_t rule, bool capitalized) {
+        uint32_t state = 0;
+        for (unsigned char c : pattern) {
+            auto child = children[state].find(c);
+            if (child != children[state].end()) {
+                state = child->second;
+                continue;
+            }
+            uint32_t next = static_cast<uint32_t>(m_states.size());
+            children[state].emplace(c, next);
+            children.emplace_back();
+            m_states.emplace_back();
+            m_states.back().depth = m_states[state].depth + 1;
+            state = next;
+        }
+        m_maxRuleLength = std::max<size_t>(m_maxRuleLength, pattern.size());
+        if (m_states[state].rule == NO_RULE) {
+            m_states[state].rule = rule;
+            m_states[state].capitalized = capitalized;
+        }
+    };
+    for (uint32_t rule = 0; rule < m_rules.size(); ++rule) {
+        insert(m_rules[rule].first, rule, false);
+    }
+    for (uint32_t rule = 0; rule < m_rules.size(); ++rule) {
+        std::string pattern = m_rules[rule].first;
+        if (std::islower(static_cast<unsigned char>(pattern[0]))) {
+            pattern[0] = static_cast<char>(std::toupper(static_cast<unsigned char>(pattern[0])));
+            insert(pattern, rule, true);
+        }
+    }
+
+    // Flatten the children into sorted edge ranges
+    for (size_t state = 0; state < children.size(); ++state) {
+        m_states[state].firstEdge = static_cast<uint32_t>(m_edges.size());
+        m_states[state].edgeCount = static_cast<uint32_t>(children[state].size());
+        for (const auto& child : children[state]) {
+            m_edges.push_back({child.first, child.second});
+        }
+    }
+    for (const auto& child : children[0]) {
+        m_rootTransitions[child.first] = child.second;
+    }
+
+    // Link each state to its longest proper suffix in the trie, breadth first
+    // so that every shorter suffix is linked before it is needed
+    std::vector<uint32_t> queue;
+    for (const auto& child : children[0]) {
+        queue.push_back(child.second);
+    }
+    for (size_t next = 0; next < queue.size(); ++next) {
+        uint32_t state = queue[next];
+        for (const auto& child : children[state]) {
+            State& target = m_states[child.second];
+            target.failure = transition(m_states[state].failure, child.first);
+            const State& failure = m_states[target.failure];
+            target.outputLink = failure.rule != NO_RULE ? target.failure : failure.outputLink;
+            queue.push_back(child.second);
+        }
+    }
+}
+
+AutoCorrectMatcher::~AutoCorrectMatcher() = default;
+
+bool AutoCorrectMatcher::isWordByte(unsigned char c) {
+    // Letters, digits and UTF-8 sequences continue a word; anything else ends it
+    return c >= 0x80 || classifyCharacter(c) == CharClass::Alphanumeric;
+}
+
+uint32_t AutoCorrectMatcher::transition(uint32_t state, unsigned char c) const {
+    // Follow failure links until a state has an edge for the byte; the root
+    // has a full table, so the loop always ends there
+    while (state != 0) {
+        uint32_t next = child(state, c);
+        if (next != 0) {
+            return next;
+        }
+        state = m_states[state].failure;
+    }
+    return m_rootTransitions[c];
+}
+
+uint32_t AutoCorrectMatcher::child(uint32_t state, unsigned char c) const {
+    // The root is never a child, so zero means there is no edge
+    const State& from = m_states[state];
+    auto first = m_edges.begin() + from.firstEdge;
+    auto last = first + from.edgeCount;
+    if (from.edgeCount <= MAX_LINEAR_EDGE_SCAN) {
+        for (auto edge = first; edge != last; ++edge) {
+            if (edge->byte == c) {
+                return edge->target;
+            }
+        }
+        return 0;
+    }
+    auto edge = std::lower_bound(first, last, c, [](const Edge& e, unsigned char value) { return e.byte < value; });
+    return edge != last && edge->byte == c ? edge->target : 0;
+}
+
+uint32_t AutoCorrectMatcher::step(uint32_t state, unsigned char c) const {
+    return transition(state, c);
+}
+
+void AutoCorrectMatcher::collectMatches(uint32_t state, std::string_view text, size_t end, std::vector<Match>& matches) const {
+    // Every rule ending at this position is on the state's output chain
+    uint32_t output = m_states[state].rule != NO_RULE ? state : m_states[state].outputLink;
+    for (; output != 0; output = m_states[output].outputLink) {
+        const State& matched = m_states[output];
+        size_t start = end - matched.depth;
+        const std::string& pattern = m_rules[matched.rule].first;
+
+        // Ends made of word characters must not continue into the text around them
+        if (isWordByte(static_cast<unsigned char>(pattern.front())) && start > 0 &&
+            isWordByte(static_cast<unsigned char>(text[start - 1]))) {
+            continue;
+        }
+        if (isWordByte(static_cast<unsigned char>(pattern.back())) && end < text.size() &&
+            isWordByte(static_cast<unsigned char>(text[end]))) {
+            continue;
+        }
+        matches.push_back({start, matched.depth, &pattern, &m_rules[matched.rule].second, matched.capitalized});
+    }
+}
+
+void AutoCorrectMatcher::findMatches(std::string_view text, std::vector<Match>& matches) const {
+    if (m_rules.empty()) {
+        return;
+    }
+    uint32_t state = 0;
+    for (size_t pos = 0; pos < text.size(); ++pos) {
+        state = transition(state, static_cast<unsigned char>(text[pos]));
+        collectMatches(state, text, pos + 1, matches);
+    }
+}
+
+bool AutoCorrectMatcher::empty() const {
+    return m_rules.empty();
+}
+
+size_t AutoCorrectMatcher::ruleCount() const {
+    return m_rules.size();
+}
+
+size_t AutoCorrectMatcher::maxRuleLength() const {
+    return m_maxRuleLength;
+}
+
+size_t AutoCorrectMatcher::memoryBytes() const {
+    size_t bytes = sizeof(*this) + m_states.capacity() * sizeof(State) + m_edges.capacity() * sizeof(Edge);
+    for (const auto& rule : m_rules) {
+        bytes += sizeof(rule) + rule.first.capacity() + rule.second.capacity();
+    }
+    return bytes;
+}
+
+void applyAutoCorrectMatches(std::string& text, std::vector<AutoCorrectMatcher::Match>& matches) {
+    if (matches.empty()) {
+        return;
+    }
+
+    // Leftmost-longest: of overlapping matches the earliest wins, then the
+    // longest. The sort is stable, so of two rules matching the same text the
+    // one found first wins.
+    std::stable_sort(matches.begin(), matches.end(), [](const auto& a, const auto& b) {
+        return a.offset != b.offset ? a.offset < b.offset : a.length > b.length;
+    });
+
+    // Rebuild the text once, copying everything between the replaced spans
+    std::string corrected;
+    corrected.reserve(text.size());
+    size_t copied = 0;
+    for (const auto& match : matches) {
+        if (match.offset < copied) {
+            continue;
+        }
+        corrected.append(text, copied, match.offset - copied);
+        size_t replacementStart = corrected.size();
+        corrected += *match.replacement;
+        if (match.capitalized && replacementStart < corrected.size()) {
+            corrected[replacementStart] = static_cast<char>(std::toupper(static_cast<unsigned char>(corrected[replacementStart])));
+        }
+        copied = match.offset + match.length;
+    }
+    corrected.append(text, copied, std::string::npos);
+    text.swap(corrected);
+}
@@ -0,0 +1,202 @@
+#include <cstddef>
+#include <cstdint>
+#include <array>
+#include "char_classifier.h"
+
+#if defined(__x86_64__) || defined(_M_X64)
+#define CHAR_CLASSIFIER_X86 1
+#include <immintrin.h>
+#if defined(_MSC_VER)
+#include <intrin.h>
+#endif
+#endif
+
+// Classifies ASCII bytes for the tokenizer's fast path. Classes match
+// std::isalnum/std::isspace in the "C" locale; bytes at or above 0x80 are
+// always Other and are left to the UTF-8 segmentation in text_segmentation.cpp.
+namespace {
+
+constexpr std::array<CharClass, 256> buildClassTable() {
+    std::array<CharClass, 256> table{};
+    for (int c = 0; c < 256; ++c) {
+        table[c] = CharClass::Other;
+    }
+    for (int c = '0'; c <= '9'; ++c) {
+        table[c] = CharClass::Alphanumeric;
+    }
+    for (int c = 'a'; c <= 'z'; ++c) {
+        table[c] = CharClass::Alphanumeric;
+        table[c - 'a' + 'A'] = CharClass::Alphanumeric;
+    }
+    table[' '] = CharClass::Whitespace;
+    for (int c = '\t'; c <= '\r'; ++c) {
+        table[c] = CharClass::Whitespace;
+    }
+    return table;
+}
+
+constexpr std::array<CharClass, 256> CLASS_TABLE = buildClassTable();
+
+inline unsigned countTrailingZeros(uint32_t mask) {
+#if defined(_MSC_VER) && !defined(__clang__)
+    unsigned long index;
+    _BitScanForward(&index, mask);
+    return static_cast<unsigned>(index);
+#else
+    return static_cast<unsigned>(__builtin_ctz(mask));
+#endif
+}
+
+size_t findAlnumEndScalar(const char* data, size_t size, size_t pos) {
+    while (pos < size && CLASS_TABLE[static_cast<unsigned char>(data[pos])] == CharClass::Alphanumeric) {
+        ++pos;
+    }
+    return pos;
+}
+
+size_t skipWhitespaceScalar(const char* data, size_t size, size_t pos) {
+    while (pos < size && CLASS_TABLE[static_cast<unsigned char>(data[pos])] == CharClass::Whitespace) {
+        ++pos;
+    }
+    return pos;
+}
+
+#ifdef CHAR_CLASSIFIER_X86
+
+// SSE2 has no unsigned byte comparison, so a range check subtracts the lower
+// bound and tests whether the result is unchanged by min(result, width)
+inline __m128i inRange128(__m128i bytes, char lo, char hi) {
+    __m128i shifted = _mm_sub_epi8(bytes, _mm_set1_epi8(lo));
+    return _mm_cmpeq_epi8(_mm_min_epu8(shifted, _mm_set1_epi8(static_cast<char>(hi - lo))), shifted);
+}
+
+inline uint32_t alnumMask128(__m128i bytes) {
+    __m128i digits = inRange128(bytes, '0', '9');
+    __m128i letters = inRange128(_mm_or_si128(bytes, _mm_set1_epi8(0x20)), 'a', 'z');
+    return static_cast<uint32_t>(_mm_movemask_epi8(_mm_or_si128(digits, letters)));
+}
+
+inline uint32_t whitespaceMask128(__m128i bytes) {
+    __m128i spaces = _mm_cmpeq_epi8(bytes, _mm_set1_epi8(' '));
+    __m128i controls = inRange128(bytes, '\t', '\r');
+    return static_cast<uint32_t>(_mm_movemask_epi8(_mm_or_si128(spaces, controls)));
+}
+
+size_t findAlnumEndSse2(const char* data, size_t size, size_t pos) {
+    while (pos + 16 <= size) {
+        __m128i bytes = _mm_loadu_si128(reinterpret_cast<const __m128i*>(data + pos));
+        uint32_t boundaries = ~alnumMask128(bytes) & 0xFFFFu;
+        if (boundaries != 0) {
+            return pos + countTrailingZeros(boundaries);
+        }
+        pos += 16;
+    }
+    return findAlnumEndScalar(data, size, pos);
+}
+
+size_t skipWhitespaceSse2(const char* data, size_t size, size_t pos) {
+    while (pos + 16 <= size) {
+        __m128i bytes = _mm_loadu_si128(reinterpret_cast<const __m128i*>(data + pos));
+        uint32_t boundaries = ~whitespaceMask128(bytes) & 0xFFFFu;
+        if (boundaries != 0) {
+            return pos + countTrailingZeros(boundaries);
+        }
+        pos += 16;
+    }
+    return skipWhitespaceScalar(data, size, pos);
+}
+
+#if defined(__GNUC__) || defined(__clang__)
+#define CHAR_CLASSIFIER_AVX2_TARGET __attribute__((target("avx2")))
+#else
+#define CHAR_CLASSIFIER_AVX2_TARGET
+#endif
+
+CHAR_CLASSIFIER_AVX2_TARGET inline __m256i inRange256(__m256i bytes, char lo, char hi) {
+    __m256i shifted = _mm256_sub_epi8(bytes, _mm256_set1_epi8(lo));
+    return _mm256_cmpeq_epi8(_mm256_min_epu8(shifted, _mm256_set1_epi8(static_cast<char>(hi - lo))), shifted);
+}
+
+CHAR_CLASSIFIER_AVX2_TARGET size_t findAlnumEndAvx2(const char* data, size_t size, size_t pos) {
+    while (pos + 32 <= size) {
+        __m256i bytes = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(data + pos));
+        __m256i digits = inRange256(bytes, '0', '9');
+        __m256i letters = inRange256(_mm256_or_si256(bytes, _mm256_set1_epi8(0x20)), 'a', 'z');
+        uint32_t alnum = static_cast<uint32_t>(_mm256_movemask_epi8(_mm256_or_si256(digits, letters)));
+        if (alnum != 0xFFFFFFFFu) {
+            return pos + countTrailingZeros(~alnum);
+        }
+        pos += 32;
+    }
+    return findAlnumEndSse2(data, size, pos);
+}
+
+CHAR_CLASSIFIER_AVX2_TARGET size_t skipWhitespaceAvx2(const char* data, size_t size, size_t pos) {
+    while (pos + 32 <= size) {
+        __m256i bytes = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(data + pos));
+        __m256i spaces = _mm256_cmpeq_epi8(bytes, _mm256_set1_epi8(' '));
+        __m256i controls = inRange256(bytes, '\t', '\r');
+        uint32_t whitespace = static_cast<uint32_t>(_mm256_movemask_epi8(_mm256_or_si256(spaces, controls)));
+        if (whitespace != 0xFFFFFFFFu) {
+            return pos + countTrailingZeros(~whitespace);
+        }
+        pos += 32;
+    }
+    return skipWhitespaceSse2(data, size, pos);
+}
+
+bool cpuSupportsAvx2() {
+#if defined(_MSC_VER) && !defined(__clang__)
+    int info[4];
+    __cpuid(info, 0);
+    if (info[0] < 7) {
+        return false;
+    }
+    // AVX2 also needs the OS to save the YMM registers on context switches
+    __cpuid(info, 1);
+    bool osSavesYmm = (info[2] & (1 << 27)) && (_xgetbv(0) & 0x6) == 0x6;
+    __cpuidex(info, 7, 0);
+    return osSavesYmm && (info[1] & (1 << 5));
+#else
+    __builtin_cpu_init();
+    return __builtin_cpu_supports("avx2");
+#endif
+}
+
+#endif // CHAR_CLASSIFIER_X86
+
+struct ClassifierKernels {
+    size_t (*findAlnumEnd)(const char*, size_t, size_t);
+    size_t (*skipWhitespace)(const char*, size_t, size_t);
+};
+
+// Selects the widest kernel the CPU supports; SSE2 is part of the x86-64 baseline
+ClassifierKernels selectKernels() {
+#ifdef CHAR_CLASSIFIER_X86
+    if (cpuSupportsAvx2()) {
+        return {findAlnumEndAvx2, skipWhitespaceAvx2};
+    }
+    return {findAlnumEndSse2, skipWhitespaceSse2};
+#else
+    return {findAlnumEndScalar, skipWhitespaceScalar};
+#endif
+}
+
+const ClassifierKernels& kernels() {
+    static const ClassifierKernels selected = selectKernels();
+    return selected;
+}
+
+} // namespace
+
+CharClass classifyCharacter(unsigned char c) {
+    return CLASS_TABLE[c];
+}
+
+size_t findAlnumEnd(const char* data, size_t size, size_t pos) {
+    return kernels().findAlnumEnd(data, size, pos);
+}
+
+size_t skipWhitespace(const char* data, size_t size, size_t pos) {
+    return kernels().skipWhitespace(data, size, pos);
+}
@@ -0,0 +1,1351 @@
+#include <string>
+#include <string_view>
+#include <vector>
+#include <map>
+#include <set>
+#include <unordered_map>
+#include <memory>
+#include <fstream>
+#include <filesystem>
+#include <sstream>
+#include <algorithm>
+#include <cstdint>
+#include <cstring>
+#include <cctype>
+#include "compiled_dictionary.h"
+
+#ifdef _WIN32
+#include <windows.h>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+// Binary image of a Hunspell dictionary. Stems are sorted and front-coded in
+// blocks of STEM_BLOCK_SIZE entries, each entry referring to a deduplicated
+// flag set; prefix and suffix rules are stored as fixed-size records over a
+// string pool. The image is mapped read-only, so the page cache shares one
+// copy between every process that opens the same dictionary.
+//
+// The header records the size and modification time of the .aff and .dic
+// files the image was compiled from, so an image left behind by a dictionary
+// update is rejected rather than giving verdicts for the old word list.
+//
+// Only the single-level PFX/SFX subset of the affix format is compiled. For
+// anything else compileDictionary() reports Unsupported and SpellCheck keeps
+// using Hunspell for that language.
+const char COMPILED_DICTIONARY_MAGIC[8] = {'W', 'D', 'I', 'C', 'T', 'I', 'M', 'G'};
+const uint32_t COMPILED_DICTIONARY_VERSION = 3;
+const uint32_t STEM_BLOCK_SIZE = 16;
+const size_t MAX_COMPILED_WORD_LENGTH = 100; // Hunspell handles anything longer itself
+const uint32_t IMAGE_KNOWN_WORDS_ONLY = 1;   // No stems: only the known-word set is authoritative
+const size_t DEFAULT_KNOWN_WORD_LIMIT = 50000;
+const uint32_t KNOWN_WORDS_PER_BUCKET = 4;
+const uint32_t MAX_KNOWN_WORD_SEEDS = 16;
+const int MAX_RETIRED_IMAGES = 8;            // Old images still mapped on Windows, kept under numbered names
+
+namespace {
+
+struct SourceStamp {
+    uint64_t size;
+    int64_t modified; // File clock ticks since its epoch
+};
+
+struct ImageHeader {
+    char magic[8];
+    uint32_t version;
+    uint32_t wordCount;
+    uint32_t blockCount;
+    uint32_t affixCount;
+    uint32_t inputConversionCount;
+    uint32_t flags;
+    uint64_t blockIndexOffset;  // uint32_t per block: offset of the block inside the block data
+    uint64_t blockDataOffset;
+    uint64_t blockDataSize;
+    uint64_t flagPoolOffset;    // uint16_t count followed by that many sorted flags, per set
+    uint64_t flagPoolSize;      // In uint16_t units
+    uint64_t affixOffset;       // AffixRecord per rule
+    uint64_t conversionOffset;  // StringRef per ICONV input pattern
+    uint64_t stringPoolOffset;
+    uint64_t stringPoolSize;
+    uint64_t knownSeed;
+    uint32_t knownWordCount;
+    uint32_t knownBucketCount;
+    uint64_t knownDisplacementOffset; // uint32_t per bucket
+    uint64_t knownSlotOffset;         // uint32_t per word: offset of its key in the key pool
+    uint64_t knownKeyPoolOffset;      // uint8_t length followed by the word's bytes, per word
+    uint64_t knownKeyPoolSize;
+    SourceStamp affSource;
+    SourceStamp dicSource;
+};
+
+// Helper function to stamp a source file; a missing file gets a zero stamp
+SourceStamp stampSource(const std::string& path) {
+    std::error_code error;
+    SourceStamp stamp = {};
+    auto size = std::filesystem::file_size(path, error);
+    if (error) {
+        return stamp;
+    }
+    auto modified = std::filesystem::last_write_time(path, error);
+    if (error) {
+        return stamp;
+    }
+    stamp.size = size;
+    stamp.modified = static_cast<int64_t>(modified.time_since_epoch().count());
+    return stamp;
+}
+
+bool sameStamp(const SourceStamp& a, const SourceStamp& b) {
+    return a.size == b.size && a.modified == b.modified;
+}
+
+struct StringRef {
+    uint32_t offset;
+    uint32_t length;
+};
+
+struct AffixRecord {
+    uint16_t flag;
+    uint8_t isPrefix;
+    uint8_t crossProduct;
+    StringRef strip;
+    StringRef append;
+    StringRef condition;
+};
+
+// Helper function to decode one UTF-8 code point, treating malformed bytes as themselves
+char32_t decodeCodePoint(std::string_view text, size_t& pos) {
+    unsigned char lead = static_cast<unsigned char>(text[pos]);
+    size_t length = lead < 0x80 ? 1 : (lead >> 5) == 0x6 ? 2 : (lead >> 4) == 0xE ? 3 : (lead >> 3) == 0x1E ? 4 : 1;
+    if (pos + length > text.size()) {
+        length = 1;
+    }
+    char32_t codePoint = length == 1 ? lead : lead & (0x7F >> length);
+    for (size_t i = 1; i < length; ++i) {
+        unsigned char next = static_cast<unsigned char>(text[pos + i]);
+        if ((next & 0xC0) != 0x80) {
+            ++pos;
+            return lead;
+        }
+        codePoint = (codePoint << 6) | (next & 0x3F);
+    }
+    pos += length;
+    return codePoint;
+}
+
+std::vector<char32_t> decodeCodePoints(std::string_view text) {
+    std::vector<char32_t> codePoints;
+    for (size_t pos = 0; pos < text.size();) {
+        codePoints.push_back(decodeCodePoint(text, pos));
+    }
+    return codePoints;
+}
+
+void writeVarint(std::string& out, uint32_t value) {
+    while (value >= 0x80) {
+        out.push_back(static_cast<char>((value & 0x7F) | 0x80));
+        value >>= 7;
+    }
+    out.push_back(static_cast<char>(value));
+}
+
+uint32_t readVarint(const uint8_t*& p) {
+    uint32_t value = 0;
+    for (int shift = 0;; shift += 7) {
+        uint8_t byte = *p++;
+        value |= static_cast<uint32_t>(byte & 0x7F) << shift;
+        if (!(byte & 0x80)) {
+            return value;
+        }
+    }
+}
+
+bool isAsciiLetter(char c) {
+    return (c >= 'a' && c <= 'z') || (c >= 'A' && c <= 'Z');
+}
+
+bool isAsciiUpper(char c) {
+    return c >= 'A' && c <= 'Z';
+}
+
+uint64_t mixHash(uint64_t value) {
+    value ^= value >> 30;
+    value *= 0xBF58476D1CE4E5B9ull;
+    value ^= value >> 27;
+    value *= 0x94D049BB133111EBull;
+    return value ^ (value >> 31);
+}
+
+// Position of a word in the known-word table: its bucket and the two hashes
+// that, with the bucket's displacement, select its slot
+struct KnownWordHash {
+    uint64_t bucket;
+    uint64_t first;
+    uint64_t second;
+};
+
+KnownWordHash hashKnownWord(std::string_view word, uint64_t seed, uint64_t bucketCount, uint64_t slotCount) {
+    uint64_t hash = 14695981039346656037ull ^ seed;
+    for (unsigned char c : word) {
+        hash ^= c;
+        hash *= 1099511628211ull;
+    }
+    uint64_t a = mixHash(hash);
+    uint64_t b = mixHash(hash ^ 0x9E3779B97F4A7C15ull);
+    return {a % bucketCount, b % slotCount, (b >> 32) % slotCount};
+}
+
+// The displacement index encodes a pair (d0, d1): slot = (first + d1 + d0 * second) mod slots.
+// Scanning d1 over every slot guarantees a single-word bucket always finds a free one.
+uint64_t knownWordSlot(const KnownWordHash& hash, uint64_t displacement, uint64_t slotCount) {
+    uint64_t d0 = displacement / slotCount;
+    uint64_t d1 = displacement % slotCount;
+    return (hash.first + d1 + d0 * hash.second) % slotCount;
+}
+
+} // namespace
+
+// One element of an affix condition: a literal, a bracket set, or '.'
+struct CompiledDictionary::ConditionElement {
+    bool any = false;
+    bool negated = false;
+    std::vector<char32_t> characters;
+
+    bool matches(char32_t c) const {
+        if (any) {
+            return true;
+        }
+        bool found = std::find(characters.begin(), characters.end(), c) != characters.end();
+        return found != negated;
+    }
+};
+
+struct CompiledDictionary::AffixRule {
+    uint16_t flag;
+    bool crossProduct;
+    std::string_view strip;
+    std::string_view append;
+    std::vector<ConditionElement> condition;
+};
+
+// Read-only view of the image file, mapped with the platform's file mapping API
+class CompiledDictionary::MappedFile {
+public:
+    static std::unique_ptr<MappedFile> open(const std::string& path) {
+        auto file = std::unique_ptr<MappedFile>(new MappedFile());
+#ifdef _WIN32
+        // FILE_SHARE_DELETE lets compileDictionary move the image aside while it is mapped
+        file->m_file = CreateFileA(path.c_str(), GENERIC_READ, FILE_SHARE_READ | FILE_SHARE_DELETE, nullptr,
+                                   OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, nullptr);
+        if (file->m_file == INVALID_HANDLE_VALUE) {
+            return nullptr;
+        }
+        LARGE_INTEGER size;
+        if (!GetFileSizeEx(file->m_file, &size) || size.QuadPart == 0) {
+            return nullptr;
+        }
+        file->m_size = static_cast<size_t>(size.QuadPart);
+        file->m_mapping = CreateFileMappingA(file->m_file, nullptr, PAGE_READONLY, 0, 0, nullptr);
+        if (!file->m_mapping) {
+            return nullptr;
+        }
+        file->m_data = static_cast<const uint8_t*>(MapViewOfFile(file->m_mapping, FILE_MAP_READ, 0, 0, 0));
+#else
+        int descriptor = ::open(path.c_str(), O_RDONLY);
+        if (descriptor < 0) {
+            return nullptr;
+        }
+        struct stat status;
+        if (fstat(descriptor, &status) != 0 || status.st_size == 0) {
+            ::close(descriptor);
+            return nullptr;
+        }
+        file->m_size = static_cast<size_t>(status.st_size);
+        void* data = mmap(nullptr, file->m_size, PROT_READ, MAP_SHARED, descriptor, 0);
+        ::close(descriptor);
+        if (data == MAP_FAILED) {
+            return nullptr;
+        }
+        file->m_data = static_cast<const uint8_t*>(data);
+#endif
+        if (!file->m_data) {
+            return nullptr;
+        }
+        return file;
+    }
+
+    ~MappedFile() {
+#ifdef _WIN32
+        if (m_data) {
+            UnmapViewOfFile(m_data);
+        }
+        if (m_mapping) {
+            CloseHandle(m_mapping);
+        }
+        if (m_file != INVALID_HANDLE_VALUE) {
+            CloseHandle(m_file);
+        }
+#else
+        if (m_data) {
+            munmap(const_cast<uint8_t*>(m_data), m_size);
+        }
+#endif
+    }
+
+    const uint8_t* data() const { return m_data; }
+    size_t size() const { return m_size; }
+
+private:
+    MappedFile() = default;
+
+    const uint8_t* m_data = nullptr;
+    size_t m_size = 0;
+#ifdef _WIN32
+    HANDLE m_file = INVALID_HANDLE_VALUE;
+    HANDLE m_mapping = nullptr;
+#endif
+};
+
+bool CompiledDictionary::isValidCondition(std::string_view text) {
+    std::vector<ConditionElement> condition;
+    return parseCondition(text, condition);
+}
+
+bool CompiledDictionary::parseCondition(std::string_view text, std::vector<ConditionElement>& condition) {
+    condition.clear();
+    if (text == ".") {
+        return true;
+    }
+
+    std::vector<char32_t> codePoints = decodeCodePoints(text);
+    for (size_t i = 0; i < codePoints.size(); ++i) {
+        ConditionElement element;
+        if (codePoints[i] == '.') {
+            element.any = true;
+        } else if (codePoints[i] == '[') {
+            size_t j = i + 1;
+            if (j < codePoints.size() && codePoints[j] == '^') {
+                element.negated = true;
+                ++j;
+            }
+            while (j < codePoints.size() && codePoints[j] != ']') {
+                element.characters.push_back(codePoints[j++]);
+            }
+            if (j == codePoints.size()) {
+                return false;
+            }
+            i = j;
+        } else if (codePoints[i] == ']') {
+            return false;
+        } else {
+            element.characters.push_back(codePoints[i]);
+        }
+        condition.push_back(std::move(element));
+    }
+    return true;
+}
+
+CompiledDictionary::CompiledDictionary() = default;
+
+CompiledDictionary::~CompiledDictionary() = default;
+
+std::shared_ptr<const CompiledDictionary> CompiledDictionary::open(const std::string& path) {
+    return open(path, std::string(), std::string());
+}
+
+std::shared_ptr<const CompiledDictionary> CompiledDictionary::open(const std::string& path, const std::string& affPath,
+                                                                   const std::string& dicPath) {
+    auto file = MappedFile::open(path);
+    if (!file || file->size() < sizeof(ImageHeader)) {
+        return nullptr;
+    }
+
+    // Validate the header and that every section lies inside the file
+    ImageHeader header;
+    std::memcpy(&header, file->data(), sizeof(header));
+    if (std::memcmp(header.magic, COMPILED_DICTIONARY_MAGIC, sizeof(header.magic)) != 0 ||
+        header.version != COMPILED_DICTIONARY_VERSION) {
+        return nullptr;
+    }
+
+    // An image compiled from other versions of the sources is stale; the
+    // caller then uses Hunspell until the image is compiled again
+    if (!affPath.empty() && (!sameStamp(header.affSource, stampSource(affPath)) ||
+                             !sameStamp(header.dicSource, stampSource(dicPath)))) {
+        return nullptr;
+    }
+    auto fits = [&](uint64_t offset, uint64_t bytes) {
+        return offset <= file->size() && bytes <= file->size() - offset;
+    };
+    if (!fits(header.blockIndexOffset, uint64_t(header.blockCount) * sizeof(uint32_t)) ||
+        !fits(header.blockDataOffset, header.blockDataSize) ||
+        !fits(header.flagPoolOffset, header.flagPoolSize * sizeof(uint16_t)) ||
+        !fits(header.affixOffset, uint64_t(header.affixCount) * sizeof(AffixRecord)) ||
+        !fits(header.conversionOffset, uint64_t(header.inputConversionCount) * sizeof(StringRef)) ||
+        !fits(header.stringPoolOffset, header.stringPoolSize)) {
+        return nullptr;
+    }
+
+    auto dictionary = std::shared_ptr<CompiledDictionary>(new CompiledDictionary());
+    const uint8_t* base = file->data();
+    dictionary->m_wordCount = header.wordCount;
+    dictionary->m_blockCount = header.blockCount;
+    dictionary->m_blockIndex = reinterpret_cast<const uint32_t*>(base + header.blockIndexOffset);
+    dictionary->m_blockData = base + header.blockDataOffset;
+    dictionary->m_flagPool = reinterpret_cast<const uint16_t*>(base + header.flagPoolOffset);
+    dictionary->m_knownWordsOnly = (header.flags & IMAGE_KNOWN_WORDS_ONLY) != 0;
+
+    if (header.knownWordCount > 0) {
+        if (header.knownBucketCount == 0 ||
+            !fits(header.knownDisplacementOffset, uint64_t(header.knownBucketCount) * sizeof(uint32_t)) ||
+            !fits(header.knownSlotOffset, uint64_t(header.knownWordCount) * sizeof(uint32_t)) ||
+            !fits(header.knownKeyPoolOffset, header.knownKeyPoolSize)) {
+            return nullptr;
+        }
+        dictionary->m_knownSeed = header.knownSeed;
+        dictionary->m_knownWordCount = header.knownWordCount;
+        dictionary->m_knownBucketCount = header.knownBucketCount;
+        dictionary->m_knownDisplacements = reinterpret_cast<const uint32_t*>(base + header.knownDisplacementOffset);
+        dictionary->m_knownSlots = reinterpret_cast<const uint32_t*>(base + header.knownSlotOffset);
+        dictionary->m_knownKeys = base + header.knownKeyPoolOffset;
+    }
+
+    const char* strings = reinterpret_cast<const char*>(base + header.stringPoolOffset);
+    auto view = [&](const StringRef& ref) -> std::string_view {
+        if (uint64_t(ref.offset) + ref.length > header.stringPoolSize) {
+            return {};
+        }
+        return std::string_view(strings + ref.offset, ref.length);
+    };
+
+    // The affix tables are small, so they are unpacked into lookup structures
+    // keyed by the affix text that a word has to start or end with
+    const AffixRecord* records = reinterpret_cast<const AffixRecord*>(base + header.affixOffset);
+    for (uint32_t i = 0; i < header.affixCount; ++i) {
+        AffixRule rule;
+        rule.flag = records[i].flag;
+        rule.crossProduct = records[i].crossProduct != 0;
+        rule.strip = view(records[i].strip);
+        rule.append = view(records[i].append);
+        if (!parseCondition(view(records[i].condition), rule.condition)) {
+            return nullptr;
+        }
+
+        auto& rules = records[i].isPrefix ? dictionary->m_prefixes : dictionary->m_suffixes;
+        auto& byAppend = records[i].isPrefix ? dictionary->m_prefixesByAppend : dictionary->m_suffixesByAppend;
+        auto& maxLength = records[i].isPrefix ? dictionary->m_maxPrefixLength : dictionary->m_maxSuffixLength;
+        byAppend[rule.append].push_back(rules.size());
+        maxLength = std::max(maxLength, rule.append.size());
+        rules.push_back(std::move(rule));
+    }
+
+    const StringRef* conversions = reinterpret_cast<const StringRef*>(base + header.conversionOffset);
+    for (uint32_t i = 0; i < header.inputConversionCount; ++i) {
+        dictionary->m_inputConversions.push_back(view(conversions[i]));
+    }
+
+    dictionary->m_file = std::move(file);
+    return dictionary;
+}
+
+CompiledDictionary::Verdict CompiledDictionary::check(std::string_view word) const {
+    if (word.empty() || word.size() > MAX_COMPILED_WORD_LENGTH) {
+        return Verdict::Unknown;
+    }
+
+    // Frequent surface forms were verified by Hunspell when the image was
+    // built, so one hash probe settles most words of a real document
+    if (isKnownWord(word)) {
+        return Verdict::Correct;
+    }
+    if (m_knownWordsOnly) {
+        return Verdict::Unknown;
+    }
+
+    // Hunspell rewrites words containing ICONV patterns before checking them
+    for (std::string_view pattern : m_inputConversions) {
+        if (word.find(pattern) != std::string_view::npos) {
+            return Verdict::Unknown;
+        }
+    }
+
+    if (isKnownForm(word)) {
+        return Verdict::Correct;
+    }
+
+    // A miss is only final for plain ASCII words, where the case variants
+    // Hunspell tries can be reproduced exactly. Numbers, hyphenated words,
+    // apostrophes and non-ASCII case mapping are left to Hunspell.
+    size_t upperCount = 0;
+    for (char c : word) {
+        if (!isAsciiLetter(c)) {
+            return Verdict::Unknown;
+        }
+        upperCount += isAsciiUpper(c) ? 1 : 0;
+    }
+    bool firstUpper = isAsciiUpper(word[0]);
+
+    std::string variant(word);
+    if (upperCount == 1 && firstUpper) {
+        // Capitalized: also accept the all-lowercase dictionary form
+        variant[0] = static_cast<char>(variant[0] - 'A' + 'a');
+        return isKnownForm(variant) ? Verdict::Correct : Verdict::Misspelled;
+    }
+    if (upperCount == word.size()) {
+        // All capitals: accept the capitalized or the all-lowercase form
+        for (size_t i = 1; i < variant.size(); ++i) {
+            variant[i] = static_cast<char>(variant[i] - 'A' + 'a');
+        }
+        if (isKnownForm(variant)) {
+            return Verdict::Correct;
+        }
+        variant[0] = static_cast<char>(variant[0] - 'A' + 'a');
+        return isKnownForm(variant) ? Verdict::Correct : Verdict::Misspelled;
+    }
+    return Verdict::Misspelled;
+}
+
+size_t CompiledDictionary::wordCount() const {
+    return m_wordCount;
+}
+
+size_t CompiledDictionary::imageBytes() const {
+    return m_file ? m_file->size() : 0;
+}
+
+size_t CompiledDictionary::knownWordCount() const {
+    return m_knownWordCount;
+}
+
+bool CompiledDictionary::isKnownWord(std::string_view word) const {
+    if (m_knownWordCount == 0) {
+        return false;
+    }
+
+    // Minimal perfect hash: every stored word has its own slot, and the key
+    // stored there is compared so words outside the set are never accepted
+    KnownWordHash hash = hashKnownWord(word, m_knownSeed, m_knownBucketCount, m_knownWordCount);
+    uint64_t slot = knownWordSlot(hash, m_knownDisplacements[hash.bucket], m_knownWordCount);
+    const uint8_t* key = m_knownKeys + m_knownSlots[slot];
+    return key[0] == word.size() && std::memcmp(key + 1, word.data(), word.size()) == 0;
+}
+
+bool CompiledDictionary::isKnownForm(std::string_view word) const {
+    // A dictionary stem on its own
+    if (findStem(word, 0, 0)) {
+        return true;
+    }
+    return checkSuffixes(word, 0) || checkPrefixes(word);
+}
+
+bool CompiledDictionary::checkSuffixes(std::string_view word, uint16_t prefixFlag) const {
+    std::string stem;
+    for (size_t length = 0; length <= std::min(m_maxSuffixLength, word.size() - 1); ++length) {
+        auto rules = m_suffixesByAppend.find(word.substr(word.size() - length));
+        if (rules == m_suffixesByAppend.end()) {
+            continue;
+        }
+
+        for (size_t index : rules->second) {
+            const AffixRule& rule = m_suffixes[index];
+            if (prefixFlag != 0 && !rule.crossProduct) {
+                continue;
+            }
+
+            // Undo the suffix: drop the appended text and restore the stripped one
+            stem.assign(word.substr(0, word.size() - length));
+            stem.append(rule.strip);
+            if (matchesCondition(rule.condition, stem, true) && findStem(stem, rule.flag, prefixFlag)) {
+                return true;
+            }
+        }
+    }
+    return false;
+}
+
+bool CompiledDictionary::checkPrefixes(std::string_view word) const {
+    std::string stem;
+    for (size_t length = 0; length <= std::min(m_maxPrefixLength, word.size() - 1); ++length) {
+        auto rules = m_prefixesByAppend.find(word.substr(0, length));
+        if (rules == m_prefixesByAppend.end()) {
+            continue;
+        }
+
+        for (size_t index : rules->second) {
+            const AffixRule& rule = m_prefixes[index];
+            stem.assign(rule.strip);
+            stem.append(word.substr(length));
+            if (!matchesCondition(rule.condition, stem, false)) {
+                continue;
+            }
+            if (findStem(stem, rule.flag, 0)) {
+                return true;
+            }
+
+            // Prefix and suffix together, when both rules allow combining
+            if (rule.crossProduct && checkSuffixes(stem, rule.flag)) {
+                return true;
+            }
+        }
+    }
+    return false;
+}
+
+bool CompiledDictionary::matchesCondition(const std::vector<ConditionElement>& condition, std::string_view stem,
+                                          bool atEnd) const {
+    if (condition.empty()) {
+        return true;
+    }
+
+    // Conditions apply to the end of the stem for suffixes and its start for prefixes
+    std::vector<char32_t> codePoints = decodeCodePoints(stem);
+    if (codePoints.size() < condition.size()) {
+        return false;
+    }
+    size_t start = atEnd ? codePoints.size() - condition.size() : 0;
+    for (size_t i = 0; i < condition.size(); ++i) {
+        if (!condition[i].matches(codePoints[start + i])) {
+            return false;
+        }
+    }
+    return true;
+}
+
+bool CompiledDictionary::hasFlag(uint32_t flagSet, uint16_t flag) const {
+    const uint16_t* flags = m_flagPool + flagSet + 1;
+    return std::binary_search(flags, flags + m_flagPool[flagSet], flag);
+}
+
+bool CompiledDictionary::findStem(std::string_view word, uint16_t flag, uint16_t secondFlag) const {
+    if (m_blockCount == 0) {
+        return false;
+    }
+
+    // Find the first block whose head is not less than the word. Homonyms may
+    // start in the block before it, so scanning begins one block earlier.
+    auto blockHead = [&](uint32_t block) {
+        const uint8_t* p = m_blockData + m_blockIndex[block];
+        readVarint(p);
+        uint32_t length = readVarint(p);
+        return std::string_view(reinterpret_cast<const char*>(p), length);
+    };
+    uint32_t low = 0;
+    uint32_t high = m_blockCount;
+    while (low < high) {
+        uint32_t middle = (low + high) / 2;
+        if (blockHead(middle) < word) {
+            low = middle + 1;
+        } else {
+            high = middle;
+        }
+    }
+    uint32_t block = low > 0 ? low - 1 : 0;
+
+    // Decode front-coded entries until they sort after the word
+    std::string current;
+    for (; block < m_blockCount; ++block) {
+        const uint8_t* p = m_blockData + m_blockIndex[block];
+        uint32_t entries = std::min<uint32_t>(STEM_BLOCK_SIZE, static_cast<uint32_t>(m_wordCount - size_t(block) * STEM_BLOCK_SIZE));
+        for (uint32_t i = 0; i < entries; ++i) {
+            uint32_t shared = readVarint(p);
+            uint32_t length = readVarint(p);
+            current.resize(shared);
+            current.append(reinterpret_cast<const char*>(p), length);
+            p += length;
+            uint32_t flagSet = readVarint(p);
+
+            int order = std::string_view(current).compare(word);
+            if (order > 0) {
+                return false;
+            }
+            if (order == 0 && (flag == 0 || hasFlag(flagSet, flag)) && (secondFlag == 0 || hasFlag(flagSet, secondFlag))) {
+                return true;
+            }
+        }
+    }
+    return false;
+}
+
+namespace {
+
+enum class FlagMode { Char, Long, Number, Utf8 };
+
+// Helper function to split a flag string into numeric flags
+bool parseFlags(std::string_view text, FlagMode mode, std::vector<uint16_t>& flags) {
+    flags.clear();
+    if (mode == FlagMode::Char) {
+        for (unsigned char c : text) {
+            flags.push_back(c);
+        }
+    } else if (mode == FlagMode::Long) {
+        if (text.size() % 2 != 0) {
+            return false;
+        }
+        for (size_t i = 0; i < text.size(); i += 2) {
+            flags.push_back(static_cast<uint16_t>((static_cast<unsigned char>(text[i]) << 8) |
+                                                  static_cast<unsigned char>(text[i + 1])));
+        }
+    } else if (mode == FlagMode::Number) {
+        std::stringstream stream{std::string(text)};
+        std::string number;
+        while (std::getline(stream, number, ',')) {
+            if (number.empty() || number.find_first_not_of("0123456789") != std::string::npos ||
+                number.size() > 5 || std::stoul(number) > 65535) {
+                return false;
+            }
+            flags.push_back(static_cast<uint16_t>(std::stoul(number)));
+        }
+    } else {
+        for (char32_t c : decodeCodePoints(text)) {
+            if (c > 0xFFFF) {
+                return false;
+            }
+            flags.push_back(static_cast<uint16_t>(c));
+        }
+    }
+    std::sort(flags.begin(), flags.end());
+    flags.erase(std::unique(flags.begin(), flags.end()), flags.end());
+    return true;
+}
+
+// Helper function to collect the flags named in a COMPOUNDRULE pattern
+bool parseCompoundRuleFlags(std::string_view rule, FlagMode mode, std::vector<uint16_t>& flags) {
+    std::vector<uint16_t> parsed;
+    if (mode == FlagMode::Long || mode == FlagMode::Number) {
+        // Multi-character flags are written in parentheses: (aa)*(bb)?
+        size_t pos = 0;
+        while ((pos = rule.find('(', pos)) != std::string_view::npos) {
+            size_t end = rule.find(')', pos);
+            if (end == std::string_view::npos || !parseFlags(rule.substr(pos + 1, end - pos - 1), mode, parsed)) {
+                return false;
+            }
+            flags.insert(flags.end(), parsed.begin(), parsed.end());
+            pos = end + 1;
+        }
+        return true;
+    }
+    std::string plain;
+    for (char c : rule) {
+        if (c != '*' && c != '?' && c != '(' && c != ')') {
+            plain.push_back(c);
+        }
+    }
+    if (!parseFlags(plain, mode, parsed)) {
+        return false;
+    }
+    flags.insert(flags.end(), parsed.begin(), parsed.end());
+    return true;
+}
+
+std::vector<std::string> splitFields(const std::string& line) {
+    std::vector<std::string> fields;
+    std::istringstream stream(line);
+    std::string field;
+    while (stream >> field) {
+        fields.push_back(field);
+    }
+    return fields;
+}
+
+struct ParsedAffix {
+    uint16_t flag;
+    bool isPrefix;
+    bool crossProduct;
+    std::string strip;
+    std::string append;
+    std::string condition;
+};
+
+struct ParsedEntry {
+    std::string word;
+    std::vector<uint16_t> flags;
+};
+
+struct ImageSections {
+    uint32_t wordCount = 0;
+    std::vector<uint32_t> blockIndex;
+    std::string blockData;
+    std::vector<uint16_t> flagPool = {0};
+    std::vector<AffixRecord> records;
+    std::vector<StringRef> conversions;
+    std::string stringPool;
+};
+
+struct KnownWordSections {
+    uint64_t seed = 0;
+    uint32_t bucketCount = 0;
+    std::vector<uint32_t> displacements;
+    std::vector<uint32_t> slots;
+    std::string keyPool;
+};
+
+// Helper function to append a string to the pool and return its reference
+StringRef addString(std::string& pool, const std::string& value) {
+    StringRef ref{static_cast<uint32_t>(pool.size()), static_cast<uint32_t>(value.size())};
+    pool += value;
+    return ref;
+}
+
+void alignTo8(std::string& image) {
+    while (image.size() % 8 != 0) {
+        image.push_back('\0');
+    }
+}
+
+// Parses the Hunspell files and encodes the stem and affix sections of the image
+DictionaryCompileResult encodeDictionary(const std::string& affPath, const std::string& dicPath,
+                                         ImageSections& sections, std::string& message) {
+    std::ifstream aff(affPath, std::ios::binary);
+    std::ifstream dic(dicPath, std::ios::binary);
+    if (!aff || !dic) {
+        message = "Failed to open " + (!aff ? affPath : dicPath);
+        return DictionaryCompileResult::Failed;
+    }
+
+    // Directives that change how words are matched in ways the compiled
+    // format does not model; the language keeps using Hunspell
+    static const std::set<std::string> UNSUPPORTED_DIRECTIVES = {
+        "IGNORE", "FULLSTRIP", "COMPLEXPREFIXES", "AF", "CHECKSHARPS"
+    };
+    // Flags that may be declared as long as no dictionary entry uses them
+    static const std::set<std::string> UNSUPPORTED_FLAG_DIRECTIVES = {
+        "NEEDAFFIX", "PSEUDOROOT", "FORBIDDENWORD", "KEEPCASE", "CIRCUMFIX", "FORCEUCASE", "SUBSTANDARD"
+    };
+    // Compounding is only accepted when every compounding entry contains a
+    // digit, as in the ordinal rules of English dictionaries; such words are
+    // never given a final verdict by the compiled dictionary
+    static const std::set<std::string> COMPOUND_FLAG_DIRECTIVES = {
+        "COMPOUNDFLAG", "COMPOUNDBEGIN", "COMPOUNDMIDDLE", "COMPOUNDEND", "COMPOUNDLAST", "ONLYINCOMPOUND"
+    };
+
+    FlagMode flagMode = FlagMode::Char;
+    bool utf8 = false;
+    bool sawNonAscii = false;
+    std::vector<std::string> flagDirectiveValues[3]; // unsupported, compound, only-in-compound
+    std::vector<std::string> compoundRules;
+    std::vector<std::string> inputConversions;
+    std::vector<ParsedAffix> affixes;
+    std::map<std::string, bool> crossProductByClass;
+
+    std::string line;
+    while (std::getline(aff, line)) {
+        if (!line.empty() && line.back() == '\r') {
+            line.pop_back();
+        }
+        sawNonAscii = sawNonAscii || std::any_of(line.begin(), line.end(), [](char c) { return static_cast<unsigned char>(c) >= 0x80; });
+        auto fields = splitFields(line);
+        if (fields.empty() || fields[0][0] == '#') {
+            continue;
+        }
+        const std::string& directive = fields[0];
+
+        if (UNSUPPORTED_DIRECTIVES.count(directive)) {
+            message = "Unsupported affix directive " + directive;
+            return DictionaryCompileResult::Unsupported;
+        }
+        if (directive == "SET" && fields.size() > 1) {
+            utf8 = fields[1] == "UTF-8";
+        } else if (directive == "FLAG" && fields.size() > 1) {
+            flagMode = fields[1] == "long" ? FlagMode::Long : fields[1] == "num" ? FlagMode::Number
+                     : fields[1] == "UTF-8" ? FlagMode::Utf8 : FlagMode::Char;
+        } else if (directive == "LANG" && fields.size() > 1) {
+            // Turkic case mapping of i and I differs from the ASCII rules used at runtime
+            if (fields[1].rfind("tr", 0) == 0 || fields[1].rfind("az", 0) == 0 || fields[1].rfind("crh", 0) == 0) {
+                message = "Unsupported language-specific casing for " + fields[1];
+                return DictionaryCompileResult::Unsupported;
+            }
+        } else if (UNSUPPORTED_FLAG_DIRECTIVES.count(directive) && fields.size() > 1) {
+            flagDirectiveValues[0].push_back(fields[1]);
+        } else if (directive == "ONLYINCOMPOUND" && fields.size() > 1) {
+            flagDirectiveValues[2].push_back(fields[1]);
+        } else if (COMPOUND_FLAG_DIRECTIVES.count(directive) && fields.size() > 1) {
+            flagDirectiveValues[1].push_back(fields[1]);
+        } else if (directive == "COMPOUNDRULE" && fields.size() > 1) {
+            // The first COMPOUNDRULE line holds the rule count
+            if (fields[1].find_first_not_of("0123456789") != std::string::npos) {
+                compoundRules.push_back(fields[1]);
+            }
+        } else if (directive == "ICONV" && fields.size() > 2) {
+            inputConversions.push_back(fields[1]);
+        } else if (directive == "BREAK" && fields.size() > 1) {
+            bool numericCount = fields[1].find_first_not_of("0123456789") == std::string::npos;
+            if (!numericCount && std::any_of(fields[1].begin(), fields[1].end(), [](char c) {
+                    return std::isalnum(static_cast<unsigned char>(c)) != 0; })) {
+                message = "Unsupported BREAK pattern " + fields[1];
+                return DictionaryCompileResult::Unsupported;
+            }
+        } else if ((directive == "PFX" || directive == "SFX") && fields.size() >= 4) {
+            // Header lines are "SFX <flag> <Y|N> <count>"; rule lines have the strip
+            // text in the third field instead of Y or N
+            std::string classKey = directive + " " + fields[1];
+            bool isHeader = (fields[2] == "Y" || fields[2] == "N") && !crossProductByClass.count(classKey) &&
+                            fields[3].find_first_not_of("0123456789") == std::string::npos;
+            if (isHeader) {
+                crossProductByClass[classKey] = fields[2] == "Y";
+                continue;
+            }
+
+            std::vector<uint16_t> flag;
+            if (!parseFlags(fields[1], flagMode, flag) || flag.size() != 1) {
+                message = "Malformed affix flag in: " + line;
+                return DictionaryCompileResult::Failed;
+            }
+            if (fields[3].find('/') != std::string::npos) {
+                message = "Unsupported two-level affix in: " + line;
+                return DictionaryCompileResult::Unsupported;
+            }
+
+            ParsedAffix affix;
+            affix.flag = flag[0];
+            affix.isPrefix = directive == "PFX";
+            affix.crossProduct = crossProductByClass[classKey];
+            affix.strip = fields[2] == "0" ? "" : fields[2];
+            affix.append = fields[3] == "0" ? "" : fields[3];
+            affix.condition = fields.size() > 4 ? fields[4] : ".";
+            affixes.push_back(std::move(affix));
+        }
+    }
+
+    // Resolve the flag directives now that the flag mode is known
+    std::vector<uint16_t> flagSets[3];
+    for (int kind = 0; kind < 3; ++kind) {
+        for (const auto& value : flagDirectiveValues[kind]) {
+            std::vector<uint16_t> parsed;
+            if (!parseFlags(value, flagMode, parsed)) {
+                message = "Malformed flag " + value;
+                return DictionaryCompileResult::Failed;
+            }
+            flagSets[kind].insert(flagSets[kind].end(), parsed.begin(), parsed.end());
+        }
+    }
+    for (const auto& rule : compoundRules) {
+        if (!parseCompoundRuleFlags(rule, flagMode, flagSets[1])) {
+            message = "Malformed COMPOUNDRULE " + rule;
+            return DictionaryCompileResult::Failed;
+        }
+    }
+    auto hasAny = [](const std::vector<uint16_t>& flags, const std::vector<uint16_t>& set) {
+        return std::any_of(flags.begin(), flags.end(), [&](uint16_t f) {
+            return std::find(set.begin(), set.end(), f) != set.end(); });
+    };
+
+    // Read the dictionary entries: "word[/flags][<tab or space>morphology]"
+    std::vector<ParsedEntry> entries;
+    bool firstLine = true;
+    while (std::getline(dic, line)) {
+        if (!line.empty() && line.back() == '\r') {
+            line.pop_back();
+        }
+        if (firstLine) {
+            firstLine = false;
+            if (line.find_first_not_of("0123456789 \t") == std::string::npos) {
+                continue;
+            }
+        }
+        if (line.empty() || line[0] == '\t') {
+            continue;
+        }
+        sawNonAscii = sawNonAscii || std::any_of(line.begin(), line.end(), [](char c) { return static_cast<unsigned char>(c) >= 0x80; });
+
+        size_t fieldEnd = line.find('\t');
+        if (fieldEnd == std::string::npos) {
+            // Morphological fields may also follow a space, as "xx:" fields or an alias number
+            size_t space = line.find(' ');
+            while (space != std::string::npos) {
+                std::string_view rest = std::string_view(line).substr(space + 1);
+                bool morphology = (rest.size() >= 3 && rest[2] == ':') ||
+                                  (!rest.empty() && rest.find_first_not_of("0123456789") == std::string_view::npos);
+                if (morphology) {
+                    fieldEnd = space;
+                    break;
+                }
+                space = line.find(' ', space + 1);
+            }
+        }
+        std::string field = line.substr(0, fieldEnd);
+
+        ParsedEntry entry;
+        size_t slash = std::string::npos;
+        for (size_t i = 0; i < field.size(); ++i) {
+            if (field[i] == '\\' && i + 1 < field.size() && field[i + 1] == '/') {
+                entry.word.push_back('/');
+                ++i;
+            } else if (field[i] == '/' && i > 0) {
+                slash = i;
+                break;
+            } else {
+                entry.word.push_back(field[i]);
+            }
+        }
+        if (slash != std::string::npos && !parseFlags(std::string_view(field).substr(slash + 1), flagMode, entry.flags)) {
+            message = "Malformed flags in: " + line;
+            return DictionaryCompileResult::Failed;
+        }
+        if (entry.word.empty() || entry.word.size() > MAX_COMPILED_WORD_LENGTH) {
+            continue;
+        }
+
+        if (hasAny(entry.flags, flagSets[0])) {
+            message = "Unsupported entry flag on " + entry.word;
+            return DictionaryCompileResult::Unsupported;
+        }
+        if (hasAny(entry.flags, flagSets[1]) || hasAny(entry.flags, flagSets[2])) {
+            if (entry.word.find_first_of("0123456789") == std::string::npos) {
+                message = "Unsupported compounding on " + entry.word;
+                return DictionaryCompileResult::Unsupported;
+            }
+            if (hasAny(entry.flags, flagSets[2])) {
+                continue;
+            }
+        }
+        entries.push_back(std::move(entry));
+    }
+
+    if (sawNonAscii && !utf8) {
+        message = "Only UTF-8 or ASCII dictionaries can be compiled";
+        return DictionaryCompileResult::Unsupported;
+    }
+
+    for (const auto& affix : affixes) {
+        if (!CompiledDictionary::isValidCondition(affix.condition)) {
+            message = "Malformed affix condition " + affix.condition;
+            return DictionaryCompileResult::Failed;
+        }
+    }
+
+    // Sort stems so lookups can binary-search the block heads; identical
+    // entries collapse, homonyms with different flags are kept apart
+    std::sort(entries.begin(), entries.end(), [](const ParsedEntry& a, const ParsedEntry& b) {
+        return a.word != b.word ? a.word < b.word : a.flags < b.flags;
+    });
+    entries.erase(std::unique(entries.begin(), entries.end(), [](const ParsedEntry& a, const ParsedEntry& b) {
+        return a.word == b.word && a.flags == b.flags;
+    }), entries.end());
+
+    // Deduplicate the flag sets; offset zero is the empty set
+    std::vector<uint16_t> flagPool = {0};
+    std::map<std::vector<uint16_t>, uint32_t> flagSetOffsets = {{{}, 0}};
+    std::vector<uint32_t> entryFlagSets;
+    for (const auto& entry : entries) {
+        auto inserted = flagSetOffsets.emplace(entry.flags, static_cast<uint32_t>(flagPool.size()));
+        if (inserted.second) {
+            flagPool.push_back(static_cast<uint16_t>(entry.flags.size()));
+            flagPool.insert(flagPool.end(), entry.flags.begin(), entry.flags.end());
+        }
+        entryFlagSets.push_back(inserted.first->second);
+    }
+
+    // Front-code the stems in blocks; the first entry of each block is stored whole
+    std::vector<uint32_t> blockIndex;
+    std::string blockData;
+    for (size_t i = 0; i < entries.size(); ++i) {
+        size_t shared = 0;
+        if (i % STEM_BLOCK_SIZE == 0) {
+            blockIndex.push_back(static_cast<uint32_t>(blockData.size()));
+        } else {
+            const std::string& previous = entries[i - 1].word;
+            const std::string& word = entries[i].word;
+            while (shared < previous.size() && shared < word.size() && previous[shared] == word[shared]) {
+                ++shared;
+            }
+        }
+        writeVarint(blockData, static_cast<uint32_t>(shared));
+        writeVarint(blockData, static_cast<uint32_t>(entries[i].word.size() - shared));
+        blockData.append(entries[i].word, shared, std::string::npos);
+        writeVarint(blockData, entryFlagSets[i]);
+    }
+
+    std::string stringPool;
+    std::vector<AffixRecord> records;
+    for (const auto& affix : affixes) {
+        AffixRecord record;
+        record.flag = affix.flag;
+        record.isPrefix = affix.isPrefix ? 1 : 0;
+        record.crossProduct = affix.crossProduct ? 1 : 0;
+        record.strip = addString(stringPool, affix.strip);
+        record.append = addString(stringPool, affix.append);
+        record.condition = addString(stringPool, affix.condition);
+        records.push_back(record);
+    }
+    std::vector<StringRef> conversions;
+    for (const auto& pattern : inputConversions) {
+        conversions.push_back(addString(stringPool, pattern));
+    }
+
+    sections.wordCount = static_cast<uint32_t>(entries.size());
+    sections.blockIndex = std::move(blockIndex);
+    sections.blockData = std::move(blockData);
+    sections.flagPool = std::move(flagPool);
+    sections.records = std::move(records);
+    sections.conversions = std::move(conversions);
+    sections.stringPool = std::move(stringPool);
+    return DictionaryCompileResult::Compiled;
+}
+
+// Builds a minimal perfect hash over the words with compress-hash-displace:
+// words are hashed into buckets, and the buckets, largest first, each search
+// for a displacement that puts all their words in free slots
+bool buildKnownWords(const std::vector<std::string>& words, KnownWordSections& known) {
+    if (words.empty()) {
+        return true;
+    }
+    uint64_t slotCount = words.size();
+    uint64_t bucketCount = std::max<uint64_t>(1, slotCount / KNOWN_WORDS_PER_BUCKET);
+
+    for (uint64_t seed = 1; seed <= MAX_KNOWN_WORD_SEEDS; ++seed) {
+        std::vector<KnownWordHash> hashes;
+        std::vector<std::vector<uint32_t>> buckets(bucketCount);
+        for (uint32_t i = 0; i < words.size(); ++i) {
+            hashes.push_back(hashKnownWord(words[i], seed, bucketCount, slotCount));
+            buckets[hashes.back().bucket].push_back(i);
+        }
+        std::vector<uint32_t> order(bucketCount);
+        for (uint32_t i = 0; i < bucketCount; ++i) {
+            order[i] = i;
+        }
+        std::stable_sort(order.begin(), order.end(), [&](uint32_t a, uint32_t b) {
+            return buckets[a].size() > buckets[b].size();
+        });
+
+        std::vector<uint32_t> displacements(bucketCount, 0);
+        std::vector<int64_t> slotWord(slotCount, -1);
+        std::vector<uint64_t> positions;
+        uint64_t maxDisplacement = std::min<uint64_t>(UINT32_MAX, slotCount * 64);
+        bool placedAll = true;
+
+        for (uint32_t bucket : order) {
+            if (buckets[bucket].empty()) {
+                break;
+            }
+            bool placed = false;
+            for (uint64_t displacement = 0; displacement < maxDisplacement && !placed; ++displacement) {
+                positions.clear();
+                placed = true;
+                for (uint32_t word : buckets[bucket]) {
+                    uint64_t slot = knownWordSlot(hashes[word], displacement, slotCount);
+                    if (slotWord[slot] >= 0 || std::find(positions.begin(), positions.end(), slot) != positions.end()) {
+                        placed = false;
+                        break;
+                    }
+                    positions.push_back(slot);
+                }
+                if (placed) {
+                    displacements[bucket] = static_cast<uint32_t>(displacement);
+                    for (size_t i = 0; i < positions.size(); ++i) {
+                        slotWord[positions[i]] = buckets[bucket][i];
+                    }
+                }
+            }
+            if (!placed) {
+                placedAll = false;
+                break;
+            }
+        }
+        if (!placedAll) {
+            continue;
+        }
+
+        // Store each word's key so lookups can reject words outside the set
+        known.seed = seed;
+        known.bucketCount = static_cast<uint32_t>(bucketCount);
+        known.displacements = std::move(displacements);
+        known.slots.assign(slotCount, 0);
+        for (uint64_t slot = 0; slot < slotCount; ++slot) {
+            const std::string& word = words[slotWord[slot]];
+            known.slots[slot] = static_cast<uint32_t>(known.keyPool.size());
+            known.keyPool.push_back(static_cast<char>(word.size()));
+            known.keyPool += word;
+        }
+        return true;
+    }
+    return false;
+}
+
+// Reads a frequency list, most frequent first or as "word count" lines, and
+// keeps the most frequent words the reference checker accepts
+bool readKnownWords(const DictionaryCompileOptions& options, std::vector<std::string>& words, std::string& message) {
+    std::ifstream list(options.frequencyListPath, std::ios::binary);
+    if (!list) {
+        message = "Failed to open " + options.frequencyListPath;
+        return false;
+    }
+    if (!options.isCorrect) {
+        message = "A frequency list needs a reference spell checker to filter it";
+        return false;
+    }
+
+    std::vector<std::pair<uint64_t, std::string>> candidates;
+    std::string line;
+    while (std::getline(list, line)) {
+        auto fields = splitFields(line);
+        if (fields.empty() || fields[0].size() > MAX_COMPILED_WORD_LENGTH) {
+            continue;
+        }
+        uint64_t count = 0;
+        if (fields.size() > 1 && fields[1].find_first_not_of("0123456789") == std::string::npos && fields[1].size() < 20) {
+            count = std::stoull(fields[1]);
+        }
+        candidates.emplace_back(count, fields[0]);
+    }
+    std::stable_sort(candidates.begin(), candidates.end(), [](const auto& a, const auto& b) { return a.first > b.first; });
+
+    std::set<std::string> seen;
+    for (const auto& candidate : candidates) {
+        if (words.size() >= options.knownWordLimit) {
+            break;
+        }
+        if (seen.insert(candidate.second).second && options.isCorrect(candidate.second)) {
+            words.push_back(candidate.second);
+        }
+    }
+    return true;
+}
+
+// Helper function to move a freshly written image over the previous one
+bool replaceImage(const std::string& temporaryPath, const std::string& outputPath) {
+    std::error_code error;
+#ifdef _WIN32
+    // Windows refuses to replace or delete an image a process has mapped, but
+    // lets it be renamed. A mapped image is moved aside to a numbered name its
+    // processes keep using, and deleted by a later compile once unmapped.
+    for (int retired = 1; retired <= MAX_RETIRED_IMAGES; ++retired) {
+        std::filesystem::remove(outputPath + ".old" + std::to_string(retired), error);
+    }
+    std::filesystem::rename(temporaryPath, outputPath, error);
+    for (int retired = 1; error && retired <= MAX_RETIRED_IMAGES; ++retired) {
+        std::string retiredPath = outputPath + ".old" + std::to_string(retired);
+        std::error_code moved;
+        if (std::filesystem::exists(retiredPath, moved)) {
+            continue;
+        }
+        std::filesystem::rename(outputPath, retiredPath, moved);
+        if (moved) {
+            break;
+        }
+        std::filesystem::rename(temporaryPath, outputPath, error);
+    }
+#else
+    // The old image's inode lives on for as long as a process maps it
+    std::filesystem::rename(temporaryPath, outputPath, error);
+#endif
+    return !error;
+}
+
+bool writeImage(const std::string& outputPath, const ImageSections& sections, const KnownWordSections& known,
+                uint32_t knownWordCount, uint32_t flags, const SourceStamp& affSource, const SourceStamp& dicSource,
+                std::string& message) {
+    // Lay out the sections after the header, each aligned for direct access
+    ImageHeader header = {};
+    std::memcpy(header.magic, COMPILED_DICTIONARY_MAGIC, sizeof(header.magic));
+    header.version = COMPILED_DICTIONARY_VERSION;
+    header.flags = flags;
+    header.wordCount = sections.wordCount;
+    header.blockCount = static_cast<uint32_t>(sections.blockIndex.size());
+    header.affixCount = static_cast<uint32_t>(sections.records.size());
+    header.inputConversionCount = static_cast<uint32_t>(sections.conversions.size());
+    header.knownSeed = known.seed;
+    header.knownWordCount = knownWordCount;
+    header.knownBucketCount = known.bucketCount;
+    header.affSource = affSource;
+    header.dicSource = dicSource;
+
+    std::string image(sizeof(ImageHeader), '\0');
+    auto appendSection = [&](const void* data, size_t bytes) {
+        alignTo8(image);
+        uint64_t offset = image.size();
+        image.append(static_cast<const char*>(data), bytes);
+        return offset;
+    };
+    header.blockIndexOffset = appendSection(sections.blockIndex.data(), sections.blockIndex.size() * sizeof(uint32_t));
+    header.blockDataOffset = appendSection(sections.blockData.data(), sections.blockData.size());
+    header.blockDataSize = sections.blockData.size();
+    header.flagPoolOffset = appendSection(sections.flagPool.data(), sections.flagPool.size() * sizeof(uint16_t));
+    header.flagPoolSize = sections.flagPool.size();
+    header.affixOffset = appendSection(sections.records.data(), sections.records.size() * sizeof(AffixRecord));
+    header.conversionOffset = appendSection(sections.conversions.data(), sections.conversions.size() * sizeof(StringRef));
+    header.stringPoolOffset = appendSection(sections.stringPool.data(), sections.stringPool.size());
+    header.stringPoolSize = sections.stringPool.size();
+    header.knownDisplacementOffset = appendSection(known.displacements.data(), known.displacements.size() * sizeof(uint32_t));
+    header.knownSlotOffset = appendSection(known.slots.data(), known.slots.size() * sizeof(uint32_t));
+    header.knownKeyPoolOffset = appendSection(known.keyPool.data(), known.keyPool.size());
+    header.knownKeyPoolSize = known.keyPool.size();
+    // Pad so varint decoding of the last block can never read past the mapping
+    image.append(8, '\0');
+    std::memcpy(&image[0], &header, sizeof(header));
+
+    // Write to a temporary file and move it into place, so processes mapping
+    // the old image keep their pages instead of faulting on a truncated file
+    std::string temporaryPath = outputPath + ".tmp";
+    {
+        std::ofstream output(temporaryPath, std::ios::binary | std::ios::trunc);
+        if (!output || !output.write(image.data(), static_cast<std::streamsize>(image.size())) || !output.flush()) {
+            message = "Failed to write " + temporaryPath;
+            return false;
+        }
+    }
+    if (!replaceImage(temporaryPath, outputPath)) {
+        std::error_code error;
+        std::filesystem::remove(temporaryPath, error);
+        message = "Failed to replace " + outputPath;
+        return false;
+    }
+    return true;
+}
+
+} // namespace
+
+DictionaryCompileResult compileDictionary(const std::string& affPath, const std::string& dicPath,
+                                          const std::string& outputPath, std::string& message) {
+    return compileDictionary(affPath, dicPath, outputPath, DictionaryCompileOptions(), message);
+}
+
+DictionaryCompileResult compileDictionary(const std::string& affPath, const std::string& dicPath,
+                                          const std::string& outputPath, const DictionaryCompileOptions& options,
+                                          std::string& message) {
+    // Stamp the sources before reading them, so an edit made while compiling
+    // leaves the image stale rather than looking current
+    SourceStamp affSource = stampSource(affPath);
+    SourceStamp dicSource = stampSource(dicPath);
+
+    ImageSections sections;
+    DictionaryCompileResult result = encodeDictionary(affPath, dicPath, sections, message);
+    if (result == DictionaryCompileResult::Failed ||
+        (result == DictionaryCompileResult::Unsupported && options.frequencyListPath.empty())) {
+        return result;
+    }
+
+    // A dictionary the stem format cannot model still gets the known-word
+    // fast path; every other word is then left to Hunspell
+    bool knownWordsOnly = result == DictionaryCompileResult::Unsupported;
+    std::string unsupportedReason = knownWordsOnly ? message : std::string();
+    if (knownWordsOnly) {
+        sections = ImageSections();
+    }
+
+    std::vector<std::string> knownWords;
+    KnownWordSections known;
+    if (!options.frequencyListPath.empty()) {
+        if (!readKnownWords(options, knownWords, message)) {
+            return DictionaryCompileResult::Failed;
+        }
+        if (!buildKnownWords(knownWords, known)) {
+            message = "Failed to build the known-word hash";
+            return DictionaryCompileResult::Failed;
+        }
+    }
+
+    if (!writeImage(outputPath, sections, known, static_cast<uint32_t>(knownWords.size()),
+                    knownWordsOnly ? IMAGE_KNOWN_WORDS_ONLY : 0, affSource, dicSource, message)) {
+        return DictionaryCompileResult::Failed;
+    }
+
+    message = std::to_string(sections.wordCount) + " stems, " + std::to_string(sections.records.size()) +
+              " affix rules, " + std::to_string(knownWords.size()) + " known words";
+    if (knownWordsOnly) {
+        message += " (stems left to Hunspell: " + unsupportedReason + ")";
+    }
+    return DictionaryCompileResult::Compiled;
+}
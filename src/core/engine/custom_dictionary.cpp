@@ -0,0 +1,328 @@
+#include <string>
+#include <string_view>
+#include <vector>
+#include <unordered_map>
+#include <unordered_set>
+#include <memory>
+#include <mutex>
+#include <shared_mutex>
+#include <fstream>
+#include <filesystem>
+#include <algorithm>
+#include "custom_dictionary.h"
+#include "word_table.h"
+
+// User words are stored once, back to back in a single arena, with a sorted
+// index of (offset, length) entries for binary search and a sorted list of
+// their interned word IDs for the tokenizer's fast path. One instance per file
+// is shared by every document of the process.
+//
+// On disk the dictionary is an append-only journal of "+word" and "-word"
+// lines, so adding a word is a single appended line. When the journal holds
+// much more history than live words it is compacted: rewritten as the sorted
+// live words. Loading replays the journal into a set and sorts the survivors
+// once, so a file loads in O(n log n) whatever its order; a file found with
+// history or out of order is rewritten sorted after loading.
+const size_t MAX_CUSTOM_WORD_LENGTH = 100;
+const size_t MIN_COMPACTION_ENTRIES = 1024; // Journals shorter than this are never compacted
+const char CUSTOM_DICTIONARY_HEADER[] = "#custom-dictionary 1";
+
+CustomDictionary::CustomDictionary() = default;
+
+CustomDictionary::CustomDictionary(const std::string& path)
+    : m_path(path) {
+    load();
+}
+
+CustomDictionary::~CustomDictionary() = default;
+
+std::shared_ptr<CustomDictionary> CustomDictionary::open(const std::string& path) {
+    // Documents opened with the same dictionary file share one instance
+    static std::mutex openMutex;
+    static std::unordered_map<std::string, std::weak_ptr<CustomDictionary>> openDictionaries;
+
+    std::lock_guard<std::mutex> lock(openMutex);
+    if (auto dictionary = openDictionaries[path].lock()) {
+        return dictionary;
+    }
+    for (auto it = openDictionaries.begin(); it != openDictionaries.end();) {
+        it = it->second.expired() && it->first != path ? openDictionaries.erase(it) : std::next(it);
+    }
+    auto dictionary = std::make_shared<CustomDictionary>(path);
+    openDictionaries[path] = dictionary;
+    return dictionary;
+}
+
+bool CustomDictionary::contains(std::string_view word) const {
+    std::shared_lock<std::shared_mutex> lock(m_mutex);
+    auto it = findEntry(word);
+    return it != m_entries.end() && entryText(*it) == word;
+}
+
+bool CustomDictionary::containsId(uint32_t wordId) const {
+    std::shared_lock<std::shared_mutex> lock(m_mutex);
+    return std::binary_search(m_wordIds.begin(), m_wordIds.end(), wordId);
+}
+
+bool CustomDictionary::addWord(const std::string& word) {
+    if (!isValidWord(word)) {
+        return false;
+    }
+
+    std::unique_lock<std::shared_mutex> lock(m_mutex);
+    if (!insertWord(word)) {
+        return false;
+    }
+    appendJournal('+', word);
+    m_version.fetch_add(1, std::memory_order_release);
+    compactIfNeeded();
+    return true;
+}
+
+bool CustomDictionary::removeWord(const std::string& word) {
+    std::unique_lock<std::shared_mutex> lock(m_mutex);
+    if (!eraseWord(word)) {
+        return false;
+    }
+    appendJournal('-', word);
+    m_version.fetch_add(1, std::memory_order_release);
+    compactIfNeeded();
+    return true;
+}
+
+size_t CustomDictionary::size() const {
+    std::shared_lock<std::shared_mutex> lock(m_mutex);
+    return m_entries.size();
+}
+
+std::vector<std::string> CustomDictionary::words() const {
+    std::shared_lock<std::shared_mutex> lock(m_mutex);
+    std::vector<std::string> words;
+    words.reserve(m_entries.size());
+    for (const auto& entry : m_entries) {
+        words.emplace_back(entryText(entry));
+    }
+    return words;
+}
+
+uint64_t CustomDictionary::version() const {
+    return m_version.load(std::memory_order_acquire);
+}
+
+size_t CustomDictionary::memoryBytes() const {
+    std::shared_lock<std::shared_mutex> lock(m_mutex);
+    return m_arena.capacity() + m_entries.capacity() * sizeof(Entry) + m_wordIds.capacity() * sizeof(uint32_t);
+}
+
+bool CustomDictionary::compact() {
+    std::unique_lock<std::shared_mutex> lock(m_mutex);
+    return rewrite();
+}
+
+bool CustomDictionary::isValidWord(const std::string& word) {
+    return !word.empty() && word.size() <= MAX_CUSTOM_WORD_LENGTH && word.find_first_of("\r\n") == std::string::npos;
+}
+
+std::string_view CustomDictionary::entryText(const Entry& entry) const {
+    return std::string_view(m_arena).substr(entry.offset, entry.length);
+}
+
+std::vector<CustomDictionary::Entry>::const_iterator CustomDictionary::findEntry(std::string_view word) const {
+    return std::lower_bound(m_entries.begin(), m_entries.end(), word,
+                            [this](const Entry& entry, std::string_view value) { return entryText(entry) < value; });
+}
+
+bool CustomDictionary::insertWord(std::string_view word) {
+    // Called with m_mutex held exclusively. Words sorting after every entry
+    // are appended without searching.
+    auto position = m_entries.end();
+    if (!m_entries.empty() && entryText(m_entries.back()) >= word) {
+        position = m_entries.begin() + (findEntry(word) - m_entries.cbegin());
+        if (position != m_entries.end() && entryText(*position) == word) {
+            return false;
+        }
+    }
+    Entry entry{static_cast<uint32_t>(m_arena.size()), static_cast<uint32_t>(word.size())};
+    m_arena.append(word);
+    m_entries.insert(position, entry);
+
+    // Words without an ID, too long or past the word table's limit, are only found by text
+    uint32_t wordId = WordTable::global().intern(word);
+    if (wordId != INVALID_WORD_ID) {
+        m_wordIds.insert(std::upper_bound(m_wordIds.begin(), m_wordIds.end(), wordId), wordId);
+    }
+    return true;
+}
+
+bool CustomDictionary::eraseWord(std::string_view word) {
+    // Called with m_mutex held exclusively; the word's bytes stay in the arena
+    // until the next compaction
+    auto position = findEntry(word);
+    if (position == m_entries.end() || entryText(*position) != word) {
+        return false;
+    }
+    m_deadBytes += position->length;
+    m_entries.erase(position);
+
+    uint32_t wordId = WordTable::global().find(word);
+    auto id = std::lower_bound(m_wordIds.begin(), m_wordIds.end(), wordId);
+    if (id != m_wordIds.end() && *id == wordId) {
+        m_wordIds.erase(id);
+    }
+    return true;
+}
+
+void CustomDictionary::load() {
+    std::ifstream file(m_path, std::ios::binary);
+    if (!file) {
+        return;
+    }
+    std::string contents((std::istreambuf_iterator<char>(file)), std::istreambuf_iterator<char>());
+    file.close();
+
+    // A last line without its newline, from an editor or tool that does not
+    // end files with one, is kept like any other. The newline is added to the
+    // file so the next append starts on a fresh line. Records are appended
+    // with a single flushed write, so a torn one is no more than a cut word.
+    if (!contents.empty() && contents.back() != '\n') {
+        contents += '\n';
+        std::ofstream(m_path, std::ios::binary | std::ios::app) << '\n';
+    }
+
+    // Replay the journal into the set of live words. The file is already in
+    // final form only when it adds each word once, in sorted order.
+    std::unordered_set<std::string_view> live;
+    std::string_view previous;
+    bool sorted = true;
+    size_t journalEntries = 0;
+    for (size_t start = 0; start < contents.size();) {
+        size_t newline = contents.find('\n', start);
+        std::string_view line(contents.data() + start, newline - start);
+        start = newline + 1;
+        if (!line.empty() && line.back() == '\r') {
+            line.remove_suffix(1);
+        }
+        if (line.size() < 2 || line.size() - 1 > MAX_CUSTOM_WORD_LENGTH) {
+            continue;
+        }
+        std::string_view word = line.substr(1);
+        if (line[0] == '+') {
+            sorted = sorted && (journalEntries == 0 || previous < word);
+            previous = word;
+            live.insert(word);
+        } else if (line[0] == '-') {
+            sorted = false;
+            live.erase(word);
+        } else {
+            continue;
+        }
+        ++journalEntries;
+    }
+
+    // Sort the survivors once and lay them out in order, so the arena, the
+    // index and the word IDs are each built with a single pass
+    std::vector<std::string_view> words(live.begin(), live.end());
+    std::sort(words.begin(), words.end());
+
+    std::unique_lock<std::shared_mutex> lock(m_mutex);
+    m_arena.reserve(contents.size());
+    m_entries.reserve(words.size());
+    m_wordIds.reserve(words.size());
+    for (std::string_view word : words) {
+        m_entries.push_back({static_cast<uint32_t>(m_arena.size()), static_cast<uint32_t>(word.size())});
+        m_arena.append(word);
+
+        // Words without an ID, too long or past the word table's limit, are only found by text
+        uint32_t wordId = WordTable::global().intern(word);
+        if (wordId != INVALID_WORD_ID) {
+            m_wordIds.push_back(wordId);
+        }
+    }
+    std::sort(m_wordIds.begin(), m_wordIds.end());
+    m_journalEntries = journalEntries;
+
+    // A journal with history or words out of order would be replayed through
+    // the set again on every load, so store it in final form now
+    if (!sorted) {
+        rewrite();
+    }
+}
+
+void CustomDictionary::appendJournal(char operation, const std::string& word) {
+    // Called with m_mutex held exclusively. In-memory dictionaries have no journal.
+    if (m_path.empty()) {
+        return;
+    }
+    if (!m_journal.is_open()) {
+        bool isNew = !std::filesystem::exists(m_path);
+        m_journal.open(m_path, std::ios::binary | std::ios::app);
+        if (isNew) {
+            m_journal << CUSTOM_DICTIONARY_HEADER << '\n';
+        }
+    }
+    m_journal << operation << word << '\n';
+    m_journal.flush();
+    ++m_journalEntries;
+}
+
+void CustomDictionary::compactIfNeeded() {
+    // Called with m_mutex held exclusively. Compact once the journal is
+    // mostly history, which keeps appends amortised O(1). Words only added
+    // leave no history; they are sorted into place by the next load.
+    // A rewrite that failed is retried once the journal has doubled, so a file
+    // that cannot be replaced does not cost a full rewrite per change.
+    if (m_journalEntries >= MIN_COMPACTION_ENTRIES && m_journalEntries > 2 * m_entries.size() &&
+        m_journalEntries >= 2 * m_failedCompactionEntries) {
+        if (!rewrite()) {
+            m_failedCompactionEntries = m_journalEntries;
+        }
+    }
+}
+
+bool CustomDictionary::rewrite() {
+    // Called with m_mutex held exclusively. Rebuild the arena in sorted order
+    // without the bytes of removed words.
+    std::string arena;
+    arena.reserve(m_arena.size() - m_deadBytes);
+    for (auto& entry : m_entries) {
+        std::string_view text = entryText(entry);
+        uint32_t offset = static_cast<uint32_t>(arena.size());
+        arena.append(text);
+        entry.offset = offset;
+    }
+    m_arena = std::move(arena);
+    m_deadBytes = 0;
+
+    if (m_path.empty()) {
+        return true;
+    }
+
+    // Write the live words to a temporary file and move it over the journal,
+    // so a crash leaves either the old journal or the new file
+    std::string temporaryPath = m_path + ".tmp";
+    {
+        std::ofstream file(temporaryPath, std::ios::binary | std::ios::trunc);
+        if (!file) {
+            return false;
+        }
+        file << CUSTOM_DICTIONARY_HEADER << '\n';
+        for (const auto& entry : m_entries) {
+            file << '+' << entryText(entry) << '\n';
+        }
+        if (!file.flush()) {
+            return false;
+        }
+    }
+    // std::filesystem::rename replaces the journal on Windows too, where
+    // std::rename refuses an existing target
+    m_journal.close();
+    std::error_code error;
+    std::filesystem::rename(temporaryPath, m_path, error);
+    if (error) {
+        std::filesystem::remove(temporaryPath, error);
+        return false;
+    }
+    m_journalEntries = m_entries.size();
+    m_failedCompactionEntries = 0;
+    return true;
+}
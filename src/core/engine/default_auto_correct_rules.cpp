@@ -0,0 +1,54 @@
+#include <string_view>
+#include <cstdint>
+#include "default_auto_correct_rules.h"
+#include "word_table.h"
+
+// The default auto-correct rules of each language are generated into static
+// tables, so they live in read-only memory, are shared by every process
+// mapping the binary and need no parsing at startup. Each table is indexed by
+// a perfect hash (hash and displace): the rule's hash picks a bucket, and the
+// bucket's displacement picks the one slot that can hold the rule, so a lookup
+// hashes the text once and compares a single rule.
+
+namespace {
+
+uint32_t bucketFor(uint64_t hash, uint32_t bucketCount) {
+    return static_cast<uint32_t>((hash >> 32) % bucketCount);
+}
+
+uint32_t slotFor(uint64_t hash, uint32_t displacement, uint32_t slotCount) {
+    // The 64-bit finalizer of MurmurHash3, seeded with the displacement
+    uint64_t mixed = hash ^ (displacement * 0x9e3779b97f4a7c15ull);
+    mixed ^= mixed >> 33;
+    mixed *= 0xff51afd7ed558ccdull;
+    mixed ^= mixed >> 33;
+    return static_cast<uint32_t>(mixed % slotCount);
+}
+
+#include "default_auto_correct_rules.inc"
+
+} // namespace
+
+const DefaultAutoCorrectTable* findDefaultAutoCorrectTable(std::string_view languageCode) {
+    // A handful of languages, looked up once per language load
+    for (const auto& table : DEFAULT_AUTO_CORRECT_TABLES) {
+        if (table.languageCode == languageCode) {
+            return &table;
+        }
+    }
+    return nullptr;
+}
+
+const DefaultAutoCorrectRule* findDefaultAutoCorrection(const DefaultAutoCorrectTable& table, std::string_view incorrect) {
+    if (table.ruleCount == 0) {
+        return nullptr;
+    }
+
+    // Text that is not a rule lands in a free slot or on another rule
+    uint64_t hash = hashWord(incorrect);
+    uint32_t slot = table.slots[slotFor(hash, table.displacements[bucketFor(hash, table.bucketCount)], table.slotCount)];
+    if (slot == 0 || table.rules[slot - 1].incorrect != incorrect) {
+        return nullptr;
+    }
+    return &table.rules[slot - 1];
+}
@@ -1,10 +1,19 @@
 #include <string>
+#include <string_view>
 #include <vector>
 #include <memory>
+#include <memory_resource>
+#include <algorithm>
+#include <atomic>
+#include <thread>
 #include <languagetool/languagetool.h>
 #include "grammar_check.h"
-#include "language_manager.h"
-#include "text_processing.h"
+#include "language_resources.h"
+#include "text_segmentation.h"
+#include "proofing_arena.h"
+#include "grammar_result_cache.h"
+#include "char_classifier.h"
+#include "work_stealing_pool.h"
 
 // Maximum number of suggestions to return for each grammar error
 const int MAX_SUGGESTIONS = 5;
@@ -28,41 +37,97 @@ GrammarError convertToGrammarError(const LanguageToolError& ltError) {
     return grammarError;
 }
 
+namespace {
+
+// Threads that check the sentences of long paragraphs, shared by every
+// checker of the process. How many of them a paragraph uses is bounded by the
+// registry's grammar pool size, which also caps the LanguageTool instances.
+WorkStealingPool& grammarPool() {
+    static WorkStealingPool pool(0);
+    return pool;
+}
+
+} // namespace
+
 GrammarCheck::GrammarCheck() {
-    // Initialize m_languageManager with a new LanguageManager object
-    m_languageManager = std::make_shared<LanguageManager>();
+    // Share the default language's LanguageTool rules with every other checker
+    std::string defaultLanguage = LanguageResourceRegistry::global().defaultLanguage();
+    m_resources = LanguageResourceRegistry::global().acquire(defaultLanguage);
+
+    // Sentences repeat across documents, so results are cached process-wide
+    m_resultCache = GrammarResultCache::global();
+}
 
-    // Initialize m_textProcessor with a new TextProcessing object
-    m_textProcessor = std::make_shared<TextProcessing>();
+std::shared_ptr<const LanguageResources> GrammarCheck::languageResources() const {
+    // setLanguage swaps m_resources atomically while checks may be running; a
+    // check keeps the resources it loaded alive until it finishes
+    return std::atomic_load_explicit(&m_resources, std::memory_order_acquire);
+}
+
+std::vector<GrammarError> GrammarCheck::checkSentence(std::string_view sentence) {
+    ProofingArena::Pass pass(m_arena.get());
+    auto grammarErrors = checkSentence(sentence, arenaResource(m_arena.get()));
 
-    // Set m_currentLanguage to the default language
-    m_currentLanguage = m_languageManager->getDefaultLanguage();
+    // Copy the errors out of the arena before the pass releases it
+    return std::vector<GrammarError>(grammarErrors.begin(), grammarErrors.end());
+}
 
-    // Initialize m_languageTool with the default language rules
-    auto defaultRules = m_languageManager->getLanguageRules(m_currentLanguage);
-    m_languageTool = std::make_shared<LanguageTool>(defaultRules);
+std::pmr::vector<GrammarError> GrammarCheck::checkSentence(std::string_view sentence, std::pmr::memory_resource* resource) {
+    return checkSentence(*languageResources(), sentence, resource);
 }
 
-std::vector<GrammarError> GrammarCheck::checkSentence(const std::string& sentence) {
-    // Tokenize the input sentence using m_textProcessor
-    std::vector<std::string> tokens = m_textProcessor->tokenizeSentence(sentence);
+std::pmr::vector<GrammarError> GrammarCheck::checkSentence(const LanguageResources& languageResources, std::string_view sentence,
+                                                           std::pmr::memory_resource* resource) {
+    // Most sentences are unchanged since the last pass, or repeat text
+    // already checked in another document. Trailing whitespace never reaches
+    // LanguageTool, so it is left out of the key.
+    std::string_view keyText = sentence;
+    while (!keyText.empty() && classifyCharacter(static_cast<unsigned char>(keyText.back())) == CharClass::Whitespace) {
+        keyText.remove_suffix(1);
+    }
+    std::pmr::vector<GrammarError> grammarErrors(resource);
+    GrammarResultCache::Key key = GrammarResultCache::makeKey(languageResources.languageCode(),
+                                                              languageResources.ruleSetVersion(), keyText);
+    if (m_resultCache && m_resultCache->lookup(key, grammarErrors)) {
+        return grammarErrors;
+    }
 
-    // Use m_languageTool to check the tokenized sentence
-    std::vector<LanguageToolError> ltErrors = m_languageTool->check(tokens);
+    // Tokenize the input sentence into views over the sentence buffer
+    std::pmr::vector<TextToken> tokens = tokenizeText(sentence, resource);
+    std::pmr::vector<std::string_view> tokenTexts(resource);
+    tokenTexts.reserve(tokens.size());
+    for (const auto& token : tokens) {
+        tokenTexts.push_back(token.text);
+    }
+
+    // Use the language's shared LanguageTool instances to check the tokenized sentence
+    std::vector<LanguageToolError> ltErrors = languageResources.checkGrammar(tokenTexts);
 
     // Convert LanguageTool errors to GrammarError objects
-    std::vector<GrammarError> grammarErrors;
+    grammarErrors.reserve(ltErrors.size());
     for (const auto& ltError : ltErrors) {
         grammarErrors.push_back(convertToGrammarError(ltError));
     }
+    if (m_resultCache) {
+        m_resultCache->store(key, grammarErrors);
+    }
 
     // Return the list of GrammarError objects
     return grammarErrors;
 }
 
+void GrammarCheck::setProofingArena(std::shared_ptr<ProofingArena> arena) {
+    m_arena = std::move(arena);
+}
+
+void GrammarCheck::setResultCache(std::shared_ptr<GrammarResultCache> cache) {
+    // A null cache checks every sentence with LanguageTool
+    m_resultCache = std::move(cache);
+}
+
 std::vector<std::string> GrammarCheck::getSuggestions(const GrammarError& error) {
-    // Use m_languageTool to generate suggestions for the error
-    std::vector<std::string> allSuggestions = m_languageTool->getSuggestions(error.message, error.startPos, error.endPos);
+    // Use the language's shared LanguageTool instances to generate suggestions for the error
+    std::vector<std::string> allSuggestions = languageResources()->grammarSuggestions(error.message, error.startPos, error.endPos);
 
     // Limit the number of suggestions to MAX_SUGGESTIONS
     std::vector<std::string> limitedSuggestions;
@@ -74,17 +139,18 @@ std::vector<std::string> GrammarCheck::getSuggestions(const GrammarError& error)
     return limitedSuggestions;
 }
 
-bool GrammarCheck::setLanguage(const std::string& languageCode) {
-    // Get the language rules for the specified language from m_languageManager
-    auto languageRules = m_languageManager->getLanguageRules(languageCode);
+std::string GrammarCheck::getLanguage() const {
+    return languageResources()->languageCode();
+}
 
-    if (!languageRules.empty()) {
-        // Create a new LanguageTool object with the language rules
-        auto newLanguageTool = std::make_shared<LanguageTool>(languageRules);
+bool GrammarCheck::setLanguage(const std::string& languageCode) {
+    // Get the shared resources of the specified language, loading them if no
+    // other checker uses the language yet
+    auto resources = LanguageResourceRegistry::global().acquire(languageCode);
 
-        // If successful, update m_currentLanguage and m_languageTool
-        m_currentLanguage = languageCode;
-        m_languageTool = newLanguageTool;
+    if (resources->hasGrammarRules()) {
+        // If successful, publish the new resources without blocking running checks
+        std::atomic_store_explicit(&m_resources, std::move(resources), std::memory_order_release);
         return true;
     }
 
@@ -92,19 +158,34 @@ bool GrammarCheck::setLanguage(const std::string& languageCode) {
     return false;
 }
 
-std::vector<GrammarError> GrammarCheck::checkParagraph(const std::string& paragraph) {
-    // Split the paragraph into sentences using m_textProcessor
-    std::vector<std::string> sentences = m_textProcessor->splitIntoParagraphs(paragraph);
-
-    // For each sentence, call checkSentence
+std::vector<GrammarError> GrammarCheck::checkParagraph(std::string_view paragraph) {
+    // The whole paragraph is checked in the language current when it started
+    auto resources = languageResources();
+    ProofingArena::Pass pass(m_arena.get());
+    std::pmr::vector<TextSegment> sentences =
+        splitIntoSentences(paragraph, arenaResource(m_arena.get()), resources->languageCode());
+
+    // Check the sentences across the grammar threads and this one. The arena
+    // belongs to this thread, so the sentences' errors are allocated normally.
+    std::vector<std::pmr::vector<GrammarError>> sentenceErrors(sentences.size());
+    size_t helpers = sentences.size() > 1 ? LanguageResourceRegistry::global().grammarPoolSize() - 1 : 0;
+    grammarPool().parallelFor(sentences.size(), helpers, [&](size_t i) {
+        sentenceErrors[i] = checkSentence(*resources, sentences[i].text, std::pmr::new_delete_resource());
+    });
+
+    // Merge in sentence order, mapping sentence-relative positions to
+    // paragraph offsets, so the result does not depend on scheduling
     std::vector<GrammarError> allErrors;
-    for (const auto& sentence : sentences) {
-        auto sentenceErrors = checkSentence(sentence);
-        
-        // Aggregate all GrammarError objects from sentences
-        allErrors.insert(allErrors.end(), sentenceErrors.begin(), sentenceErrors.end());
+    for (size_t i = 0; i < sentences.size(); ++i) {
+        std::stable_sort(sentenceErrors[i].begin(), sentenceErrors[i].end(),
+                         [](const GrammarError& a, const GrammarError& b) { return a.startPos < b.startPos; });
+        for (auto& error : sentenceErrors[i]) {
+            error.startPos += sentences[i].offset;
+            error.endPos += sentences[i].offset;
+            allErrors.push_back(std::move(error));
+        }
     }
 
     // Return the combined list of GrammarError objects
     return allErrors;
-}
\ No newline at end of file
+}
@@ -0,0 +1,158 @@
+#include <string>
+#include <string_view>
+#include <list>
+#include <unordered_map>
+#include <vector>
+#include <memory>
+#include <memory_resource>
+#include <mutex>
+#include <atomic>
+#include <cstdint>
+#include "grammar_result_cache.h"
+#include "grammar_check.h"
+#include "word_table.h"
+
+// Bounded cache of the grammar errors of whole sentences, shared by every
+// document of the process. Entries are keyed by a 64-bit hash of the language,
+// its rule-set version and the sentence text, and hold the errors with
+// sentence-relative offsets, so a sentence that moved keeps its entry. Each
+// entry also keeps its sentence and a hash of the language and rule set alone,
+// so a hash collision is a miss rather than another sentence's errors. Like
+// the spelling verdict cache, entries are spread over shards and each shard
+// evicts its least recently used sentences once over its share of the budget.
+const size_t DEFAULT_GRAMMAR_CACHE_BYTES = 8 * 1024 * 1024;
+const size_t GRAMMAR_CACHE_SHARDS = 16;
+const size_t GRAMMAR_ENTRY_OVERHEAD = 128; // List node, map node, string and vector headers, approximately
+
+namespace {
+
+// Size of one cached entry, counting its sentence and the strings of each error
+size_t entryBytes(const std::string& sentence, const std::vector<GrammarError>& errors) {
+    size_t bytes = GRAMMAR_ENTRY_OVERHEAD + sentence.capacity() + errors.size() * sizeof(GrammarError);
+    for (const auto& error : errors) {
+        bytes += error.message.capacity() + error.errorType.capacity();
+    }
+    return bytes;
+}
+
+uint64_t combineHash(uint64_t seed, uint64_t value) {
+    return seed ^ (value + 0x9e3779b97f4a7c15ull + (seed << 6) + (seed >> 2));
+}
+
+} // namespace
+
+struct GrammarResultCache::Shard {
+    struct Node {
+        uint64_t hash;
+        uint64_t context;
+        std::string sentence;
+        std::vector<GrammarError> errors;
+        size_t bytes;
+    };
+
+    std::mutex mutex;
+    std::list<Node> recency; // Most recently used at the front
+    std::unordered_map<uint64_t, std::list<Node>::iterator> index;
+    size_t bytes = 0;
+};
+
+std::shared_ptr<GrammarResultCache> GrammarResultCache::global() {
+    static std::shared_ptr<GrammarResultCache> cache = std::make_shared<GrammarResultCache>();
+    return cache;
+}
+
+GrammarResultCache::GrammarResultCache(size_t memoryBudgetBytes)
+    : m_memoryBudgetBytes(memoryBudgetBytes) {
+    for (size_t i = 0; i < GRAMMAR_CACHE_SHARDS; ++i) {
+        m_shards.push_back(std::make_unique<Shard>());
+    }
+}
+
+GrammarResultCache::~GrammarResultCache() = default;
+
+GrammarResultCache::Key GrammarResultCache::makeKey(const std::string& languageCode, uint64_t ruleSetVersion,
+                                                    std::string_view sentence) {
+    Key key;
+    key.context = combineHash(hashWord(languageCode), ruleSetVersion);
+    key.hash = combineHash(combineHash(hashWord(sentence), hashWord(languageCode)), ruleSetVersion);
+    key.sentence = sentence;
+    return key;
+}
+
+bool GrammarResultCache::lookup(const Key& key, std::pmr::vector<GrammarError>& errors) {
+    Shard& shard = shardFor(key);
+    std::lock_guard<std::mutex> lock(shard.mutex);
+
+    // A colliding hash from another sentence or language is a miss
+    auto it = shard.index.find(key.hash);
+    if (it == shard.index.end() || it->second->context != key.context || it->second->sentence != key.sentence) {
+        m_misses.fetch_add(1, std::memory_order_relaxed);
+        return false;
+    }
+
+    // Move the entry to the front so repeated sentences survive eviction
+    shard.recency.splice(shard.recency.begin(), shard.recency, it->second);
+    errors.assign(it->second->errors.begin(), it->second->errors.end());
+    m_hits.fetch_add(1, std::memory_order_relaxed);
+    return true;
+}
+
+void GrammarResultCache::store(const Key& key, const std::pmr::vector<GrammarError>& errors) {
+    std::string sentence(key.sentence);
+    std::vector<GrammarError> entry(errors.begin(), errors.end());
+    size_t bytes = entryBytes(sentence, entry);
+    size_t shardBudget = m_memoryBudgetBytes.load(std::memory_order_relaxed) / GRAMMAR_CACHE_SHARDS;
+    if (bytes > shardBudget) {
+        return;
+    }
+
+    Shard& shard = shardFor(key);
+    std::lock_guard<std::mutex> lock(shard.mutex);
+    if (shard.index.find(key.hash) != shard.index.end()) {
+        return;
+    }
+
+    shard.recency.push_front({key.hash, key.context, std::move(sentence), std::move(entry), bytes});
+    shard.index.emplace(key.hash, shard.recency.begin());
+    shard.bytes += bytes;
+
+    // Evict least recently used sentences until the shard fits its budget again
+    while (shard.bytes > shardBudget) {
+        const auto& victim = shard.recency.back();
+        shard.bytes -= victim.bytes;
+        shard.index.erase(victim.hash);
+        shard.recency.pop_back();
+        m_evictions.fetch_add(1, std::memory_order_relaxed);
+    }
+}
+
+void GrammarResultCache::clear() {
+    for (auto& shard : m_shards) {
+        std::lock_guard<std::mutex> lock(shard->mutex);
+        shard->index.clear();
+        shard->recency.clear();
+        shard->bytes = 0;
+    }
+}
+
+void GrammarResultCache::setMemoryBudget(size_t memoryBudgetBytes) {
+    // Shrinking the budget evicts on the next store of each shard
+    m_memoryBudgetBytes.store(memoryBudgetBytes, std::memory_order_relaxed);
+}
+
+GrammarResultCache::Stats GrammarResultCache::stats() const {
+    Stats stats;
+    stats.hits = m_hits.load(std::memory_order_relaxed);
+    stats.misses = m_misses.load(std::memory_order_relaxed);
+    stats.evictions = m_evictions.load(std::memory_order_relaxed);
+    for (const auto& shard : m_shards) {
+        std::lock_guard<std::mutex> lock(shard->mutex);
+        stats.entries += shard->index.size();
+        stats.bytes += shard->bytes;
+    }
+    return stats;
+}
+
+GrammarResultCache::Shard& GrammarResultCache::shardFor(const Key& key) {
+    return *m_shards[key.hash % GRAMMAR_CACHE_SHARDS];
+}
@@ -0,0 +1,610 @@
+#include <string>
+#include <string_view>
+#include <vector>
+#include <optional>
+#include <functional>
+#include <unordered_map>
+#include <unordered_set>
+#include <memory>
+#include <memory_resource>
+#include <mutex>
+#include <future>
+#include <algorithm>
+#include <atomic>
+#include <thread>
+#include <chrono>
+#include <condition_variable>
+#include <filesystem>
+#include <hunspell/hunspell.hxx>
+#include <languagetool/languagetool.h>
+#include "language_resources.h"
+#include "language_manager.h"
+#include "auto_correct_matcher.h"
+#include "default_auto_correct_rules.h"
+#include "compiled_dictionary.h"
+#include "symspell_index.h"
+#include "word_table.h"
+
+// Immutable per-language resources are loaded once per process and shared by
+// every SpellCheck, GrammarCheck and AutoCorrect that uses the language. A
+// language nobody holds a handle to any more is unloaded once it has been idle
+// for the registry's idle timeout, unless it is one of the few most recently
+// released languages or one the user configured for preloading. Those stay
+// warm, with their compiled LanguageTool rules, so documents that alternate
+// languages switch without recompiling rules. Besides on every acquire and
+// release, idle languages are swept by a background thread of the registry,
+// so a language released last on a quiet process is unloaded too.
+//
+// Hunspell and LanguageTool instances are not safe to use from two threads at
+// once, so each language keeps a small pool of them: a caller checks one out
+// for the duration of a call and a new instance is only created when all
+// existing ones are busy. The pool therefore grows with the number of threads
+// proofing the language, not with the number of open documents. Both kinds of
+// instance hold a full copy of the language's data, so their number is
+// capped: Hunspell's by DEFAULT_HUNSPELL_POOL_SIZE, LanguageTool's by the
+// registry's grammar pool size. Callers beyond the cap wait for an instance
+// to come back. Hunspell instances a burst of checks left idle are dropped
+// again once they have been unused for a while, down to a low-water mark.
+const std::chrono::seconds DEFAULT_LANGUAGE_IDLE_TIMEOUT(300);
+const std::chrono::seconds DEFAULT_LANGUAGE_SWEEP_INTERVAL(10);
+const size_t DEFAULT_HUNSPELL_POOL_SIZE = 4;
+const size_t IDLE_HUNSPELL_LOW_WATER = 1;               // Idle instances kept however long they are unused
+const std::chrono::seconds IDLE_HUNSPELL_TIMEOUT(30);   // Idle time after which extra instances are dropped
+const size_t DEFAULT_WARM_LANGUAGES = 4; // Released languages kept loaded beyond the idle timeout
+
+// Approximate bookkeeping cost of one entry in an unordered_map<string, string>
+const size_t AUTO_CORRECT_ENTRY_OVERHEAD = 64;
+
+// Source of rule-set versions; every load of a language gets a new one
+std::atomic<uint64_t> nextRuleSetVersion(1);
+
+LanguageResources::LanguageResources(const std::string& languageCode)
+    : m_languageCode(languageCode),
+      m_ruleSetVersion(nextRuleSetVersion.fetch_add(1, std::memory_order_relaxed)) {
+    // Each language has its own manager so lazily created instances never
+    // share one across languages being loaded concurrently
+    m_languageManager = std::make_shared<LanguageManager>();
+    m_dictionaryPath = m_languageManager->getDictionaryPath(languageCode);
+
+    // Map the precompiled image when there is one compiled from the current
+    // .aff and .dic; Hunspell is only created for the words it cannot decide
+    // and for suggestions
+    if (!m_dictionaryPath.empty()) {
+        m_compiledDictionary = CompiledDictionary::open(m_dictionaryPath + ".cdic", m_dictionaryPath + ".aff",
+                                                        m_dictionaryPath + ".dic");
+    }
+
+    // Use the language's generated auto-correct table, which is read in place;
+    // only languages shipped without one load their rules from the manager
+    m_defaultAutoCorrectRules = findDefaultAutoCorrectTable(languageCode);
+    if (!m_defaultAutoCorrectRules) {
+        for (const auto& rule : m_languageManager->getAutoCorrectRules(languageCode)) {
+            m_autoCorrectRules[rule.first] = rule.second;
+        }
+    }
+
+    // Compile the rules into the matcher that scans whole texts
+    std::vector<std::pair<std::string_view, std::string_view>> rules;
+    forEachAutoCorrection([&rules](std::string_view incorrect, std::string_view correct) {
+        rules.emplace_back(incorrect, correct);
+    });
+    m_autoCorrectMatcher = std::make_unique<AutoCorrectMatcher>(rules);
+}
+
+LanguageResources::~LanguageResources() = default;
+
+const std::string& LanguageResources::languageCode() const {
+    return m_languageCode;
+}
+
+const std::string& LanguageResources::dictionaryPath() const {
+    return m_dictionaryPath;
+}
+
+void LanguageResources::setLanguageToolPoolSize(size_t poolSize) {
+    std::lock_guard<std::mutex> lock(m_poolMutex);
+    m_languageToolPoolSize = std::max<size_t>(1, poolSize);
+    m_languageToolReturned.notify_all();
+}
+
+uint64_t LanguageResources::ruleSetVersion() const {
+    // Rules are read from disk on each load, so results cached for an earlier
+    // load of the language are never reused with rules that may have changed
+    return m_ruleSetVersion;
+}
+
+bool LanguageResources::isCorrect(const std::string& word) const {
+    // The compiled dictionary answers most words without touching Hunspell
+    auto verdict = m_compiledDictionary ? m_compiledDictionary->check(word) : CompiledDictionary::Verdict::Unknown;
+    if (verdict != CompiledDictionary::Verdict::Unknown) {
+        return verdict == CompiledDictionary::Verdict::Correct;
+    }
+
+    auto hunspell = checkoutHunspell();
+    bool correct = hunspell->spell(word);
+    returnHunspell(std::move(hunspell));
+    return correct;
+}
+
+std::vector<std::string> LanguageResources::suggest(const std::string& word) const {
+    auto hunspell = checkoutHunspell();
+    std::vector<std::string> suggestions = hunspell->suggest(word);
+    returnHunspell(std::move(hunspell));
+    return suggestions;
+}
+
+std::shared_ptr<const SymSpellIndex> LanguageResources::symSpellIndex() const {
+    // Load the index cached next to the dictionary, or build it once and cache it
+    std::lock_guard<std::mutex> lock(m_symSpellMutex);
+    if (!m_symSpellIndex && !m_dictionaryPath.empty()) {
+        m_symSpellIndex = SymSpellIndex::loadCached(m_dictionaryPath);
+        if (!m_symSpellIndex) {
+            auto index = SymSpellIndex::buildFromDictionary(m_dictionaryPath, [this](const std::string& candidate) {
+                return isCorrect(candidate);
+            });
+            if (index) {
+                // The dictionary directory may be read-only; the index is then rebuilt next time
+                index->save(m_dictionaryPath + ".symspell");
+                m_symSpellIndex = std::move(index);
+            }
+        }
+    }
+    return m_symSpellIndex;
+}
+
+bool LanguageResources::hasGrammarRules() const {
+    // Creating the first instance also tells whether the language has rules
+    auto languageTool = checkoutLanguageTool();
+    if (!languageTool) {
+        return false;
+    }
+    returnLanguageTool(std::move(languageTool));
+    return true;
+}
+
+std::vector<LanguageToolError> LanguageResources::checkGrammar(const std::pmr::vector<std::string_view>& tokens) const {
+    auto languageTool = checkoutLanguageTool();
+    if (!languageTool) {
+        return {};
+    }
+    std::vector<LanguageToolError> errors = languageTool->check(tokens);
+    returnLanguageTool(std::move(languageTool));
+    return errors;
+}
+
+std::vector<std::string> LanguageResources::grammarSuggestions(const std::string& message, int startPos, int endPos) const {
+    auto languageTool = checkoutLanguageTool();
+    if (!languageTool) {
+        return {};
+    }
+    std::vector<std::string> suggestions = languageTool->getSuggestions(message, startPos, endPos);
+    returnLanguageTool(std::move(languageTool));
+    return suggestions;
+}
+
+std::optional<std::string_view> LanguageResources::findAutoCorrection(uint32_t wordId) const {
+    // Words without an ID, too long or seen after the word table filled up,
+    // must be looked up by text
+    if (wordId == INVALID_WORD_ID) {
+        return std::nullopt;
+    }
+    return findAutoCorrection(WordTable::global().text(wordId));
+}
+
+std::optional<std::string_view> LanguageResources::findAutoCorrection(std::string_view incorrect) const {
+    if (m_defaultAutoCorrectRules) {
+        const DefaultAutoCorrectRule* rule = findDefaultAutoCorrection(*m_defaultAutoCorrectRules, incorrect);
+        return rule ? std::optional<std::string_view>(rule->correct) : std::nullopt;
+    }
+    auto rule = m_autoCorrectRules.find(std::string(incorrect));
+    return rule != m_autoCorrectRules.end() ? std::optional<std::string_view>(rule->second) : std::nullopt;
+}
+
+size_t LanguageResources::autoCorrectRuleCount() const {
+    return m_defaultAutoCorrectRules ? m_defaultAutoCorrectRules->ruleCount : m_autoCorrectRules.size();
+}
+
+void LanguageResources::forEachAutoCorrection(const std::function<void(std::string_view, std::string_view)>& visit) const {
+    if (m_defaultAutoCorrectRules) {
+        for (uint32_t i = 0; i < m_defaultAutoCorrectRules->ruleCount; ++i) {
+            visit(m_defaultAutoCorrectRules->rules[i].incorrect, m_defaultAutoCorrectRules->rules[i].correct);
+        }
+        return;
+    }
+    for (const auto& rule : m_autoCorrectRules) {
+        visit(rule.first, rule.second);
+    }
+}
+
+const AutoCorrectMatcher& LanguageResources::autoCorrectMatcher() const {
+    return *m_autoCorrectMatcher;
+}
+
+LanguageMemoryUsage LanguageResources::memoryUsage() const {
+    LanguageMemoryUsage usage;
+    usage.languageCode = m_languageCode;
+    usage.compiledDictionaryBytes = m_compiledDictionary ? m_compiledDictionary->imageBytes() : 0;
+
+    {
+        std::lock_guard<std::mutex> lock(m_poolMutex);
+        usage.hunspellInstances = m_hunspellInstances;
+        usage.languageToolInstances = m_languageToolInstances;
+    }
+
+    // Hunspell does not report its own size; its tables are roughly the size
+    // of the files it parsed, so that is used as the estimate per instance
+    if (usage.hunspellInstances > 0) {
+        std::error_code error;
+        auto affBytes = std::filesystem::file_size(m_dictionaryPath + ".aff", error);
+        size_t fileBytes = error ? 0 : static_cast<size_t>(affBytes);
+        auto dicBytes = std::filesystem::file_size(m_dictionaryPath + ".dic", error);
+        fileBytes += error ? 0 : static_cast<size_t>(dicBytes);
+        usage.hunspellBytes = fileBytes * usage.hunspellInstances;
+    }
+
+    {
+        std::lock_guard<std::mutex> lock(m_symSpellMutex);
+        usage.suggestionIndexBytes = m_symSpellIndex ? m_symSpellIndex->memoryBytes() : 0;
+    }
+
+    // Generated tables are in read-only memory shared with other processes,
+    // so only the rules loaded at runtime and the matcher count
+    for (const auto& rule : m_autoCorrectRules) {
+        usage.autoCorrectBytes += rule.first.size() + rule.second.size() + AUTO_CORRECT_ENTRY_OVERHEAD;
+    }
+    usage.autoCorrectBytes += m_autoCorrectMatcher->memoryBytes();
+
+    usage.totalBytes = usage.compiledDictionaryBytes + usage.hunspellBytes + usage.suggestionIndexBytes + usage.autoCorrectBytes;
+    return usage;
+}
+
+std::unique_ptr<Hunspell> LanguageResources::checkoutHunspell() const {
+    {
+        // Wait for an idle instance when the pool has reached its size. The
+        // most recently returned instance is reused, so the others stay idle
+        // long enough to be dropped.
+        std::unique_lock<std::mutex> lock(m_poolMutex);
+        m_hunspellReturned.wait(lock, [this] {
+            return !m_idleHunspell.empty() || m_hunspellInstances < DEFAULT_HUNSPELL_POOL_SIZE;
+        });
+        if (!m_idleHunspell.empty()) {
+            auto hunspell = std::move(m_idleHunspell.back().first);
+            m_idleHunspell.pop_back();
+            return hunspell;
+        }
+        ++m_hunspellInstances;
+    }
+
+    // Every instance is busy, so create another one outside the lock
+    try {
+        return std::make_unique<Hunspell>((m_dictionaryPath + ".aff").c_str(), (m_dictionaryPath + ".dic").c_str());
+    } catch (...) {
+        std::lock_guard<std::mutex> lock(m_poolMutex);
+        --m_hunspellInstances;
+        m_hunspellReturned.notify_one();
+        throw;
+    }
+}
+
+void LanguageResources::returnHunspell(std::unique_ptr<Hunspell> hunspell) const {
+    std::vector<std::unique_ptr<Hunspell>> dropped;
+    {
+        std::lock_guard<std::mutex> lock(m_poolMutex);
+        auto now = std::chrono::steady_clock::now();
+        m_idleHunspell.emplace_back(std::move(hunspell), now);
+        dropped = trimIdleHunspell(now);
+        m_hunspellReturned.notify_one();
+    }
+    // The dropped instances are destroyed here, outside the lock
+}
+
+void LanguageResources::trimIdleInstances() const {
+    std::vector<std::unique_ptr<Hunspell>> dropped;
+    std::lock_guard<std::mutex> lock(m_poolMutex);
+    dropped = trimIdleHunspell(std::chrono::steady_clock::now());
+}
+
+std::vector<std::unique_ptr<Hunspell>> LanguageResources::trimIdleHunspell(std::chrono::steady_clock::time_point now) const {
+    // Called with m_poolMutex held. Idle instances are in the order they were
+    // returned, so the ones idle the longest are at the front.
+    std::vector<std::unique_ptr<Hunspell>> dropped;
+    while (m_idleHunspell.size() > IDLE_HUNSPELL_LOW_WATER && now - m_idleHunspell.front().second >= IDLE_HUNSPELL_TIMEOUT) {
+        dropped.push_back(std::move(m_idleHunspell.front().first));
+        m_idleHunspell.erase(m_idleHunspell.begin());
+        --m_hunspellInstances;
+    }
+    return dropped;
+}
+
+std::unique_ptr<LanguageTool> LanguageResources::checkoutLanguageTool() const {
+    {
+        // Wait for an idle instance when the pool has reached its size
+        std::unique_lock<std::mutex> lock(m_poolMutex);
+        m_languageToolReturned.wait(lock, [this] {
+            return !m_idleLanguageTools.empty() || m_hasGrammarRules == GrammarRules::Missing
+                || m_languageToolInstances < m_languageToolPoolSize;
+        });
+        if (!m_idleLanguageTools.empty()) {
+            auto languageTool = std::move(m_idleLanguageTools.back());
+            m_idleLanguageTools.pop_back();
+            return languageTool;
+        }
+        if (m_hasGrammarRules == GrammarRules::Missing) {
+            return nullptr;
+        }
+
+        // Reserve the new instance's slot before creating it outside the lock
+        ++m_languageToolInstances;
+    }
+
+    try {
+        // Rule sets are fetched per instance, since LanguageManager hands them out by value
+        std::unique_lock<std::mutex> managerLock(m_languageManagerMutex);
+        auto languageRules = m_languageManager->getLanguageRules(m_languageCode);
+        managerLock.unlock();
+
+        std::lock_guard<std::mutex> lock(m_poolMutex);
+        if (languageRules.empty()) {
+            m_hasGrammarRules = GrammarRules::Missing;
+            --m_languageToolInstances;
+            m_languageToolReturned.notify_all();
+            return nullptr;
+        }
+        m_hasGrammarRules = GrammarRules::Present;
+        return std::make_unique<LanguageTool>(languageRules);
+    } catch (...) {
+        std::lock_guard<std::mutex> lock(m_poolMutex);
+        --m_languageToolInstances;
+        m_languageToolReturned.notify_one();
+        throw;
+    }
+}
+
+void LanguageResources::returnLanguageTool(std::unique_ptr<LanguageTool> languageTool) const {
+    std::lock_guard<std::mutex> lock(m_poolMutex);
+    m_idleLanguageTools.push_back(std::move(languageTool));
+    m_languageToolReturned.notify_one();
+}
+
+struct LanguageResourceRegistry::State {
+    struct Entry {
+        std::shared_ptr<LanguageResources> resources;
+        size_t handles = 0;
+        std::chrono::steady_clock::time_point lastReleased;
+    };
+
+    // A language being loaded, outside the mutex, by the first caller that
+    // asked for it; later callers wait on the same load
+    struct Load {
+        std::shared_future<std::shared_ptr<LanguageResources>> resources;
+        size_t handles = 0;
+    };
+
+    std::mutex mutex;
+    std::unordered_map<std::string, Entry> entries; // Only fully loaded languages
+    std::unordered_map<std::string, Load> loads;
+    std::chrono::steady_clock::duration idleTimeout = DEFAULT_LANGUAGE_IDLE_TIMEOUT;
+    size_t grammarPoolSize = std::max<size_t>(1, std::thread::hardware_concurrency());
+    size_t warmLanguages = DEFAULT_WARM_LANGUAGES;
+    std::unordered_set<std::string> preloaded;
+    std::chrono::steady_clock::duration sweepInterval = DEFAULT_LANGUAGE_SWEEP_INTERVAL;
+    std::condition_variable sweepWake;
+    bool stopping = false;
+
+    // Called with mutex held. Released languages are ranked by how recently
+    // they were released; the warm ones are kept however long they were idle.
+    void unloadIdle(std::chrono::steady_clock::time_point now) {
+        std::vector<std::unordered_map<std::string, Entry>::iterator> released;
+        for (auto it = entries.begin(); it != entries.end(); ++it) {
+            if (it->second.handles == 0 && preloaded.count(it->first) == 0) {
+                released.push_back(it);
+            }
+        }
+        std::sort(released.begin(), released.end(), [](const auto& a, const auto& b) {
+            return a->second.lastReleased > b->second.lastReleased;
+        });
+        for (size_t i = warmLanguages; i < released.size(); ++i) {
+            if (now - released[i]->second.lastReleased >= idleTimeout) {
+                entries.erase(released[i]);
+            }
+        }
+    }
+};
+
+LanguageResourceRegistry& LanguageResourceRegistry::global() {
+    static LanguageResourceRegistry registry;
+    return registry;
+}
+
+LanguageResourceRegistry::LanguageResourceRegistry()
+    : m_state(std::make_shared<State>()) {
+    m_languageManager = std::make_shared<LanguageManager>();
+    m_sweeper = std::thread([this] { sweepIdle(); });
+}
+
+LanguageResourceRegistry::~LanguageResourceRegistry() {
+    {
+        std::lock_guard<std::mutex> lock(m_state->mutex);
+        m_state->stopping = true;
+    }
+    m_state->sweepWake.notify_all();
+    m_sweeper.join();
+}
+
+void LanguageResourceRegistry::sweepIdle() {
+    // Runs on m_sweeper until the registry is destroyed. A wake-up by
+    // setSweepInterval only sweeps early, which is harmless.
+    std::unique_lock<std::mutex> lock(m_state->mutex);
+    while (!m_state->stopping) {
+        m_state->sweepWake.wait_for(lock, m_state->sweepInterval);
+        if (m_state->stopping) {
+            break;
+        }
+        lock.unlock();
+        unloadIdle();
+        lock.lock();
+    }
+}
+
+void LanguageResourceRegistry::setSweepInterval(std::chrono::steady_clock::duration interval) {
+    {
+        std::lock_guard<std::mutex> lock(m_state->mutex);
+        m_state->sweepInterval = interval;
+    }
+    m_state->sweepWake.notify_all();
+}
+
+std::string LanguageResourceRegistry::defaultLanguage() const {
+    std::lock_guard<std::mutex> lock(m_state->mutex);
+    return m_languageManager->getDefaultLanguage();
+}
+
+std::shared_ptr<const LanguageResources> LanguageResourceRegistry::acquire(const std::string& languageCode) {
+    std::shared_ptr<LanguageResources> resources;
+    std::shared_future<std::shared_ptr<LanguageResources>> pending;
+    std::promise<std::shared_ptr<LanguageResources>> loaded;
+    bool loading = false;
+    {
+        std::lock_guard<std::mutex> lock(m_state->mutex);
+        m_state->unloadIdle(std::chrono::steady_clock::now());
+
+        // Take a handle on a loaded language, or join or start its load; the
+        // handles of a load are counted on the entry it becomes
+        auto entry = m_state->entries.find(languageCode);
+        if (entry != m_state->entries.end()) {
+            ++entry->second.handles;
+            resources = entry->second.resources;
+        } else {
+            auto load = m_state->loads.find(languageCode);
+            if (load == m_state->loads.end()) {
+                load = m_state->loads.emplace(languageCode, State::Load{loaded.get_future().share(), 0}).first;
+                loading = true;
+            }
+            ++load->second.handles;
+            pending = load->second.resources;
+        }
+    }
+
+    // Load the language without holding the registry, so other languages are
+    // acquired meanwhile. Only a successful load is entered; a failed one is
+    // forgotten and its exception reaches every caller waiting on it.
+    if (loading) {
+        try {
+            auto created = std::make_shared<LanguageResources>(languageCode);
+            std::lock_guard<std::mutex> lock(m_state->mutex);
+            created->setLanguageToolPoolSize(m_state->grammarPoolSize);
+            auto& entry = m_state->entries[languageCode];
+            entry.resources = created;
+            entry.handles = m_state->loads[languageCode].handles;
+            m_state->loads.erase(languageCode);
+            loaded.set_value(created);
+        } catch (...) {
+            {
+                std::lock_guard<std::mutex> lock(m_state->mutex);
+                m_state->loads.erase(languageCode);
+            }
+            loaded.set_exception(std::current_exception());
+        }
+    }
+    if (!resources) {
+        resources = pending.get();
+    }
+
+    // The handle releases its count when the last copy of it is dropped. The
+    // state is held weakly, so a handle may safely outlive the registry.
+    std::weak_ptr<State> state = m_state;
+    return std::shared_ptr<const LanguageResources>(resources.get(), [state, resources](const LanguageResources*) {
+        auto registry = state.lock();
+        if (!registry) {
+            return;
+        }
+        std::lock_guard<std::mutex> lock(registry->mutex);
+        auto entry = registry->entries.find(resources->languageCode());
+        if (entry != registry->entries.end() && entry->second.resources == resources && --entry->second.handles == 0) {
+            entry->second.lastReleased = std::chrono::steady_clock::now();
+            registry->unloadIdle(entry->second.lastReleased);
+        }
+    });
+}
+
+void LanguageResourceRegistry::setIdleTimeout(std::chrono::steady_clock::duration idleTimeout) {
+    std::lock_guard<std::mutex> lock(m_state->mutex);
+    m_state->idleTimeout = idleTimeout;
+    m_state->unloadIdle(std::chrono::steady_clock::now());
+}
+
+void LanguageResourceRegistry::setGrammarPoolSize(size_t poolSize) {
+    // Applies to loaded languages too; instances beyond a smaller size are
+    // kept until the language is unloaded
+    std::lock_guard<std::mutex> lock(m_state->mutex);
+    m_state->grammarPoolSize = std::max<size_t>(1, poolSize);
+    for (auto& entry : m_state->entries) {
+        entry.second.resources->setLanguageToolPoolSize(m_state->grammarPoolSize);
+    }
+}
+
+size_t LanguageResourceRegistry::grammarPoolSize() const {
+    std::lock_guard<std::mutex> lock(m_state->mutex);
+    return m_state->grammarPoolSize;
+}
+
+void LanguageResourceRegistry::setWarmLanguageCount(size_t count) {
+    std::lock_guard<std::mutex> lock(m_state->mutex);
+    m_state->warmLanguages = count;
+    m_state->unloadIdle(std::chrono::steady_clock::now());
+}
+
+void LanguageResourceRegistry::preloadLanguages(const std::vector<std::string>& languageCodes) {
+    // Languages no longer configured become ordinary released languages
+    {
+        std::lock_guard<std::mutex> lock(m_state->mutex);
+        m_state->preloaded = std::unordered_set<std::string>(languageCodes.begin(), languageCodes.end());
+        m_state->unloadIdle(std::chrono::steady_clock::now());
+    }
+
+    // Load each language and compile one LanguageTool instance up front; the
+    // handles are released right away, but preloaded languages stay loaded
+    for (const auto& languageCode : languageCodes) {
+        acquire(languageCode)->hasGrammarRules();
+    }
+}
+
+void LanguageResourceRegistry::unloadIdle() {
+    std::vector<std::shared_ptr<LanguageResources>> loaded;
+    {
+        std::lock_guard<std::mutex> lock(m_state->mutex);
+        m_state->unloadIdle(std::chrono::steady_clock::now());
+        for (const auto& entry : m_state->entries) {
+            loaded.push_back(entry.second.resources);
+        }
+    }
+
+    // Languages that stay loaded give back the instances a burst left idle
+    for (const auto& resources : loaded) {
+        resources->trimIdleInstances();
+    }
+}
+
+bool LanguageResourceRegistry::isLoaded(const std::string& languageCode) const {
+    std::lock_guard<std::mutex> lock(m_state->mutex);
+    return m_state->entries.count(languageCode) != 0;
+}
+
+std::vector<LanguageMemoryUsage> LanguageResourceRegistry::memoryReport() const {
+    // Copy the entries out so the per-language figures are gathered unlocked
+    std::vector<std::pair<std::shared_ptr<LanguageResources>, size_t>> loaded;
+    {
+        std::lock_guard<std::mutex> lock(m_state->mutex);
+        for (const auto& entry : m_state->entries) {
+            loaded.emplace_back(entry.second.resources, entry.second.handles);
+        }
+    }
+
+    std::vector<LanguageMemoryUsage> report;
+    for (const auto& language : loaded) {
+        LanguageMemoryUsage usage = language.first->memoryUsage();
+        usage.handles = language.second;
+        report.push_back(std::move(usage));
+    }
+    return report;
+}
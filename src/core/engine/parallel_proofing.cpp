@@ -0,0 +1,124 @@
+#include <string>
+#include <string_view>
+#include <vector>
+#include <memory>
+#include <mutex>
+#include <exception>
+#include <condition_variable>
+#include "parallel_proofing.h"
+#include "text_processing.h"
+#include "custom_dictionary.h"
+#include "text_segmentation.h"
+#include "work_stealing_pool.h"
+
+const size_t DEFAULT_MIN_SHARD_BYTES = 16 * 1024; // Paragraphs are grouped until a shard reaches this size
+
+namespace {
+
+// Splits the text after paragraph breaks into shards of at least minShardBytes.
+// Shards never split a paragraph, so no sentence or word spans two shards.
+std::vector<TextSegment> splitIntoShards(std::string_view text, size_t minShardBytes) {
+    std::vector<TextSegment> shards;
+
+    size_t shardStart = 0;
+    while (shardStart < text.size()) {
+        size_t shardEnd = shardStart;
+        while (shardEnd < text.size() && shardEnd - shardStart < minShardBytes) {
+            size_t paragraphEnd = text.find('\n', shardEnd);
+            shardEnd = paragraphEnd == std::string_view::npos ? text.size() : paragraphEnd + 1;
+        }
+        shards.push_back({text.substr(shardStart, shardEnd - shardStart), shardStart, shardEnd - shardStart});
+        shardStart = shardEnd;
+    }
+
+    return shards;
+}
+
+} // namespace
+
+ParallelProofing::ParallelProofing(size_t threadCount, size_t minShardBytes)
+    : m_minShardBytes(minShardBytes == 0 ? DEFAULT_MIN_SHARD_BYTES : minShardBytes) {
+    // Start the worker pool; a thread count of zero uses every hardware thread
+    m_pool = std::make_unique<WorkStealingPool>(threadCount);
+
+    // Hunspell and LanguageTool instances are not safe to share between
+    // threads, so each worker gets its own set of checkers. The custom
+    // dictionary is thread-safe and shared by all of them.
+    m_customDictionary = std::make_shared<CustomDictionary>();
+    for (size_t i = 0; i < m_pool->threadCount(); ++i) {
+        m_workerProcessors.push_back(std::make_shared<TextProcessing>());
+        m_workerProcessors.back()->setCustomDictionary(m_customDictionary);
+    }
+}
+
+ParallelProofing::~ParallelProofing() = default;
+
+ProofingResults ParallelProofing::proofDocument(const std::string& text) {
+    std::vector<TextSegment> shards = splitIntoShards(text, m_minShardBytes);
+    std::vector<ProofingResults> shardResults(shards.size());
+    std::vector<std::exception_ptr> shardErrors(shards.size());
+
+    std::mutex doneMutex;
+    std::condition_variable doneCondition;
+    size_t remainingShards = shards.size();
+
+    // Check each shard on whichever worker picks it up; results are written to
+    // the shard's own slot, so the merge below does not depend on scheduling
+    for (size_t i = 0; i < shards.size(); ++i) {
+        m_pool->submit([&, i](size_t workerIndex) {
+            try {
+                TextProcessing& processor = *m_workerProcessors[workerIndex];
+                size_t start = shards[i].offset;
+                size_t end = start + shards[i].length;
+                shardResults[i].spelling = processor.checkSpellingRange(text, start, end);
+                shardResults[i].grammar = processor.checkGrammarRange(text, start, end);
+            } catch (...) {
+                shardErrors[i] = std::current_exception();
+            }
+
+            std::lock_guard<std::mutex> lock(doneMutex);
+            if (--remainingShards == 0) {
+                doneCondition.notify_one();
+            }
+        });
+    }
+
+    {
+        std::unique_lock<std::mutex> lock(doneMutex);
+        doneCondition.wait(lock, [&] { return remainingShards == 0; });
+    }
+
+    // Report the first failure in document order
+    for (const auto& error : shardErrors) {
+        if (error) {
+            std::rethrow_exception(error);
+        }
+    }
+
+    // Merge in shard order; positions are already document offsets
+    ProofingResults results;
+    for (auto& shard : shardResults) {
+        results.spelling.insert(results.spelling.end(),
+                                std::make_move_iterator(shard.spelling.begin()), std::make_move_iterator(shard.spelling.end()));
+        results.grammar.insert(results.grammar.end(),
+                               std::make_move_iterator(shard.grammar.begin()), std::make_move_iterator(shard.grammar.end()));
+    }
+
+    return results;
+}
+
+bool ParallelProofing::addToCustomDictionary(const std::string& word) {
+    // Every worker sees the word through the shared dictionary
+    return m_customDictionary->addWord(word);
+}
+
+void ParallelProofing::setCustomDictionary(std::shared_ptr<CustomDictionary> dictionary) {
+    m_customDictionary = std::move(dictionary);
+    for (auto& processor : m_workerProcessors) {
+        processor->setCustomDictionary(m_customDictionary);
+    }
+}
+
+size_t ParallelProofing::threadCount() const {
+    return m_pool->threadCount();
+}
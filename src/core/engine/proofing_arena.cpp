@@ -0,0 +1,95 @@
+#include <memory>
+#include <memory_resource>
+#include <optional>
+#include <algorithm>
+#include <cstddef>
+#include "proofing_arena.h"
+
+const size_t DEFAULT_ARENA_BYTES = 256 * 1024;   // Initial buffer, enough for a few pages of tokens
+const size_t MAX_ARENA_BYTES = 64 * 1024 * 1024; // The buffer never grows past this between passes
+
+namespace {
+
+// Forwards to the global heap and records how much the arena had to take from
+// it, which is the amount a pass overflowed the arena's own buffer by
+class CountingUpstreamResource : public std::pmr::memory_resource {
+public:
+    size_t bytesAllocated() const { return m_bytesAllocated; }
+    void resetCount() { m_bytesAllocated = 0; }
+
+private:
+    void* do_allocate(size_t bytes, size_t alignment) override {
+        m_bytesAllocated += bytes;
+        return std::pmr::new_delete_resource()->allocate(bytes, alignment);
+    }
+
+    void do_deallocate(void* p, size_t bytes, size_t alignment) override {
+        std::pmr::new_delete_resource()->deallocate(p, bytes, alignment);
+    }
+
+    bool do_is_equal(const std::pmr::memory_resource& other) const noexcept override {
+        return this == &other;
+    }
+
+    size_t m_bytesAllocated = 0;
+};
+
+} // namespace
+
+ProofingArena::ProofingArena(size_t initialBytes)
+    : m_bufferSize(std::max<size_t>(initialBytes, 1024)),
+      m_buffer(std::make_unique<std::byte[]>(m_bufferSize)),
+      m_upstream(std::make_unique<CountingUpstreamResource>()) {
+    m_resource.emplace(m_buffer.get(), m_bufferSize, m_upstream.get());
+}
+
+ProofingArena::~ProofingArena() = default;
+
+std::pmr::memory_resource* ProofingArena::resource() {
+    return &*m_resource;
+}
+
+void ProofingArena::reset() {
+    auto& upstream = static_cast<CountingUpstreamResource&>(*m_upstream);
+    size_t overflowBytes = upstream.bytesAllocated();
+
+    // Drop everything allocated during the pass in one shot
+    m_resource->release();
+    upstream.resetCount();
+    m_peakBytes = std::max(m_peakBytes, m_bufferSize + overflowBytes);
+
+    // If the pass outgrew the buffer, grow it so that a similar pass next time
+    // is served without touching the global heap at all
+    if (overflowBytes > 0 && m_bufferSize < MAX_ARENA_BYTES) {
+        m_resource.reset();
+        m_bufferSize = std::min(MAX_ARENA_BYTES, m_bufferSize + overflowBytes);
+        m_buffer = std::make_unique<std::byte[]>(m_bufferSize);
+        m_resource.emplace(m_buffer.get(), m_bufferSize, m_upstream.get());
+    }
+}
+
+size_t ProofingArena::capacity() const {
+    return m_bufferSize;
+}
+
+size_t ProofingArena::peakBytes() const {
+    return m_peakBytes;
+}
+
+ProofingArena::Pass::Pass(ProofingArena* arena)
+    : m_arena(arena) {
+    if (m_arena) {
+        ++m_arena->m_passDepth;
+    }
+}
+
+ProofingArena::Pass::~Pass() {
+    // Only the outermost pass resets, so nested checks share one arena lifetime
+    if (m_arena && --m_arena->m_passDepth == 0) {
+        m_arena->reset();
+    }
+}
+
+std::pmr::memory_resource* arenaResource(ProofingArena* arena) {
+    return arena ? arena->resource() : std::pmr::get_default_resource();
+}
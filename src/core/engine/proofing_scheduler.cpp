@@ -0,0 +1,356 @@
+#include <string>
+#include <string_view>
+#include <vector>
+#include <set>
+#include <memory>
+#include <chrono>
+#include <algorithm>
+#include <iterator>
+#include <limits>
+#include "proofing_scheduler.h"
+#include "text_processing.h"
+
+// Proofing of a document is split into jobs: checking the spelling, then the
+// grammar, of one paragraph. The host runs them in time-boxed slices from its
+// idle loop, on the thread that owns the TextProcessing. Jobs are picked for
+// the paragraphs in the viewport first, then the paragraphs near it, then the
+// rest of the document, continuing forward from the viewport. Results are kept
+// relative to their paragraph, and the paragraphs an edit touches are re-split
+// and their queued jobs replaced.
+//
+// Paragraphs store only their length; their starts are prefix sums kept in a
+// Fenwick tree, so typing inside a paragraph updates one length instead of
+// shifting every later paragraph. The queue holds order IDs, which grow along
+// the document and leave gaps for paragraphs inserted later, so it only
+// changes for the paragraphs an edit touches. Edits that add or remove
+// paragraphs still move the later array entries and rebuild the tree, both in
+// one linear pass without allocating.
+const size_t NEARBY_VIEWPORTS = 2; // Paragraphs within this many viewport lengths are checked before the rest
+const uint64_t PARAGRAPH_ID_SPACING = 1ull << 32; // Gap between the order IDs of neighbouring paragraphs when relabelled
+
+struct ProofingScheduler::Paragraph {
+    uint64_t id = 0; // Order ID: increases along the document
+    size_t length = 0;
+    bool spellingPending = true;
+    bool grammarPending = true;
+    std::chrono::steady_clock::time_point queuedAt;
+
+    // Positions are relative to the paragraph start
+    std::vector<SpellingSuggestion> spelling;
+    std::vector<GrammarError> grammar;
+
+    size_t pendingJobs() const { return (spellingPending ? 1 : 0) + (grammarPending ? 1 : 0); }
+};
+
+ProofingScheduler::ProofingScheduler(std::shared_ptr<TextProcessing> processor)
+    : m_processor(std::move(processor)) {
+}
+
+ProofingScheduler::~ProofingScheduler() = default;
+
+void ProofingScheduler::setText(std::string text) {
+    // Every paragraph of a new text is queued; nothing of the old one survives
+    for (const auto& paragraph : m_paragraphs) {
+        m_cancelledJobs += paragraph.pendingJobs();
+    }
+    m_text = std::move(text);
+    m_paragraphs = splitParagraphs(0, m_text.size());
+    relabelParagraphs();
+    buildLengthTree();
+}
+
+const std::string& ProofingScheduler::text() const {
+    return m_text;
+}
+
+void ProofingScheduler::applyEdit(size_t offset, size_t removedLength, const std::string& insertedText) {
+    offset = std::min(offset, m_text.size());
+    removedLength = std::min(removedLength, m_text.size() - offset);
+    m_text.replace(offset, removedLength, insertedText);
+    std::ptrdiff_t delta = static_cast<std::ptrdiff_t>(insertedText.size()) - static_cast<std::ptrdiff_t>(removedLength);
+
+    // Find the paragraphs the edit touches, in offsets before the edit. An
+    // edit at the very end of the text touches the last paragraph.
+    size_t first = 0;
+    size_t last = 0;
+    size_t regionStart = 0;
+    size_t regionEnd = 0;
+    if (!m_paragraphs.empty()) {
+        first = paragraphAt(offset);
+        last = paragraphAt(offset + removedLength);
+        regionStart = paragraphStart(first);
+        regionEnd = paragraphStart(last) + m_paragraphs[last].length;
+    }
+    size_t after = m_paragraphs.empty() ? 0 : last + 1;
+
+    // Their queued jobs are for text that no longer exists
+    for (size_t i = first; i < after; ++i) {
+        m_cancelledJobs += m_paragraphs[i].pendingJobs();
+        m_pending.erase(m_paragraphs[i].id);
+    }
+
+    // Re-split the edited region; the paragraphs after it only move
+    std::vector<Paragraph> replacement = splitParagraphs(regionStart, static_cast<size_t>(static_cast<std::ptrdiff_t>(regionEnd) + delta));
+    if (replacement.size() == after - first) {
+        // Typing inside paragraphs keeps their count, IDs and array positions
+        for (size_t i = 0; i < replacement.size(); ++i) {
+            Paragraph& paragraph = m_paragraphs[first + i];
+            addLength(first + i, static_cast<std::ptrdiff_t>(replacement[i].length) - static_cast<std::ptrdiff_t>(paragraph.length));
+            replacement[i].id = paragraph.id;
+            paragraph = std::move(replacement[i]);
+        }
+    } else {
+        // New paragraphs take IDs from the gap between their neighbours
+        uint64_t previousId = first == 0 ? 0 : m_paragraphs[first - 1].id;
+        uint64_t nextId = after == m_paragraphs.size() ? std::numeric_limits<uint64_t>::max() : m_paragraphs[after].id;
+        uint64_t step = (nextId - previousId) / (replacement.size() + 1);
+        for (size_t i = 0; i < replacement.size(); ++i) {
+            replacement[i].id = previousId + step * (i + 1);
+        }
+        m_paragraphs.erase(m_paragraphs.begin() + first, m_paragraphs.begin() + after);
+        m_paragraphs.insert(m_paragraphs.begin() + first, std::make_move_iterator(replacement.begin()),
+                            std::make_move_iterator(replacement.end()));
+        buildLengthTree();
+
+        // Once repeated inserts at one place use up a gap, every paragraph is relabelled
+        if (step == 0) {
+            relabelParagraphs();
+            return;
+        }
+    }
+    for (size_t i = first; i < first + replacement.size(); ++i) {
+        m_pending.insert(m_paragraphs[i].id);
+    }
+}
+
+void ProofingScheduler::setViewport(size_t start, size_t end) {
+    m_viewportStart = start;
+    m_viewportEnd = std::max(start, end);
+}
+
+size_t ProofingScheduler::runSlice(std::chrono::steady_clock::duration budget) {
+    // Jobs are not interrupted, so a slice may overrun its budget by one job
+    auto sliceStart = std::chrono::steady_clock::now();
+    size_t jobs = 0;
+    while (std::chrono::steady_clock::now() - sliceStart < budget && runNextJob()) {
+        ++jobs;
+    }
+    return jobs;
+}
+
+bool ProofingScheduler::runNextJob() {
+    if (m_pending.empty()) {
+        return false;
+    }
+    runJob(pickNext());
+    return true;
+}
+
+bool ProofingScheduler::isIdle() const {
+    return m_pending.empty();
+}
+
+ProofingResults ProofingScheduler::results() const {
+    // Merge in document order, mapping positions back to document offsets
+    ProofingResults results;
+    size_t start = 0;
+    for (const auto& paragraph : m_paragraphs) {
+        for (auto suggestion : paragraph.spelling) {
+            suggestion.startPos += start;
+            suggestion.endPos += start;
+            results.spelling.push_back(std::move(suggestion));
+        }
+        for (auto error : paragraph.grammar) {
+            error.startPos += start;
+            error.endPos += start;
+            results.grammar.push_back(std::move(error));
+        }
+        start += paragraph.length;
+    }
+    return results;
+}
+
+ProofingScheduler::Stats ProofingScheduler::stats() const {
+    Stats stats;
+    for (uint64_t id : m_pending) {
+        size_t index = indexOf(id);
+        size_t jobs = m_paragraphs[index].pendingJobs();
+        switch (priorityOf(index)) {
+            case ProofingPriority::Visible: stats.queuedVisible += jobs; break;
+            case ProofingPriority::Nearby: stats.queuedNearby += jobs; break;
+            case ProofingPriority::Background: stats.queuedBackground += jobs; break;
+        }
+    }
+    stats.completedJobs = m_completedJobs;
+    stats.cancelledJobs = m_cancelledJobs;
+    if (m_completedJobs > 0) {
+        stats.meanLatency = m_totalLatency / m_completedJobs;
+    }
+    if (m_completedVisibleJobs > 0) {
+        stats.meanVisibleLatency = m_totalVisibleLatency / m_completedVisibleJobs;
+    }
+    stats.maxLatency = m_maxLatency;
+    stats.maxVisibleLatency = m_maxVisibleLatency;
+    return stats;
+}
+
+std::vector<ProofingScheduler::Paragraph> ProofingScheduler::splitParagraphs(size_t start, size_t end) const {
+    // Paragraphs end after their line break, as in ParallelProofing
+    std::vector<Paragraph> paragraphs;
+    auto now = std::chrono::steady_clock::now();
+    while (start < end) {
+        size_t lineBreak = m_text.find('\n', start);
+        size_t paragraphEnd = lineBreak == std::string::npos || lineBreak >= end ? end : lineBreak + 1;
+        Paragraph paragraph;
+        paragraph.length = paragraphEnd - start;
+        paragraph.queuedAt = now;
+        paragraphs.push_back(std::move(paragraph));
+        start = paragraphEnd;
+    }
+    return paragraphs;
+}
+
+size_t ProofingScheduler::paragraphAt(size_t position) const {
+    // The last paragraph starting at or before the position: descend the tree
+    // for the most paragraphs whose lengths add up to no more than it
+    size_t count = 0;
+    size_t step = 1;
+    while (step * 2 <= m_paragraphs.size()) {
+        step *= 2;
+    }
+    for (; step > 0; step /= 2) {
+        if (count + step <= m_paragraphs.size() && m_lengthTree[count + step] <= position) {
+            count += step;
+            position -= m_lengthTree[count];
+        }
+    }
+    return m_paragraphs.empty() ? 0 : std::min(count, m_paragraphs.size() - 1);
+}
+
+size_t ProofingScheduler::paragraphStart(size_t index) const {
+    size_t start = 0;
+    for (; index > 0; index -= index & (~index + 1)) {
+        start += m_lengthTree[index];
+    }
+    return start;
+}
+
+void ProofingScheduler::addLength(size_t index, std::ptrdiff_t delta) {
+    for (++index; index < m_lengthTree.size(); index += index & (~index + 1)) {
+        m_lengthTree[index] = static_cast<size_t>(static_cast<std::ptrdiff_t>(m_lengthTree[index]) + delta);
+    }
+}
+
+void ProofingScheduler::buildLengthTree() {
+    // Linear build: each node passes its sum on to its parent
+    m_lengthTree.assign(m_paragraphs.size() + 1, 0);
+    for (size_t i = 1; i < m_lengthTree.size(); ++i) {
+        m_lengthTree[i] += m_paragraphs[i - 1].length;
+        size_t parent = i + (i & (~i + 1));
+        if (parent < m_lengthTree.size()) {
+            m_lengthTree[parent] += m_lengthTree[i];
+        }
+    }
+}
+
+size_t ProofingScheduler::indexOf(uint64_t id) const {
+    auto it = std::lower_bound(m_paragraphs.begin(), m_paragraphs.end(), id,
+                               [](const Paragraph& paragraph, uint64_t value) { return paragraph.id < value; });
+    return static_cast<size_t>(std::distance(m_paragraphs.begin(), it));
+}
+
+void ProofingScheduler::relabelParagraphs() {
+    // Space the order IDs evenly again and queue every paragraph with work left
+    m_pending.clear();
+    for (size_t i = 0; i < m_paragraphs.size(); ++i) {
+        m_paragraphs[i].id = (i + 1) * PARAGRAPH_ID_SPACING;
+        if (m_paragraphs[i].pendingJobs() > 0) {
+            m_pending.insert(m_pending.end(), m_paragraphs[i].id);
+        }
+    }
+}
+
+size_t ProofingScheduler::distanceToViewport(size_t index) const {
+    // Zero for paragraphs overlapping the viewport, one for those touching it
+    size_t start = paragraphStart(index);
+    size_t end = start + m_paragraphs[index].length;
+    if (start >= m_viewportEnd) {
+        return start - m_viewportEnd + 1;
+    }
+    return end <= m_viewportStart ? m_viewportStart - end + 1 : 0;
+}
+
+ProofingPriority ProofingScheduler::priorityOf(size_t index) const {
+    // Without a viewport the document is checked in order
+    if (m_viewportEnd == m_viewportStart) {
+        return ProofingPriority::Background;
+    }
+    size_t distance = distanceToViewport(index);
+    if (distance == 0) {
+        return ProofingPriority::Visible;
+    }
+    return distance <= NEARBY_VIEWPORTS * (m_viewportEnd - m_viewportStart) ? ProofingPriority::Nearby : ProofingPriority::Background;
+}
+
+size_t ProofingScheduler::pickNext() const {
+    // The first pending paragraph from the top of the viewport is visible if
+    // any pending paragraph is
+    uint64_t top = m_paragraphs.empty() ? 0 : m_paragraphs[paragraphAt(m_viewportStart)].id;
+    auto after = m_pending.lower_bound(top);
+    size_t afterIndex = after == m_pending.end() ? m_paragraphs.size() : indexOf(*after);
+    if (after != m_pending.end() && priorityOf(afterIndex) == ProofingPriority::Visible) {
+        return afterIndex;
+    }
+
+    // Otherwise the closest pending paragraph on either side, if it is nearby
+    size_t closest = afterIndex;
+    if (after != m_pending.begin()) {
+        size_t beforeIndex = indexOf(*std::prev(after));
+        if (after == m_pending.end() || distanceToViewport(beforeIndex) < distanceToViewport(afterIndex)) {
+            closest = beforeIndex;
+        }
+    }
+    if (priorityOf(closest) == ProofingPriority::Nearby) {
+        return closest;
+    }
+
+    // Then the rest, continuing forward from the viewport and wrapping around
+    return after != m_pending.end() ? afterIndex : indexOf(*m_pending.begin());
+}
+
+void ProofingScheduler::runJob(size_t index) {
+    Paragraph& paragraph = m_paragraphs[index];
+    ProofingPriority priority = priorityOf(index);
+    size_t start = paragraphStart(index);
+
+    // Spelling first: it is cheaper and its squiggles are the most visible
+    if (paragraph.spellingPending) {
+        paragraph.spelling = m_processor->checkSpellingRange(m_text, start, start + paragraph.length);
+        for (auto& suggestion : paragraph.spelling) {
+            suggestion.startPos -= start;
+            suggestion.endPos -= start;
+        }
+        paragraph.spellingPending = false;
+    } else {
+        paragraph.grammar = m_processor->checkGrammarRange(m_text, start, start + paragraph.length);
+        for (auto& error : paragraph.grammar) {
+            error.startPos -= start;
+            error.endPos -= start;
+        }
+        paragraph.grammarPending = false;
+    }
+    if (paragraph.pendingJobs() == 0) {
+        m_pending.erase(paragraph.id);
+    }
+
+    // Latency runs from when the paragraph's text was queued to the job's end
+    auto latency = std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::steady_clock::now() - paragraph.queuedAt);
+    ++m_completedJobs;
+    m_totalLatency += latency;
+    m_maxLatency = std::max(m_maxLatency, latency);
+    if (priority == ProofingPriority::Visible) {
+        ++m_completedVisibleJobs;
+        m_totalVisibleLatency += latency;
+        m_maxVisibleLatency = std::max(m_maxVisibleLatency, latency);
+    }
+}
@@ -2,42 +2,200 @@
 #include <vector>
 #include <unordered_map>
 #include <memory>
-#include <hunspell/hunspell.hxx>
+#include <algorithm>
+#include <mutex>
+#include <atomic>
+#include <thread>
+#include <string_view>
 #include "spell_check.h"
-#include "language_manager.h"
+#include "language_resources.h"
 #include "custom_dictionary.h"
+#include "spell_verdict_cache.h"
+#include "symspell_index.h"
+#include "text_segmentation.h"
+#include "word_table.h"
+#include "work_stealing_pool.h"
 
 // Maximum number of spelling suggestions to return
 const int MAX_SUGGESTIONS = 5;
 
-SpellCheck::SpellCheck() {
-    // Initialize language manager
-    m_languageManager = std::make_shared<LanguageManager>();
+// Batches with fewer uncached words than this are checked on the calling thread
+const size_t PARALLEL_BATCH_THRESHOLD = 256;
+const size_t BATCH_CHUNK_WORDS = 64;
+const size_t MAX_BATCH_HELPERS = 3; // Each helper may hold its own Hunspell instance
+
+// Everything a check reads about the current language. A published state is
+// never modified: setLanguage and setSuggestionBackend build a new one and
+// swap it in atomically, so a check that already loaded the old state
+// finishes with it and the old resources are released by the last such check.
+struct SpellCheck::LanguageState {
+    std::string languageCode;
+    std::shared_ptr<const LanguageResources> resources;
+    std::unordered_map<std::string, SuggestionBackend> suggestionBackends;
+};
+
+namespace {
+
+// Helpers shared by every checker of the process, so batches from many
+// documents never start more than a few extra threads
+WorkStealingPool& batchPool() {
+    static WorkStealingPool pool(std::max<size_t>(1, std::min<size_t>(MAX_BATCH_HELPERS, std::thread::hardware_concurrency() - 1)));
+    return pool;
+}
+
+} // namespace
 
+SpellCheck::SpellCheck() {
     // Initialize custom dictionary
     m_customDictionary = std::make_shared<CustomDictionary>();
 
-    // Set default language
-    m_currentLanguage = m_languageManager->getDefaultLanguage();
+    // Verdicts are cached per language and custom dictionary state
+    m_verdictCache = std::make_shared<SpellVerdictCache>();
+
+    // Share the default language's dictionaries with every other checker
+    auto state = std::make_shared<LanguageState>();
+    state->languageCode = LanguageResourceRegistry::global().defaultLanguage();
+    state->resources = LanguageResourceRegistry::global().acquire(state->languageCode);
+    m_languageState = std::move(state);
+}
+
+SpellCheck::~SpellCheck() = default;
+
+std::shared_ptr<const SpellCheck::LanguageState> SpellCheck::languageState() const {
+    return std::atomic_load_explicit(&m_languageState, std::memory_order_acquire);
+}
 
-    // Initialize Hunspell with default language dictionary
-    std::string dictionaryPath = m_languageManager->getDictionaryPath(m_currentLanguage);
-    m_hunspell = std::make_shared<Hunspell>(dictionaryPath + ".aff", dictionaryPath + ".dic");
+void SpellCheck::publishLanguageState(std::shared_ptr<const LanguageState> state) {
+    std::atomic_store_explicit(&m_languageState, std::move(state), std::memory_order_release);
+}
+
+std::shared_ptr<CustomDictionary> SpellCheck::customDictionary() const {
+    return std::atomic_load_explicit(&m_customDictionary, std::memory_order_acquire);
+}
+
+void SpellCheck::setCustomDictionary(std::shared_ptr<CustomDictionary> dictionary) {
+    std::atomic_store_explicit(&m_customDictionary, std::move(dictionary), std::memory_order_release);
+    m_verdictCache->invalidate();
+}
+
+std::shared_ptr<CustomDictionary> SpellCheck::syncCustomDictionary() {
+    // The custom dictionary may be shared with other checkers, so words added
+    // through any of them must invalidate this checker's verdicts too
+    auto customDictionary = this->customDictionary();
+    uint64_t customVersion = customDictionary->version();
+    if (m_customDictionaryVersion.exchange(customVersion, std::memory_order_acq_rel) != customVersion) {
+        m_verdictCache->invalidate();
+    }
+    return customDictionary;
 }
 
 bool SpellCheck::checkWord(const std::string& word) {
-    // Check if the word is in the custom dictionary
-    if (m_customDictionary->contains(word)) {
-        return true;
+    auto customDictionary = syncCustomDictionary();
+
+    // Most words of a document repeat, so answer from the verdict cache when possible.
+    // The generation is read first so a concurrent invalidation discards this verdict.
+    uint64_t generation = m_verdictCache->generation();
+    bool verdict = false;
+    if (m_verdictCache->lookup(word, verdict)) {
+        return verdict;
     }
 
-    // Use Hunspell to check the word
-    return m_hunspell->spell(word);
+    // The language is loaded after the generation: a swap publishes the new
+    // language before invalidating, so a verdict for the old one is dropped
+    auto state = languageState();
+
+    // Check if the word is in the custom dictionary, then the language's shared
+    // compiled dictionary, which falls back to Hunspell for undecided words
+    verdict = customDictionary->contains(word) || state->resources->isCorrect(word);
+
+    m_verdictCache->store(generation, word, verdict);
+    return verdict;
+}
+
+std::vector<bool> SpellCheck::checkWords(const TextToken* tokens, size_t count) {
+    auto customDictionary = syncCustomDictionary();
+    uint64_t generation = m_verdictCache->generation();
+    auto state = languageState();
+
+    // Map every word token to its unique word: by ID when interned, by text otherwise
+    const size_t NOT_A_WORD = static_cast<size_t>(-1);
+    std::vector<size_t> uniqueIndex(count, NOT_A_WORD);
+    std::vector<std::string_view> uniqueWords;
+    std::vector<uint32_t> uniqueIds;
+    std::unordered_map<uint32_t, size_t> indexById;
+    std::unordered_map<std::string_view, size_t> indexByText;
+    for (size_t i = 0; i < count; ++i) {
+        const TextToken& token = tokens[i];
+        if (token.type != TokenType::Word) {
+            continue;
+        }
+        size_t index = token.wordId != INVALID_WORD_ID
+            ? indexById.emplace(token.wordId, uniqueWords.size()).first->second
+            : indexByText.emplace(token.text, uniqueWords.size()).first->second;
+        if (index == uniqueWords.size()) {
+            uniqueWords.push_back(token.text);
+            uniqueIds.push_back(token.wordId);
+        }
+        uniqueIndex[i] = index;
+    }
+
+    // Answer each unique word from the verdict cache or the custom dictionary,
+    // by ID when interned, and collect the rest for the language's dictionaries
+    std::vector<char> uniqueVerdicts(uniqueWords.size(), false);
+    std::vector<std::string> batchWords;
+    std::vector<size_t> batchIndex;
+    for (size_t i = 0; i < uniqueWords.size(); ++i) {
+        bool verdict = false;
+        if (m_verdictCache->lookup(uniqueWords[i], verdict)) {
+            uniqueVerdicts[i] = verdict;
+        } else if (uniqueIds[i] != INVALID_WORD_ID ? customDictionary->containsId(uniqueIds[i])
+                                                   : customDictionary->contains(uniqueWords[i])) {
+            uniqueVerdicts[i] = true;
+            m_verdictCache->store(generation, uniqueWords[i], true);
+        } else {
+            batchWords.emplace_back(uniqueWords[i]);
+            batchIndex.push_back(i);
+        }
+    }
+
+    // Check the remaining words, in chunks on the helper threads as well as
+    // this one when there are enough of them
+    std::vector<char> batchVerdicts(batchWords.size());
+    size_t chunkCount = (batchWords.size() + BATCH_CHUNK_WORDS - 1) / BATCH_CHUNK_WORDS;
+    size_t helpers = batchWords.size() >= PARALLEL_BATCH_THRESHOLD ? MAX_BATCH_HELPERS : 0;
+    batchPool().parallelFor(chunkCount, helpers, [&](size_t chunk) {
+        size_t end = std::min(batchWords.size(), (chunk + 1) * BATCH_CHUNK_WORDS);
+        for (size_t i = chunk * BATCH_CHUNK_WORDS; i < end; ++i) {
+            batchVerdicts[i] = state->resources->isCorrect(batchWords[i]);
+        }
+    });
+    for (size_t i = 0; i < batchIndex.size(); ++i) {
+        uniqueVerdicts[batchIndex[i]] = batchVerdicts[i];
+        m_verdictCache->store(generation, batchWords[i], batchVerdicts[i]);
+    }
+
+    // Scatter the verdicts back to every occurrence; other tokens are never misspelled
+    std::vector<bool> verdicts(count, true);
+    for (size_t i = 0; i < count; ++i) {
+        if (uniqueIndex[i] != NOT_A_WORD) {
+            verdicts[i] = uniqueVerdicts[uniqueIndex[i]];
+        }
+    }
+    return verdicts;
 }
 
 std::vector<std::string> SpellCheck::getSuggestions(const std::string& word) {
+    // Use the symmetric-delete index when it is selected for the current language
+    auto state = languageState();
+    auto backend = state->suggestionBackends.find(state->languageCode);
+    if (backend != state->suggestionBackends.end() && backend->second == SuggestionBackend::SymSpell) {
+        if (auto index = state->resources->symSpellIndex()) {
+            return index->lookup(word, MAX_SUGGESTIONS);
+        }
+    }
+
     // Use Hunspell to generate suggestions for the word
-    std::vector<std::string> suggestions = m_hunspell->suggest(word);
+    std::vector<std::string> suggestions = state->resources->suggest(word);
 
     // Limit the number of suggestions to MAX_SUGGESTIONS
     if (suggestions.size() > MAX_SUGGESTIONS) {
@@ -48,25 +206,55 @@ std::vector<std::string> SpellCheck::getSuggestions(const std::string& word) {
 }
 
 bool SpellCheck::setLanguage(const std::string& languageCode) {
-    // Get the dictionary path for the specified language
-    std::string dictionaryPath = m_languageManager->getDictionaryPath(languageCode);
+    // Get the shared resources of the specified language, loading them if no
+    // other checker uses the language yet
+    auto resources = LanguageResourceRegistry::global().acquire(languageCode);
+    if (resources->dictionaryPath().empty()) {
+        return false;
+    }
 
-    // Create a new Hunspell object with the dictionary files
-    std::shared_ptr<Hunspell> newHunspell = std::make_shared<Hunspell>(dictionaryPath + ".aff", dictionaryPath + ".dic");
+    // Publish a new state; concurrent checks are never blocked by the swap
+    std::lock_guard<std::mutex> lock(m_languageWriteMutex);
+    auto state = std::make_shared<LanguageState>(*languageState());
+    state->languageCode = languageCode;
+    state->resources = std::move(resources);
+    publishLanguageState(std::move(state));
 
-    // If successful, update m_currentLanguage and m_hunspell
-    if (newHunspell) {
-        m_currentLanguage = languageCode;
-        m_hunspell = newHunspell;
-        return true;
-    }
+    // Cached verdicts belong to the previous language
+    m_verdictCache->invalidate();
+    return true;
+}
 
-    return false;
+std::string SpellCheck::getLanguage() const {
+    return languageState()->languageCode;
 }
 
 bool SpellCheck::addToCustomDictionary(const std::string& word) {
-    // Call m_customDictionary to add the word
-    return m_customDictionary->addWord(word);
+    // The next check sees the dictionary's new version and drops the word's
+    // cached "misspelled" verdict
+    return customDictionary()->addWord(word);
+}
+
+void SpellCheck::setSuggestionBackend(const std::string& languageCode, SuggestionBackend backend) {
+    std::lock_guard<std::mutex> lock(m_languageWriteMutex);
+    auto state = std::make_shared<LanguageState>(*languageState());
+    state->suggestionBackends[languageCode] = backend;
+    publishLanguageState(std::move(state));
+}
+
+SuggestionBackend SpellCheck::getSuggestionBackend() const {
+    // The backend selected for the current language; Hunspell unless changed
+    auto state = languageState();
+    auto backend = state->suggestionBackends.find(state->languageCode);
+    return backend != state->suggestionBackends.end() ? backend->second : SuggestionBackend::Hunspell;
+}
+
+void SpellCheck::setVerdictCacheBudget(size_t memoryBudgetBytes) {
+    m_verdictCache->setMemoryBudget(memoryBudgetBytes);
+}
+
+SpellVerdictCache::Stats SpellCheck::getVerdictCacheStats() const {
+    return m_verdictCache->stats();
 }
 
 std::string normalizeWord(const std::string& word) {
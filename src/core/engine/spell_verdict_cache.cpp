@@ -0,0 +1,133 @@
+#include <string>
+#include <string_view>
+#include <list>
+#include <unordered_map>
+#include <vector>
+#include <memory>
+#include <mutex>
+#include <atomic>
+#include <cstdint>
+#include "spell_verdict_cache.h"
+#include "word_table.h"
+
+// Bounded cache of spelling verdicts. Entries are spread over shards by word
+// hash so concurrent checkers rarely contend, and each shard evicts its least
+// recently used words once it exceeds its share of the memory budget.
+const size_t DEFAULT_VERDICT_CACHE_BYTES = 4 * 1024 * 1024;
+const size_t VERDICT_CACHE_SHARDS = 16;
+const size_t VERDICT_ENTRY_OVERHEAD = 96; // List node, map node and string header, approximately
+
+namespace {
+
+struct WordViewHash {
+    size_t operator()(std::string_view word) const { return static_cast<size_t>(hashWord(word)); }
+};
+
+} // namespace
+
+struct SpellVerdictCache::Shard {
+    struct Node {
+        std::string word;
+        bool verdict;
+    };
+
+    std::mutex mutex;
+    std::list<Node> recency; // Most recently used at the front
+    std::unordered_map<std::string_view, std::list<Node>::iterator, WordViewHash> index;
+    size_t bytes = 0;
+};
+
+SpellVerdictCache::SpellVerdictCache(size_t memoryBudgetBytes)
+    : m_memoryBudgetBytes(memoryBudgetBytes) {
+    for (size_t i = 0; i < VERDICT_CACHE_SHARDS; ++i) {
+        m_shards.push_back(std::make_unique<Shard>());
+    }
+}
+
+SpellVerdictCache::~SpellVerdictCache() = default;
+
+uint64_t SpellVerdictCache::generation() const {
+    return m_generation.load(std::memory_order_acquire);
+}
+
+bool SpellVerdictCache::lookup(std::string_view word, bool& verdict) {
+    Shard& shard = shardFor(word);
+    std::lock_guard<std::mutex> lock(shard.mutex);
+
+    auto it = shard.index.find(word);
+    if (it == shard.index.end()) {
+        m_misses.fetch_add(1, std::memory_order_relaxed);
+        return false;
+    }
+
+    // Move the entry to the front so frequent words survive eviction
+    shard.recency.splice(shard.recency.begin(), shard.recency, it->second);
+    verdict = it->second->verdict;
+    m_hits.fetch_add(1, std::memory_order_relaxed);
+    return true;
+}
+
+void SpellVerdictCache::store(uint64_t generation, std::string_view word, bool verdict) {
+    size_t entryBytes = word.size() + VERDICT_ENTRY_OVERHEAD;
+    size_t shardBudget = m_memoryBudgetBytes.load(std::memory_order_relaxed) / VERDICT_CACHE_SHARDS;
+    if (entryBytes > shardBudget) {
+        return;
+    }
+
+    Shard& shard = shardFor(word);
+    std::lock_guard<std::mutex> lock(shard.mutex);
+
+    // A verdict computed before the last invalidation belongs to an old
+    // language or dictionary and must not be cached
+    if (generation != m_generation.load(std::memory_order_acquire)) {
+        return;
+    }
+    if (shard.index.find(word) != shard.index.end()) {
+        return;
+    }
+
+    shard.recency.push_front({std::string(word), verdict});
+    shard.index.emplace(shard.recency.front().word, shard.recency.begin());
+    shard.bytes += entryBytes;
+
+    // Evict least recently used words until the shard fits its budget again
+    while (shard.bytes > shardBudget) {
+        const auto& victim = shard.recency.back();
+        shard.bytes -= victim.word.size() + VERDICT_ENTRY_OVERHEAD;
+        shard.index.erase(victim.word);
+        shard.recency.pop_back();
+    }
+}
+
+void SpellVerdictCache::invalidate() {
+    // Bump the generation before clearing, so a verdict computed concurrently
+    // against the old state is rejected by store() rather than re-inserted
+    m_generation.fetch_add(1, std::memory_order_acq_rel);
+    for (auto& shard : m_shards) {
+        std::lock_guard<std::mutex> lock(shard->mutex);
+        shard->index.clear();
+        shard->recency.clear();
+        shard->bytes = 0;
+    }
+}
+
+void SpellVerdictCache::setMemoryBudget(size_t memoryBudgetBytes) {
+    m_memoryBudgetBytes.store(memoryBudgetBytes, std::memory_order_relaxed);
+    invalidate();
+}
+
+SpellVerdictCache::Stats SpellVerdictCache::stats() const {
+    Stats stats;
+    stats.hits = m_hits.load(std::memory_order_relaxed);
+    stats.misses = m_misses.load(std::memory_order_relaxed);
+    for (const auto& shard : m_shards) {
+        std::lock_guard<std::mutex> lock(shard->mutex);
+        stats.entries += shard->index.size();
+        stats.bytes += shard->bytes;
+    }
+    return stats;
+}
+
+SpellVerdictCache::Shard& SpellVerdictCache::shardFor(std::string_view word) {
+    return *m_shards[hashWord(word) % VERDICT_CACHE_SHARDS];
+}
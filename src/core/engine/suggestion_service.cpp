@@ -0,0 +1,274 @@
+#include <string>
+#include <vector>
+#include <list>
+#include <map>
+#include <unordered_map>
+#include <memory>
+#include <mutex>
+#include <future>
+#include <chrono>
+#include "suggestion_service.h"
+#include "spell_check.h"
+#include "work_stealing_pool.h"
+
+// Suggestions are computed on a background pool so that the editing thread
+// never waits for Hunspell::suggest. Each worker owns its own SpellCheck,
+// since a Hunspell instance must not be used from two threads at once.
+// Documents get their service from shared(), so every document of a language
+// and suggestion backend uses one pool and one cache, however many are open.
+const size_t DEFAULT_SUGGESTION_CACHE_ENTRIES = 2048;
+const size_t DEFAULT_SUGGESTION_THREADS = 1;
+
+struct SuggestionService::PendingRequest {
+    std::string word;
+    uint64_t generation = 0;
+    std::promise<std::vector<std::string>> promise;
+    std::shared_future<std::vector<std::string>> future = promise.get_future().share();
+    size_t interest = 0; // Handles still waiting; guarded by m_mutex
+    bool started = false;
+    bool dropped = false; // Cancelled before it started; already resolved
+    bool prefetch = false;
+};
+
+SuggestionRequest::SuggestionRequest(std::shared_future<std::vector<std::string>> future,
+                                     std::weak_ptr<SuggestionService::PendingRequest> pending,
+                                     SuggestionService* service)
+    : m_future(std::move(future)), m_pending(std::move(pending)), m_service(service) {
+}
+
+const std::shared_future<std::vector<std::string>>& SuggestionRequest::future() const {
+    return m_future;
+}
+
+bool SuggestionRequest::isReady() const {
+    return m_future.valid() && m_future.wait_for(std::chrono::seconds(0)) == std::future_status::ready;
+}
+
+bool SuggestionRequest::cancel() {
+    // Only the first cancel of a handle releases its interest
+    auto pending = m_pending.lock();
+    m_pending.reset();
+    return pending && m_service && m_service->release(pending);
+}
+
+SuggestionService::SuggestionService(const std::string& languageCode, size_t threadCount, size_t cacheCapacity,
+                                     SuggestionBackend backend)
+    : m_languageCode(languageCode),
+      m_backend(backend),
+      m_cacheCapacity(cacheCapacity) {
+    // Create one checker per worker before the workers can pick up tasks
+    size_t workers = threadCount == 0 ? DEFAULT_SUGGESTION_THREADS : threadCount;
+    for (size_t i = 0; i < workers; ++i) {
+        m_checkers.push_back({std::make_unique<SpellCheck>(), 0});
+        if (!languageCode.empty()) {
+            m_checkers.back().checker->setLanguage(languageCode);
+        }
+        m_checkers.back().checker->setSuggestionBackend(m_checkers.back().checker->getLanguage(), backend);
+    }
+    m_pool = std::make_unique<WorkStealingPool>(workers);
+}
+
+std::shared_ptr<SuggestionService> SuggestionService::shared(const std::string& languageCode, SuggestionBackend backend) {
+    // One service per language and backend, kept while a document holds it
+    static std::mutex sharedMutex;
+    static std::map<std::pair<std::string, SuggestionBackend>, std::weak_ptr<SuggestionService>> sharedServices;
+
+    std::lock_guard<std::mutex> lock(sharedMutex);
+    auto key = std::make_pair(languageCode, backend);
+    if (auto service = sharedServices[key].lock()) {
+        return service;
+    }
+    for (auto it = sharedServices.begin(); it != sharedServices.end();) {
+        it = it->second.expired() && it->first != key ? sharedServices.erase(it) : std::next(it);
+    }
+    auto service = std::make_shared<SuggestionService>(languageCode, DEFAULT_SUGGESTION_THREADS,
+                                                       DEFAULT_SUGGESTION_CACHE_ENTRIES, backend);
+    sharedServices[key] = service;
+    return service;
+}
+
+SuggestionService::~SuggestionService() {
+    // Queued tasks still run while the pool joins, but only to resolve their
+    // futures; nobody is left to read the suggestions
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        m_stopping = true;
+    }
+    m_pool.reset();
+}
+
+SuggestionRequest SuggestionService::requestSuggestions(const std::string& word) {
+    std::lock_guard<std::mutex> lock(m_mutex);
+
+    // Answer from the cache without touching the pool
+    auto cached = m_cacheIndex.find(word);
+    if (cached != m_cacheIndex.end()) {
+        ++m_cacheHits;
+        m_cache.splice(m_cache.begin(), m_cache, cached->second);
+        std::promise<std::vector<std::string>> ready;
+        ready.set_value(cached->second->second);
+        return SuggestionRequest(ready.get_future().share(), {}, this);
+    }
+    ++m_cacheMisses;
+
+    // Join a request already in flight for the same word
+    auto pending = m_inFlight.find(word);
+    if (pending != m_inFlight.end()) {
+        ++pending->second->interest;
+        return SuggestionRequest(pending->second->future, pending->second, this);
+    }
+
+    auto request = startRequest(word, false);
+    return SuggestionRequest(request->future, request, this);
+}
+
+void SuggestionService::prefetch(const std::vector<std::string>& words) {
+    std::lock_guard<std::mutex> lock(m_mutex);
+
+    // Prefetched words are held by the service itself, so cancelling a handle
+    // for the same word later never drops them
+    for (const auto& word : words) {
+        if (m_cacheIndex.count(word) || m_inFlight.count(word)) {
+            continue;
+        }
+        startRequest(word, true);
+    }
+}
+
+bool SuggestionService::cachedSuggestions(const std::string& word, std::vector<std::string>& suggestions) {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    auto cached = m_cacheIndex.find(word);
+    if (cached == m_cacheIndex.end()) {
+        return false;
+    }
+    m_cache.splice(m_cache.begin(), m_cache, cached->second);
+    suggestions = cached->second->second;
+    return true;
+}
+
+void SuggestionService::setLanguage(const std::string& languageCode) {
+    std::lock_guard<std::mutex> lock(m_mutex);
+
+    // Workers switch their own checker before their next task; results still
+    // being computed for the old language are not cached. Shared services
+    // stay on the language they are keyed by.
+    m_languageCode = languageCode;
+    ++m_generation;
+    m_cache.clear();
+    m_cacheIndex.clear();
+}
+
+SuggestionService::Stats SuggestionService::stats() const {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    Stats stats;
+    stats.cacheHits = m_cacheHits;
+    stats.cacheMisses = m_cacheMisses;
+    stats.cancelled = m_cancelled;
+    stats.inFlight = m_inFlight.size();
+    stats.cachedWords = m_cache.size();
+    return stats;
+}
+
+std::shared_ptr<SuggestionService::PendingRequest> SuggestionService::startRequest(const std::string& word, bool prefetch) {
+    // Called with m_mutex held
+    auto request = std::make_shared<PendingRequest>();
+    request->word = word;
+    request->generation = m_generation;
+    request->interest = 1;
+    request->prefetch = prefetch;
+    m_inFlight.emplace(word, request);
+
+    m_pool->submit([this, request](size_t workerIndex) { run(request, workerIndex); });
+    return request;
+}
+
+void SuggestionService::run(const std::shared_ptr<PendingRequest>& request, size_t workerIndex) {
+    std::string languageCode;
+    uint64_t generation;
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+
+        // Everyone who asked has moved on and release resolved the request,
+        // so skip the expensive part
+        if (request->dropped) {
+            return;
+        }
+        if (m_stopping) {
+            request->promise.set_value({});
+            return;
+        }
+        request->started = true;
+        languageCode = m_languageCode;
+        generation = m_generation;
+    }
+
+    // Only this worker touches its checker, so switching language here is safe
+    WorkerChecker& worker = m_checkers[workerIndex];
+    if (worker.generation != generation) {
+        worker.checker->setLanguage(languageCode);
+        worker.checker->setSuggestionBackend(languageCode, m_backend);
+        worker.generation = generation;
+    }
+
+    std::vector<std::string> suggestions;
+    try {
+        suggestions = worker.checker->getSuggestions(request->word);
+    } catch (...) {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        eraseInFlight(request);
+        request->promise.set_exception(std::current_exception());
+        return;
+    }
+
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        eraseInFlight(request);
+        if (request->generation == m_generation) {
+            storeInCache(request->word, suggestions);
+        }
+    }
+    request->promise.set_value(std::move(suggestions));
+}
+
+bool SuggestionService::release(const std::shared_ptr<PendingRequest>& request) {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    if (request->interest == 0) {
+        return false;
+    }
+
+    // A request nobody waits for any more is dropped before it starts and
+    // resolves right away without suggestions; once started it finishes and
+    // its result is cached for the next time
+    if (--request->interest != 0 || request->started) {
+        return false;
+    }
+    ++m_cancelled;
+    request->dropped = true;
+    eraseInFlight(request);
+    request->promise.set_value({});
+    return true;
+}
+
+void SuggestionService::eraseInFlight(const std::shared_ptr<PendingRequest>& request) {
+    // Called with m_mutex held. A cancelled word may have been requested again
+    // since, so only the entry for this very request is removed.
+    auto it = m_inFlight.find(request->word);
+    if (it != m_inFlight.end() && it->second == request) {
+        m_inFlight.erase(it);
+    }
+}
+
+void SuggestionService::storeInCache(const std::string& word, const std::vector<std::string>& suggestions) {
+    // Called with m_mutex held
+    if (m_cacheCapacity == 0 || m_cacheIndex.count(word)) {
+        return;
+    }
+    m_cache.emplace_front(word, suggestions);
+    m_cacheIndex[word] = m_cache.begin();
+
+    // Evict the least recently used words beyond the capacity
+    while (m_cache.size() > m_cacheCapacity) {
+        m_cacheIndex.erase(m_cache.back().first);
+        m_cache.pop_back();
+    }
+}
@@ -0,0 +1,509 @@
+#include <string>
+#include <string_view>
+#include <vector>
+#include <unordered_set>
+#include <memory>
+#include <fstream>
+#include <sstream>
+#include <algorithm>
+#include <functional>
+#include <filesystem>
+#include <cstdint>
+#include <cstring>
+#include "symspell_index.h"
+
+// Symmetric-delete suggestion index. Every dictionary word is stored under the
+// hashes of all strings obtained by deleting up to maxEditDistance characters
+// from its first prefixLength characters. A misspelling generates the same
+// deletes of itself, so every word within the edit distance shares at least
+// one key with it and only those few candidates need a real distance check.
+// Candidates are ranked by distance, then by corpus frequency.
+//
+// Keys are 64-bit hashes rather than the delete strings themselves: a collision
+// only adds a candidate that the distance check then rejects.
+const char SYMSPELL_INDEX_MAGIC[8] = {'W', 'S', 'Y', 'M', 'S', 'P', 'L', 'X'};
+const uint32_t SYMSPELL_INDEX_VERSION = 1;
+const uint32_t DEFAULT_SYMSPELL_EDIT_DISTANCE = 2;
+const uint32_t DEFAULT_SYMSPELL_PREFIX_LENGTH = 7;
+const size_t MAX_SYMSPELL_WORD_LENGTH = 64;
+
+namespace {
+
+struct IndexHeader {
+    char magic[8];
+    uint32_t version;
+    uint32_t maxEditDistance;
+    uint32_t prefixLength;
+    uint32_t wordCount;
+    uint64_t keyCount;
+    uint64_t postingCount;
+    uint64_t wordPoolSize;
+};
+
+// Helper function to decode one UTF-8 code point, treating malformed bytes as themselves
+char32_t decodeCodePoint(std::string_view text, size_t& pos) {
+    unsigned char lead = static_cast<unsigned char>(text[pos]);
+    size_t length = lead < 0x80 ? 1 : (lead >> 5) == 0x6 ? 2 : (lead >> 4) == 0xE ? 3 : (lead >> 3) == 0x1E ? 4 : 1;
+    if (pos + length > text.size()) {
+        length = 1;
+    }
+    char32_t codePoint = length == 1 ? lead : lead & (0x7F >> length);
+    for (size_t i = 1; i < length; ++i) {
+        unsigned char next = static_cast<unsigned char>(text[pos + i]);
+        if ((next & 0xC0) != 0x80) {
+            ++pos;
+            return lead;
+        }
+        codePoint = (codePoint << 6) | (next & 0x3F);
+    }
+    pos += length;
+    return codePoint;
+}
+
+void encodeCodePoint(char32_t codePoint, std::string& out) {
+    if (codePoint < 0x80) {
+        out.push_back(static_cast<char>(codePoint));
+    } else if (codePoint < 0x800) {
+        out.push_back(static_cast<char>(0xC0 | (codePoint >> 6)));
+        out.push_back(static_cast<char>(0x80 | (codePoint & 0x3F)));
+    } else if (codePoint < 0x10000) {
+        out.push_back(static_cast<char>(0xE0 | (codePoint >> 12)));
+        out.push_back(static_cast<char>(0x80 | ((codePoint >> 6) & 0x3F)));
+        out.push_back(static_cast<char>(0x80 | (codePoint & 0x3F)));
+    } else {
+        out.push_back(static_cast<char>(0xF0 | (codePoint >> 18)));
+        out.push_back(static_cast<char>(0x80 | ((codePoint >> 12) & 0x3F)));
+        out.push_back(static_cast<char>(0x80 | ((codePoint >> 6) & 0x3F)));
+        out.push_back(static_cast<char>(0x80 | (codePoint & 0x3F)));
+    }
+}
+
+// Lowercase mapping for the scripts of the shipped dictionaries: Latin, Greek
+// and Cyrillic. Other code points are left as they are.
+char32_t toLower(char32_t c) {
+    if ((c >= 'A' && c <= 'Z') || (c >= 0xC0 && c <= 0xDE && c != 0xD7) ||
+        (c >= 0x391 && c <= 0x3AB && c != 0x3A2) || (c >= 0x410 && c <= 0x42F)) {
+        return c + 0x20;
+    }
+    if (c >= 0x400 && c <= 0x40F) {
+        return c + 0x50;
+    }
+    if (c >= 0x100 && c <= 0x17F && c != 0x130 && c != 0x138 && c != 0x149 && c != 0x178) {
+        bool evenIsUpper = !(c >= 0x139 && c <= 0x148) && !(c >= 0x179 && c <= 0x17E);
+        return ((c % 2 == 0) == evenIsUpper) ? c + 1 : c;
+    }
+    return c;
+}
+
+char32_t toUpper(char32_t c) {
+    if ((c >= 'a' && c <= 'z') || (c >= 0xE0 && c <= 0xFE && c != 0xF7) ||
+        (c >= 0x3B1 && c <= 0x3CB && c != 0x3C2) || (c >= 0x430 && c <= 0x44F)) {
+        return c - 0x20;
+    }
+    if (c >= 0x450 && c <= 0x45F) {
+        return c - 0x50;
+    }
+    if (c >= 0x100 && c <= 0x17F && toLower(c - 1) == c) {
+        return c - 1;
+    }
+    return c;
+}
+
+std::u32string foldWord(std::string_view word) {
+    std::u32string folded;
+    for (size_t pos = 0; pos < word.size();) {
+        folded.push_back(toLower(decodeCodePoint(word, pos)));
+    }
+    return folded;
+}
+
+uint64_t hashDelete(const char32_t* text, size_t length) {
+    // FNV-1a over the code points; the same hash is stored in the index file
+    uint64_t hash = 14695981039346656037ULL;
+    for (size_t i = 0; i < length; ++i) {
+        hash ^= static_cast<uint64_t>(text[i]);
+        hash *= 1099511628211ULL;
+    }
+    return hash;
+}
+
+// Helper function to collect the hashes of every string obtained by deleting
+// up to maxDeletes code points from the word
+void collectDeletes(const std::u32string& word, uint32_t maxDeletes, std::unordered_set<uint64_t>& hashes) {
+    std::vector<std::u32string> frontier = {word};
+    hashes.insert(hashDelete(word.data(), word.size()));
+    std::unordered_set<std::u32string> seen;
+    for (uint32_t depth = 0; depth < maxDeletes; ++depth) {
+        std::vector<std::u32string> next;
+        for (const auto& candidate : frontier) {
+            if (candidate.size() <= 1) {
+                continue;
+            }
+            for (size_t i = 0; i < candidate.size(); ++i) {
+                std::u32string shorter = candidate.substr(0, i) + candidate.substr(i + 1);
+                if (seen.insert(shorter).second) {
+                    hashes.insert(hashDelete(shorter.data(), shorter.size()));
+                    next.push_back(std::move(shorter));
+                }
+            }
+        }
+        frontier = std::move(next);
+    }
+}
+
+// Optimal string alignment distance (Damerau-Levenshtein without repeated
+// edits of a substring), giving up once it exceeds maxDistance
+uint32_t editDistance(const std::u32string& a, const std::u32string& b, uint32_t maxDistance) {
+    size_t lengthDifference = a.size() > b.size() ? a.size() - b.size() : b.size() - a.size();
+    if (lengthDifference > maxDistance) {
+        return maxDistance + 1;
+    }
+
+    std::vector<uint32_t> previousPrevious(b.size() + 1), previous(b.size() + 1), current(b.size() + 1);
+    for (size_t j = 0; j <= b.size(); ++j) {
+        previous[j] = static_cast<uint32_t>(j);
+    }
+    for (size_t i = 1; i <= a.size(); ++i) {
+        current[0] = static_cast<uint32_t>(i);
+        uint32_t rowMinimum = current[0];
+        for (size_t j = 1; j <= b.size(); ++j) {
+            uint32_t cost = a[i - 1] == b[j - 1] ? 0 : 1;
+            current[j] = std::min({previous[j] + 1, current[j - 1] + 1, previous[j - 1] + cost});
+            if (i > 1 && j > 1 && a[i - 1] == b[j - 2] && a[i - 2] == b[j - 1]) {
+                current[j] = std::min(current[j], previousPrevious[j - 2] + 1);
+            }
+            rowMinimum = std::min(rowMinimum, current[j]);
+        }
+        if (rowMinimum > maxDistance) {
+            return maxDistance + 1;
+        }
+        std::swap(previousPrevious, previous);
+        std::swap(previous, current);
+    }
+    return previous[b.size()];
+}
+
+// Helper function to give a suggestion the capitalisation of the misspelling:
+// "Teh" suggests "The" and "TEH" suggests "THE"
+std::string matchCapitalisation(std::string_view misspelling, const std::string& suggestion) {
+    std::vector<char32_t> original;
+    for (size_t pos = 0; pos < misspelling.size();) {
+        original.push_back(decodeCodePoint(misspelling, pos));
+    }
+    bool firstUpper = !original.empty() && toLower(original[0]) != original[0];
+    if (!firstUpper) {
+        return suggestion;
+    }
+    bool allUpper = original.size() > 1 && std::all_of(original.begin(), original.end(), [](char32_t c) {
+        return toUpper(c) == c;
+    });
+
+    std::string result;
+    size_t index = 0;
+    for (size_t pos = 0; pos < suggestion.size(); ++index) {
+        char32_t c = decodeCodePoint(suggestion, pos);
+        encodeCodePoint(index == 0 || allUpper ? toUpper(c) : c, result);
+    }
+    return result;
+}
+
+} // namespace
+
+SymSpellIndex::SymSpellIndex(uint32_t maxEditDistance, uint32_t prefixLength)
+    : m_maxEditDistance(maxEditDistance),
+      m_prefixLength(std::max(prefixLength, maxEditDistance + 1)) {
+}
+
+void SymSpellIndex::addWord(std::string_view word, uint64_t frequency) {
+    // Words are collected first and indexed together in finalize()
+    if (word.empty() || word.size() > MAX_SYMSPELL_WORD_LENGTH) {
+        return;
+    }
+    m_pendingWords.emplace_back(std::string(word), frequency);
+}
+
+void SymSpellIndex::finalize() {
+    // Merge duplicate words, keeping their highest frequency
+    std::sort(m_pendingWords.begin(), m_pendingWords.end());
+    for (size_t i = 0; i < m_pendingWords.size(); ++i) {
+        const auto& entry = m_pendingWords[i];
+        if (i > 0 && m_pendingWords[i - 1].first == entry.first) {
+            m_frequencies.back() = std::max(m_frequencies.back(), entry.second);
+            continue;
+        }
+        m_words.push_back(static_cast<uint32_t>(m_wordPool.size()));
+        m_wordPool += entry.first;
+        m_frequencies.push_back(entry.second);
+    }
+    m_words.push_back(static_cast<uint32_t>(m_wordPool.size()));
+    m_pendingWords.clear();
+    m_pendingWords.shrink_to_fit();
+
+    // Generate the deletes of every word's prefix as (hash, word) postings
+    std::vector<std::pair<uint64_t, uint32_t>> postings;
+    std::unordered_set<uint64_t> hashes;
+    for (uint32_t id = 0; id < wordCount(); ++id) {
+        std::u32string folded = foldWord(wordAt(id));
+        folded.resize(std::min<size_t>(folded.size(), m_prefixLength));
+        hashes.clear();
+        collectDeletes(folded, m_maxEditDistance, hashes);
+        for (uint64_t hash : hashes) {
+            postings.emplace_back(hash, id);
+        }
+    }
+    std::sort(postings.begin(), postings.end());
+
+    // Group the postings by key into a sorted key array with offsets
+    m_keys.clear();
+    m_keyOffsets.clear();
+    m_postings.clear();
+    m_postings.reserve(postings.size());
+    for (const auto& posting : postings) {
+        if (m_keys.empty() || m_keys.back() != posting.first) {
+            m_keys.push_back(posting.first);
+            m_keyOffsets.push_back(static_cast<uint32_t>(m_postings.size()));
+        }
+        m_postings.push_back(posting.second);
+    }
+    m_keyOffsets.push_back(static_cast<uint32_t>(m_postings.size()));
+}
+
+std::vector<std::string> SymSpellIndex::lookup(std::string_view word, size_t maxSuggestions) const {
+    std::vector<std::string> suggestions;
+    std::u32string folded = foldWord(word);
+    if (folded.empty() || word.size() > MAX_SYMSPELL_WORD_LENGTH || wordCount() == 0) {
+        return suggestions;
+    }
+
+    // Generate the same deletes for the misspelling and gather their postings
+    std::u32string prefix = folded.substr(0, m_prefixLength);
+    std::unordered_set<uint64_t> hashes;
+    collectDeletes(prefix, m_maxEditDistance, hashes);
+
+    std::vector<uint32_t> candidates;
+    for (uint64_t hash : hashes) {
+        auto key = std::lower_bound(m_keys.begin(), m_keys.end(), hash);
+        if (key == m_keys.end() || *key != hash) {
+            continue;
+        }
+        size_t index = static_cast<size_t>(key - m_keys.begin());
+        candidates.insert(candidates.end(), m_postings.begin() + m_keyOffsets[index],
+                          m_postings.begin() + m_keyOffsets[index + 1]);
+    }
+    std::sort(candidates.begin(), candidates.end());
+    candidates.erase(std::unique(candidates.begin(), candidates.end()), candidates.end());
+
+    // Verify each candidate on the full words and rank the survivors
+    struct Ranked {
+        uint32_t distance;
+        uint64_t frequency;
+        uint32_t id;
+    };
+    std::vector<Ranked> ranked;
+    for (uint32_t id : candidates) {
+        uint32_t distance = editDistance(folded, foldWord(wordAt(id)), m_maxEditDistance);
+        if (distance <= m_maxEditDistance) {
+            ranked.push_back({distance, m_frequencies[id], id});
+        }
+    }
+    std::sort(ranked.begin(), ranked.end(), [](const Ranked& a, const Ranked& b) {
+        if (a.distance != b.distance) {
+            return a.distance < b.distance;
+        }
+        return a.frequency != b.frequency ? a.frequency > b.frequency : a.id < b.id;
+    });
+
+    for (const auto& candidate : ranked) {
+        if (suggestions.size() >= maxSuggestions) {
+            break;
+        }
+        std::string suggestion = matchCapitalisation(word, std::string(wordAt(candidate.id)));
+        if (suggestion != word && std::find(suggestions.begin(), suggestions.end(), suggestion) == suggestions.end()) {
+            suggestions.push_back(std::move(suggestion));
+        }
+    }
+    return suggestions;
+}
+
+size_t SymSpellIndex::wordCount() const {
+    return m_words.empty() ? 0 : m_words.size() - 1;
+}
+
+size_t SymSpellIndex::memoryBytes() const {
+    return m_wordPool.size() + m_words.size() * sizeof(uint32_t) + m_frequencies.size() * sizeof(uint64_t) +
+           m_keys.size() * sizeof(uint64_t) + m_keyOffsets.size() * sizeof(uint32_t) +
+           m_postings.size() * sizeof(uint32_t);
+}
+
+std::string_view SymSpellIndex::wordAt(uint32_t id) const {
+    return std::string_view(m_wordPool).substr(m_words[id], m_words[id + 1] - m_words[id]);
+}
+
+bool SymSpellIndex::save(const std::string& path) const {
+    // Write to a temporary file first so a reader never sees a partial index
+    std::string temporaryPath = path + ".tmp";
+    {
+        std::ofstream file(temporaryPath, std::ios::binary | std::ios::trunc);
+        if (!file) {
+            return false;
+        }
+
+        IndexHeader header = {};
+        std::memcpy(header.magic, SYMSPELL_INDEX_MAGIC, sizeof(header.magic));
+        header.version = SYMSPELL_INDEX_VERSION;
+        header.maxEditDistance = m_maxEditDistance;
+        header.prefixLength = m_prefixLength;
+        header.wordCount = static_cast<uint32_t>(wordCount());
+        header.keyCount = m_keys.size();
+        header.postingCount = m_postings.size();
+        header.wordPoolSize = m_wordPool.size();
+
+        auto write = [&file](const void* data, size_t bytes) {
+            file.write(static_cast<const char*>(data), static_cast<std::streamsize>(bytes));
+        };
+        write(&header, sizeof(header));
+        write(m_words.data(), m_words.size() * sizeof(uint32_t));
+        write(m_frequencies.data(), m_frequencies.size() * sizeof(uint64_t));
+        write(m_keys.data(), m_keys.size() * sizeof(uint64_t));
+        write(m_keyOffsets.data(), m_keyOffsets.size() * sizeof(uint32_t));
+        write(m_postings.data(), m_postings.size() * sizeof(uint32_t));
+        write(m_wordPool.data(), m_wordPool.size());
+        if (!file) {
+            return false;
+        }
+    }
+    // std::filesystem::rename replaces an existing index on Windows as well
+    std::error_code error;
+    std::filesystem::rename(temporaryPath, path, error);
+    if (error) {
+        std::filesystem::remove(temporaryPath, error);
+        return false;
+    }
+    return true;
+}
+
+std::shared_ptr<SymSpellIndex> SymSpellIndex::load(const std::string& path) {
+    std::ifstream file(path, std::ios::binary);
+    if (!file) {
+        return nullptr;
+    }
+
+    IndexHeader header;
+    if (!file.read(reinterpret_cast<char*>(&header), sizeof(header)) ||
+        std::memcmp(header.magic, SYMSPELL_INDEX_MAGIC, sizeof(header.magic)) != 0 ||
+        header.version != SYMSPELL_INDEX_VERSION) {
+        return nullptr;
+    }
+
+    // Refuse section sizes that the file cannot hold before allocating them
+    file.seekg(0, std::ios::end);
+    uint64_t fileSize = static_cast<uint64_t>(file.tellg());
+    uint64_t expectedSize = sizeof(header) + (uint64_t(header.wordCount) + 1) * sizeof(uint32_t) +
+                            uint64_t(header.wordCount) * sizeof(uint64_t) + header.keyCount * sizeof(uint64_t) +
+                            (header.keyCount + 1) * sizeof(uint32_t) + header.postingCount * sizeof(uint32_t) +
+                            header.wordPoolSize;
+    if (header.keyCount > fileSize || header.postingCount > fileSize || header.wordPoolSize > fileSize ||
+        expectedSize != fileSize || header.maxEditDistance == 0) {
+        return nullptr;
+    }
+    file.seekg(sizeof(header));
+
+    auto index = std::make_shared<SymSpellIndex>(header.maxEditDistance, header.prefixLength);
+    index->m_words.resize(header.wordCount + 1);
+    index->m_frequencies.resize(header.wordCount);
+    index->m_keys.resize(header.keyCount);
+    index->m_keyOffsets.resize(header.keyCount + 1);
+    index->m_postings.resize(header.postingCount);
+    index->m_wordPool.resize(header.wordPoolSize);
+
+    auto read = [&file](void* data, size_t bytes) {
+        file.read(static_cast<char*>(data), static_cast<std::streamsize>(bytes));
+    };
+    read(index->m_words.data(), index->m_words.size() * sizeof(uint32_t));
+    read(index->m_frequencies.data(), index->m_frequencies.size() * sizeof(uint64_t));
+    read(index->m_keys.data(), index->m_keys.size() * sizeof(uint64_t));
+    read(index->m_keyOffsets.data(), index->m_keyOffsets.size() * sizeof(uint32_t));
+    read(index->m_postings.data(), index->m_postings.size() * sizeof(uint32_t));
+    read(&index->m_wordPool[0], index->m_wordPool.size());
+    if (!file) {
+        return nullptr;
+    }
+
+    // Every offset must stay inside its section for lookups to be safe
+    for (size_t i = 0; i + 1 < index->m_words.size(); ++i) {
+        if (index->m_words[i] > index->m_words[i + 1] || index->m_words[i + 1] > header.wordPoolSize) {
+            return nullptr;
+        }
+    }
+    for (size_t i = 0; i + 1 < index->m_keyOffsets.size(); ++i) {
+        if (index->m_keyOffsets[i] > index->m_keyOffsets[i + 1] || index->m_keyOffsets[i + 1] > header.postingCount) {
+            return nullptr;
+        }
+    }
+    for (uint32_t id : index->m_postings) {
+        if (id >= header.wordCount) {
+            return nullptr;
+        }
+    }
+    return index;
+}
+
+std::shared_ptr<SymSpellIndex> SymSpellIndex::loadCached(const std::string& dictionaryPath) {
+    // The index cached next to a dictionary is current only when it is newer
+    // than both files it is built from and was built with today's parameters
+    std::error_code error;
+    auto indexTime = std::filesystem::last_write_time(dictionaryPath + ".symspell", error);
+    if (error || std::filesystem::last_write_time(dictionaryPath + ".dic", error) > indexTime || error) {
+        return nullptr;
+    }
+    auto frequencyTime = std::filesystem::last_write_time(dictionaryPath + ".freq", error);
+    if (!error && frequencyTime > indexTime) {
+        return nullptr;
+    }
+
+    auto index = load(dictionaryPath + ".symspell");
+    if (!index || index->m_maxEditDistance != DEFAULT_SYMSPELL_EDIT_DISTANCE ||
+        index->m_prefixLength != DEFAULT_SYMSPELL_PREFIX_LENGTH) {
+        return nullptr;
+    }
+    return index;
+}
+
+std::shared_ptr<SymSpellIndex> SymSpellIndex::buildFromDictionary(const std::string& dictionaryPath,
+                                                                  const std::function<bool(const std::string&)>& isCorrect) {
+    auto index = std::make_shared<SymSpellIndex>();
+
+    // Stems from the .dic file, without their affix flags; the first line is the entry count
+    std::ifstream dic(dictionaryPath + ".dic", std::ios::binary);
+    if (!dic) {
+        return nullptr;
+    }
+    std::string line;
+    std::getline(dic, line);
+    while (std::getline(dic, line)) {
+        size_t end = line.find_first_of("/\t \r");
+        std::string stem = line.substr(0, end);
+        if (!stem.empty()) {
+            index->addWord(stem, 1);
+        }
+    }
+
+    // Inflected forms and their ranking come from the optional frequency list,
+    // one "word count" pair per line, filtered through the spell checker
+    std::ifstream frequencies(dictionaryPath + ".freq", std::ios::binary);
+    while (frequencies && std::getline(frequencies, line)) {
+        std::istringstream fields(line);
+        std::string word;
+        uint64_t count = 0;
+        if (!(fields >> word)) {
+            continue;
+        }
+        fields >> count;
+        if (!isCorrect || isCorrect(word)) {
+            index->addWord(word, count + 1);
+        }
+    }
+
+    index->finalize();
+    return index;
+}
@@ -1,14 +1,56 @@
 #include <string>
+#include <string_view>
 #include <vector>
 #include <unordered_map>
 #include <memory>
+#include <memory_resource>
+#include <algorithm>
+#include <iterator>
+#include <cstddef>
+#include <optional>
 #include "text_processing.h"
 #include "spell_check.h"
 #include "grammar_check.h"
 #include "auto_correct.h"
+#include "text_segmentation.h"
+#include "char_classifier.h"
+#include "proofing_arena.h"
+#include "word_table.h"
+#include "suggestion_service.h"
+#include "custom_dictionary.h"
 
 const int MAX_PARAGRAPH_LENGTH = 1000; // Maximum number of characters in a paragraph
 
+namespace {
+
+// Converts a position after an edit back to the position it had before it
+size_t shiftBack(size_t position, std::ptrdiff_t delta) {
+    return static_cast<size_t>(static_cast<std::ptrdiff_t>(position) - delta);
+}
+
+// Replaces the cached results inside an edited window with freshly computed
+// ones and moves the results after it by the edit's length change. Cached
+// results are sorted by start position; the window start is not moved by the
+// edit, and oldWindowEnd is the window end before the edit was applied.
+template <typename Result>
+void spliceResults(std::vector<Result>& cached, size_t windowStart, size_t oldWindowEnd,
+                   std::ptrdiff_t delta, std::vector<Result> fresh) {
+    auto first = std::partition_point(cached.begin(), cached.end(),
+                                      [&](const Result& result) { return static_cast<size_t>(result.startPos) < windowStart; });
+    auto last = std::partition_point(first, cached.end(),
+                                     [&](const Result& result) { return static_cast<size_t>(result.startPos) < oldWindowEnd; });
+
+    for (auto it = last; it != cached.end(); ++it) {
+        it->startPos += delta;
+        it->endPos += delta;
+    }
+
+    first = cached.erase(first, last);
+    cached.insert(first, std::make_move_iterator(fresh.begin()), std::make_move_iterator(fresh.end()));
+}
+
+} // namespace
+
 TextProcessing::TextProcessing() {
     // Initialize spell checker
     m_spellChecker = std::make_shared<SpellCheck>();
@@ -19,19 +61,27 @@ TextProcessing::TextProcessing() {
     // Initialize auto-correct
     m_autoCorrect = std::make_shared<AutoCorrect>();
 
-    // Load custom dictionary from file or database
-    // TODO: Implement loading of custom dictionary
+    // Intermediate data of each proofing pass comes from one arena that is
+    // released in one shot when the pass ends
+    m_arena = std::make_shared<ProofingArena>();
+    m_grammarChecker->setProofingArena(m_arena);
+
+    // Start with the spell checker's in-memory custom dictionary; the host
+    // replaces it with the user's file through setCustomDictionary
+    m_customDictionary = m_spellChecker->customDictionary();
 }
 
 std::string TextProcessing::processText(std::string text) {
+    ProofingArena::Pass pass(m_arena.get());
+
     // Apply auto-correct to the input text
     applyAutoCorrect(text);
 
-    // Check spelling of the text
-    auto spellingErrors = checkSpelling(text);
-
-    // Check grammar of the text
-    auto grammarErrors = checkGrammar(text);
+    // Check spelling and grammar of the whole text, and keep the results so
+    // that later edits only need to re-proof the range they touch
+    m_proofedText = text;
+    m_proofingResults.spelling = checkSpelling(m_proofedText);
+    m_proofingResults.grammar = checkGrammar(m_proofedText);
 
     // Combine and apply suggestions from spell check and grammar check
     // TODO: Implement logic to combine and apply suggestions
@@ -40,101 +90,195 @@ std::string TextProcessing::processText(std::string text) {
     return text;
 }
 
+const ProofingResults& TextProcessing::processEdit(size_t offset, size_t removedLength, const std::string& insertedText) {
+    ProofingArena::Pass pass(m_arena.get());
+
+    // Clamp the edit to the text proofed so far and apply it
+    offset = std::min(offset, m_proofedText.size());
+    removedLength = std::min(removedLength, m_proofedText.size() - offset);
+    m_proofedText.replace(offset, removedLength, insertedText);
+
+    std::ptrdiff_t delta = static_cast<std::ptrdiff_t>(insertedText.size()) - static_cast<std::ptrdiff_t>(removedLength);
+    size_t editEnd = offset + insertedText.size();
+
+    // Re-check spelling of the whitespace-delimited words touching the edit
+    size_t wordStart = offset;
+    while (wordStart > 0 && classifyCharacter(static_cast<unsigned char>(m_proofedText[wordStart - 1])) != CharClass::Whitespace) {
+        --wordStart;
+    }
+    size_t wordEnd = editEnd;
+    while (wordEnd < m_proofedText.size() && classifyCharacter(static_cast<unsigned char>(m_proofedText[wordEnd])) != CharClass::Whitespace) {
+        ++wordEnd;
+    }
+    spliceResults(m_proofingResults.spelling, wordStart, shiftBack(wordEnd, delta), delta,
+                  checkSpellingRange(m_proofedText, wordStart, wordEnd));
+
+    // Re-check grammar of the sentences touching the edit and of their
+    // neighbours. Sentence boundaries can move when terminators or the letters
+    // after them are typed or deleted, splitting a sentence before or after the
+    // edited one off a sentence whose cached errors no longer apply, so the
+    // sentences are re-split from the start of the enclosing paragraph.
+    size_t paragraphStart = offset == 0 ? std::string::npos : m_proofedText.rfind('\n', offset - 1);
+    paragraphStart = paragraphStart == std::string::npos ? 0 : paragraphStart + 1;
+    size_t paragraphEnd = m_proofedText.find('\n', editEnd);
+    paragraphEnd = paragraphEnd == std::string::npos ? m_proofedText.size() : paragraphEnd + 1;
+
+    std::string_view paragraph = std::string_view(m_proofedText).substr(paragraphStart, paragraphEnd - paragraphStart);
+    auto sentences = splitIntoSentences(paragraph, arenaResource(m_arena.get()), m_grammarChecker->getLanguage());
+    size_t firstTouched = sentences.size();
+    size_t lastTouched = 0;
+    for (size_t i = 0; i < sentences.size(); ++i) {
+        size_t start = paragraphStart + sentences[i].offset;
+        size_t end = start + sentences[i].length;
+        if (end >= offset && start <= editEnd) {
+            firstTouched = std::min(firstTouched, i);
+            lastTouched = i;
+        }
+    }
+    size_t sentenceStart = editEnd;
+    size_t sentenceEnd = offset;
+    if (firstTouched < sentences.size()) {
+        const auto& first = sentences[firstTouched == 0 ? 0 : firstTouched - 1];
+        const auto& last = sentences[std::min(lastTouched + 1, sentences.size() - 1)];
+        sentenceStart = paragraphStart + first.offset;
+        sentenceEnd = paragraphStart + last.offset + last.length;
+    }
+    if (sentenceStart > sentenceEnd) {
+        // Nothing left around the edit, e.g. the whole paragraph was deleted
+        sentenceStart = offset;
+        sentenceEnd = editEnd;
+    }
+    spliceResults(m_proofingResults.grammar, sentenceStart, shiftBack(sentenceEnd, delta), delta,
+                  checkGrammarRange(m_proofedText, sentenceStart, sentenceEnd));
+
+    return m_proofingResults;
+}
+
 std::vector<SpellingSuggestion> TextProcessing::checkSpelling(const std::string& text) {
+    return checkSpellingRange(text, 0, text.size());
+}
+
+std::vector<SpellingSuggestion> TextProcessing::checkSpellingRange(const std::string& text, size_t start, size_t end) {
+    ProofingArena::Pass pass(m_arena.get());
     std::vector<SpellingSuggestion> suggestions;
-    auto tokens = tokenizeText(text);
+    auto tokens = tokenizeText(std::string_view(text).substr(start, end - start), arenaResource(m_arena.get()),
+                               WordTable::global());
+
+    // Check the whole range as one batch, so each distinct word is looked up
+    // once however often it occurs
+    std::vector<bool> verdicts = m_spellChecker->checkWords(tokens.data(), tokens.size());
 
-    for (const auto& word : tokens) {
-        // Check if the word is in the custom dictionary
-        if (m_customDictionary.find(word) != m_customDictionary.end()) {
+    for (size_t i = 0; i < tokens.size(); ++i) {
+        if (verdicts[i]) {
             continue;
         }
-
-        // Use spell checker to check the word
-        auto wordSuggestions = m_spellChecker->checkWord(word);
-        if (!wordSuggestions.empty()) {
-            suggestions.insert(suggestions.end(), wordSuggestions.begin(), wordSuggestions.end());
+        const TextToken& token = tokens[i];
+        SpellingSuggestion suggestion;
+        suggestion.word = std::string(token.text);
+        suggestion.startPos = start + token.offset;
+        suggestion.endPos = start + token.offset + token.length;
+        // Hunspell::suggest is far too slow for the editing thread, so only
+        // suggestions that are already cached are attached here; the rest
+        // are fetched asynchronously through requestSuggestions
+        if (m_suggestionService) {
+            suggestionService().cachedSuggestions(suggestion.word, suggestion.suggestions);
         }
+        suggestions.push_back(std::move(suggestion));
     }
 
     return suggestions;
 }
 
-std::vector<GrammarSuggestion> TextProcessing::checkGrammar(const std::string& text) {
-    std::vector<GrammarSuggestion> suggestions;
-    
-    // Split the input text into sentences
-    // TODO: Implement sentence splitting logic
+std::vector<GrammarError> TextProcessing::checkGrammar(const std::string& text) {
+    return checkGrammarRange(text, 0, text.size());
+}
 
-    for (const auto& sentence : sentences) {
-        // Use grammar checker to check the sentence
-        auto sentenceSuggestions = m_grammarChecker->checkSentence(sentence);
-        suggestions.insert(suggestions.end(), sentenceSuggestions.begin(), sentenceSuggestions.end());
+std::vector<GrammarError> TextProcessing::checkGrammarRange(const std::string& text, size_t start, size_t end) {
+    // The grammar checker fans the range's sentences out across threads and
+    // returns their errors in order, relative to the range
+    std::vector<GrammarError> errors = m_grammarChecker->checkParagraph(std::string_view(text).substr(start, end - start));
+    for (auto& error : errors) {
+        error.startPos += start;
+        error.endPos += start;
     }
 
-    return suggestions;
+    return errors;
 }
 
 void TextProcessing::applyAutoCorrect(std::string& text) {
-    auto tokens = tokenizeText(text);
-
-    for (auto& word : tokens) {
-        // Apply auto-correct rules using m_autoCorrect
-        std::string correctedWord = m_autoCorrect->correct(word);
-        if (correctedWord != word) {
-            // Replace the original word with the corrected version in the text
-            // TODO: Implement word replacement logic
-        }
-    }
+    // Apply auto-correct rules using m_autoCorrect, which matches every rule,
+    // including multi-word ones, in a single pass over the text
+    m_autoCorrect->applyAutoCorrect(text);
 }
 
-bool TextProcessing::addToCustomDictionary(const std::string& word) {
-    // Check if the word already exists in m_customDictionary
-    if (m_customDictionary.find(word) != m_customDictionary.end()) {
-        return false;
-    }
-
-    // Add the word to m_customDictionary
-    m_customDictionary[word] = word;
+std::optional<AutoCorrectReplacement> TextProcessing::typeCharacter(char c) {
+    // Auto-correct as the user types: the editor feeds each typed character
+    // and applies the replacement, if any, before the character just typed
+    return m_autoCorrect->typeCharacter(c);
+}
 
-    // Save the updated custom dictionary to file or database
-    // TODO: Implement saving of custom dictionary
+void TextProcessing::resetTyping() {
+    m_autoCorrect->resetTyping();
+}
 
-    return true;
+SuggestionRequest TextProcessing::requestSuggestions(const std::string& word) {
+    return suggestionService().requestSuggestions(word);
 }
 
-std::vector<std::string> tokenizeText(const std::string& text) {
-    std::vector<std::string> tokens;
-    std::string currentToken;
-
-    for (char c : text) {
-        if (std::isalnum(c) || c == '\'') {
-            // Add character to current token if it's alphanumeric or apostrophe
-            currentToken += c;
-        } else {
-            // Add current token to tokens if it's not empty
-            if (!currentToken.empty()) {
-                tokens.push_back(currentToken);
-                currentToken.clear();
-            }
-            // Add punctuation or whitespace as a separate token
-            if (!std::isspace(c)) {
-                tokens.push_back(std::string(1, c));
-            }
+void TextProcessing::prefetchSuggestions(size_t visibleStart, size_t visibleEnd) {
+    // Queue the misspellings the user can currently see, so their suggestions
+    // are cached by the time a context menu is opened on one of them
+    std::vector<std::string> words;
+    for (const auto& misspelling : m_proofingResults.spelling) {
+        if (static_cast<size_t>(misspelling.endPos) > visibleStart && static_cast<size_t>(misspelling.startPos) < visibleEnd) {
+            words.push_back(misspelling.word);
         }
     }
+    if (!words.empty()) {
+        suggestionService().prefetch(words);
+    }
+}
 
-    // Add the last token if it's not empty
-    if (!currentToken.empty()) {
-        tokens.push_back(currentToken);
+SuggestionService& TextProcessing::suggestionService() {
+    // Started on first use, so documents that never ask for suggestions do
+    // not pay for it. Documents share the service of their language and
+    // suggestion backend, and move to another one when either changes.
+    std::string languageCode = m_spellChecker->getLanguage();
+    SuggestionBackend backend = m_spellChecker->getSuggestionBackend();
+    if (!m_suggestionService || m_suggestionLanguage != languageCode || m_suggestionBackend != backend) {
+        m_suggestionService = SuggestionService::shared(languageCode, backend);
+        m_suggestionLanguage = languageCode;
+        m_suggestionBackend = backend;
     }
+    return *m_suggestionService;
+}
+
+bool TextProcessing::setLanguage(const std::string& languageCode) {
+    // Switch every checker of the document; the host proofs the text again
+    // with processText afterwards
+    if (!m_spellChecker->setLanguage(languageCode)) {
+        return false;
+    }
+    m_grammarChecker->setLanguage(languageCode);
+    m_autoCorrect->loadLanguageSpecificRules(languageCode);
+    return true;
+}
+
+void TextProcessing::setSuggestionBackend(const std::string& languageCode, SuggestionBackend backend) {
+    m_spellChecker->setSuggestionBackend(languageCode, backend);
+}
+
+bool TextProcessing::addToCustomDictionary(const std::string& word) {
+    // The dictionary appends the word to its journal file, if it has one
+    return m_customDictionary->addWord(word);
+}
 
-    return tokens;
+void TextProcessing::setCustomDictionary(std::shared_ptr<CustomDictionary> dictionary) {
+    // Documents share one dictionary per file (see CustomDictionary::open),
+    // so a large glossary is loaded and held once per process
+    m_spellChecker->setCustomDictionary(dictionary);
+    m_customDictionary = std::move(dictionary);
 }
 
 // Human tasks:
-// 1. Implement loading of custom dictionary in the constructor
-// 2. Implement logic to combine and apply suggestions in processText function
-// 3. Implement sentence splitting logic in checkGrammar function
-// 4. Implement word replacement logic in applyAutoCorrect function
-// 5. Implement saving of custom dictionary in addToCustomDictionary function
\ No newline at end of file
+// 1. Implement logic to combine and apply suggestions in processText function
\ No newline at end of file
@@ -0,0 +1,613 @@
+#include <string>
+#include <string_view>
+#include <vector>
+#include <memory_resource>
+#include <array>
+#include <cstdint>
+#include <algorithm>
+#include <iterator>
+#include <cctype>
+#include "text_segmentation.h"
+#include "char_classifier.h"
+#include "word_table.h"
+
+// Word and sentence segmentation following the default boundary rules of
+// Unicode Standard Annex #29. Property lookups use the run table generated by
+// src/scripts/generate_unicode_tables.py; ASCII input is classified through a
+// 128-entry table and letter/digit runs are skipped with the SIMD kernels.
+namespace {
+
+enum class WordBreak : uint8_t {
+    Other, CR, LF, Newline, Extend, ZWJ, RegionalIndicator, Format, Katakana, HebrewLetter,
+    ALetter, SingleQuote, DoubleQuote, MidNumLet, MidLetter, MidNum, Numeric, ExtendNumLet,
+    WSegSpace, ExtendedPictographic
+};
+
+enum class SentenceBreak : uint8_t {
+    Other, CR, LF, Extend, Sep, Format, Sp, Lower, Upper, OLetter, Numeric, ATerm, SContinue,
+    STerm, Close
+};
+
+enum class ContentClass : uint8_t { None, Word, NoSpaceScript };
+
+#include "unicode_break_tables.inc"
+
+struct BreakProperties {
+    WordBreak word;
+    SentenceBreak sentence;
+    ContentClass content;
+};
+
+BreakProperties unpackProperties(uint32_t run) {
+    return {static_cast<WordBreak>((run >> 6) & 0x1F),
+            static_cast<SentenceBreak>((run >> 2) & 0xF),
+            static_cast<ContentClass>(run & 0x3)};
+}
+
+BreakProperties lookupRunTable(char32_t cp) {
+    // Find the last run that starts at or before the code point
+    const uint32_t* end = BREAK_PROPERTY_RUNS + sizeof(BREAK_PROPERTY_RUNS) / sizeof(BREAK_PROPERTY_RUNS[0]);
+    const uint32_t* run = std::upper_bound(BREAK_PROPERTY_RUNS, end, (static_cast<uint32_t>(cp) << 11) | 0x7FFu);
+    return unpackProperties(*(run - 1));
+}
+
+std::array<BreakProperties, 128> buildAsciiProperties() {
+    std::array<BreakProperties, 128> table{};
+    for (char32_t cp = 0; cp < 128; ++cp) {
+        table[cp] = lookupRunTable(cp);
+    }
+    return table;
+}
+
+const std::array<BreakProperties, 128>& asciiProperties() {
+    static const std::array<BreakProperties, 128> table = buildAsciiProperties();
+    return table;
+}
+
+// Decodes the code point at pos and its properties. Malformed or truncated
+// sequences decode as U+FFFD spanning a single byte so segmentation always advances.
+struct DecodedChar {
+    BreakProperties props;
+    size_t length;
+};
+
+DecodedChar decodeAt(std::string_view text, size_t pos) {
+    unsigned char lead = static_cast<unsigned char>(text[pos]);
+    if (lead < 0x80) {
+        return {asciiProperties()[lead], 1};
+    }
+
+    size_t length = lead >= 0xF0 ? 4 : lead >= 0xE0 ? 3 : lead >= 0xC2 ? 2 : 0;
+    if (length == 0 || lead > 0xF4 || pos + length > text.size()) {
+        return {lookupRunTable(0xFFFD), 1};
+    }
+
+    char32_t cp = lead & (0x7F >> length);
+    for (size_t i = 1; i < length; ++i) {
+        unsigned char trail = static_cast<unsigned char>(text[pos + i]);
+        if ((trail & 0xC0) != 0x80) {
+            return {lookupRunTable(0xFFFD), 1};
+        }
+        cp = (cp << 6) | (trail & 0x3F);
+    }
+
+    // Reject overlong encodings, surrogates and values past U+10FFFF
+    static const char32_t MIN_FOR_LENGTH[] = {0, 0, 0x80, 0x800, 0x10000};
+    if (cp < MIN_FOR_LENGTH[length] || (cp >= 0xD800 && cp <= 0xDFFF) || cp > 0x10FFFF) {
+        return {lookupRunTable(0xFFFD), 1};
+    }
+    return {lookupRunTable(cp), length};
+}
+
+bool isAHLetter(WordBreak wb) {
+    return wb == WordBreak::ALetter || wb == WordBreak::HebrewLetter;
+}
+
+bool isMidLetterOrQ(WordBreak wb) {
+    return wb == WordBreak::MidLetter || wb == WordBreak::MidNumLet || wb == WordBreak::SingleQuote;
+}
+
+bool isMidNumOrQ(WordBreak wb) {
+    return wb == WordBreak::MidNum || wb == WordBreak::MidNumLet || wb == WordBreak::SingleQuote;
+}
+
+bool isWordIgnorable(WordBreak wb) {
+    return wb == WordBreak::Extend || wb == WordBreak::Format || wb == WordBreak::ZWJ;
+}
+
+bool isLineBreak(WordBreak wb) {
+    return wb == WordBreak::CR || wb == WordBreak::LF || wb == WordBreak::Newline;
+}
+
+bool isSentenceSpace(SentenceBreak sb) {
+    return sb == SentenceBreak::Sp || sb == SentenceBreak::Sep || sb == SentenceBreak::CR || sb == SentenceBreak::LF;
+}
+
+bool isParaSep(SentenceBreak sb) {
+    return sb == SentenceBreak::Sep || sb == SentenceBreak::CR || sb == SentenceBreak::LF;
+}
+
+bool isSentenceIgnorable(SentenceBreak sb) {
+    return sb == SentenceBreak::Extend || sb == SentenceBreak::Format;
+}
+
+// Word_Break of the next character that is not ignored under rule WB4
+WordBreak peekWordBreak(std::string_view text, size_t pos) {
+    while (pos < text.size()) {
+        DecodedChar next = decodeAt(text, pos);
+        if (!isWordIgnorable(next.props.word)) {
+            return next.props.word;
+        }
+        pos += next.length;
+    }
+    return WordBreak::Other;
+}
+
+// Sentence_Break of the next character that is not ignored under rule SB5
+SentenceBreak peekSentenceBreak(std::string_view text, size_t pos) {
+    while (pos < text.size()) {
+        DecodedChar next = decodeAt(text, pos);
+        if (!isSentenceIgnorable(next.props.sentence)) {
+            return next.props.sentence;
+        }
+        pos += next.length;
+    }
+    return SentenceBreak::Other;
+}
+
+size_t skipSentenceIgnorables(std::string_view text, size_t pos) {
+    while (pos < text.size()) {
+        DecodedChar next = decodeAt(text, pos);
+        if (!isSentenceIgnorable(next.props.sentence)) {
+            break;
+        }
+        pos += next.length;
+    }
+    return pos;
+}
+
+// Rules WB5 to WB16 for a boundary between prev and cur, where prevPrev and
+// next are the neighbouring characters with WB4 ignorables skipped
+bool joinsWord(WordBreak prevPrev, WordBreak prev, WordBreak cur, std::string_view text, size_t nextPos,
+               int regionalIndicatorCount) {
+    if (isAHLetter(prev) && isAHLetter(cur)) {
+        return true;
+    }
+    if (isAHLetter(prev) && isMidLetterOrQ(cur) && isAHLetter(peekWordBreak(text, nextPos))) {
+        return true;
+    }
+    if (isAHLetter(prevPrev) && isMidLetterOrQ(prev) && isAHLetter(cur)) {
+        return true;
+    }
+    if (prev == WordBreak::HebrewLetter && cur == WordBreak::SingleQuote) {
+        return true;
+    }
+    if (prev == WordBreak::HebrewLetter && cur == WordBreak::DoubleQuote &&
+        peekWordBreak(text, nextPos) == WordBreak::HebrewLetter) {
+        return true;
+    }
+    if (prevPrev == WordBreak::HebrewLetter && prev == WordBreak::DoubleQuote && cur == WordBreak::HebrewLetter) {
+        return true;
+    }
+    if ((prev == WordBreak::Numeric || isAHLetter(prev)) && (cur == WordBreak::Numeric || isAHLetter(cur))) {
+        return true;
+    }
+    if (prevPrev == WordBreak::Numeric && isMidNumOrQ(prev) && cur == WordBreak::Numeric) {
+        return true;
+    }
+    if (prev == WordBreak::Numeric && isMidNumOrQ(cur) && peekWordBreak(text, nextPos) == WordBreak::Numeric) {
+        return true;
+    }
+    if (prev == WordBreak::Katakana && cur == WordBreak::Katakana) {
+        return true;
+    }
+    if ((isAHLetter(prev) || prev == WordBreak::Numeric || prev == WordBreak::Katakana ||
+         prev == WordBreak::ExtendNumLet) && cur == WordBreak::ExtendNumLet) {
+        return true;
+    }
+    if (prev == WordBreak::ExtendNumLet &&
+        (isAHLetter(cur) || cur == WordBreak::Numeric || cur == WordBreak::Katakana)) {
+        return true;
+    }
+    if (prev == WordBreak::RegionalIndicator && cur == WordBreak::RegionalIndicator) {
+        return regionalIndicatorCount % 2 == 1;
+    }
+    return false;
+}
+
+struct WordSegment {
+    size_t end;
+    TokenType type;
+    bool isWhitespace;
+};
+
+// Finds the end of the word-boundary segment starting at start and classifies it
+WordSegment nextWordSegment(std::string_view text, size_t start) {
+    const auto& ascii = asciiProperties();
+    DecodedChar first = decodeAt(text, start);
+    size_t pos = start + first.length;
+
+    bool hasWord = first.props.content == ContentClass::Word;
+    bool hasNoSpaceScript = first.props.content == ContentClass::NoSpaceScript;
+    bool isWhitespace = isSentenceSpace(first.props.sentence);
+
+    WordBreak prev = first.props.word;
+    if (prev == WordBreak::CR && pos < text.size() && text[pos] == '\n') {
+        return {pos + 1, TokenType::Punctuation, true};
+    }
+    if (isLineBreak(prev)) {
+        return {pos, TokenType::Punctuation, isWhitespace};
+    }
+
+    WordBreak prevPrev = WordBreak::Other;
+    WordBreak rawPrev = prev;
+    int regionalIndicatorCount = prev == WordBreak::RegionalIndicator ? 1 : 0;
+
+    while (pos < text.size()) {
+        // ASCII fast path: a letter or digit run continues a letter or number
+        // under WB5 and WB8-WB10, so skip the whole run in one kernel call
+        if ((isAHLetter(prev) || prev == WordBreak::Numeric) &&
+            classifyCharacter(static_cast<unsigned char>(text[pos])) == CharClass::Alphanumeric) {
+            size_t runEnd = findAlnumEnd(text.data(), text.size(), pos + 1);
+            prevPrev = runEnd - pos >= 2 ? ascii[static_cast<unsigned char>(text[runEnd - 2])].word : prev;
+            prev = ascii[static_cast<unsigned char>(text[runEnd - 1])].word;
+            rawPrev = prev;
+            regionalIndicatorCount = 0;
+            hasWord = true;
+            isWhitespace = false;
+            pos = runEnd;
+            continue;
+        }
+
+        DecodedChar next = decodeAt(text, pos);
+        WordBreak cur = next.props.word;
+        size_t nextPos = pos + next.length;
+
+        if (isLineBreak(cur)) {
+            break;
+        }
+
+        bool join;
+        if (rawPrev == WordBreak::ZWJ && cur == WordBreak::ExtendedPictographic) {
+            join = true;
+        } else if (rawPrev == WordBreak::WSegSpace && cur == WordBreak::WSegSpace) {
+            join = true;
+        } else if (isWordIgnorable(cur)) {
+            // Extend, Format and ZWJ attach to the preceding character (WB4)
+            rawPrev = cur;
+            pos = nextPos;
+            continue;
+        } else {
+            join = joinsWord(prevPrev, prev, cur, text, nextPos, regionalIndicatorCount);
+        }
+
+        if (!join) {
+            break;
+        }
+
+        regionalIndicatorCount = cur == WordBreak::RegionalIndicator ? regionalIndicatorCount + 1 : 0;
+        prevPrev = prev;
+        prev = cur;
+        rawPrev = cur;
+        hasWord = hasWord || next.props.content == ContentClass::Word;
+        hasNoSpaceScript = hasNoSpaceScript || next.props.content == ContentClass::NoSpaceScript;
+        isWhitespace = isWhitespace && isSentenceSpace(next.props.sentence);
+        pos = nextPos;
+    }
+
+    TokenType type = hasWord ? TokenType::Word
+                   : hasNoSpaceScript ? TokenType::Ideographic
+                   : TokenType::Punctuation;
+    return {pos, type, isWhitespace};
+}
+
+// Abbreviations that are almost never the last word of a sentence, per
+// language. Ones that often are, such as "etc." or "Inc.", are left out so
+// they still end sentences.
+const std::string_view ENGLISH_ABBREVIATIONS[] = {
+    "mr", "mrs", "ms", "dr", "prof", "sr", "jr", "mt", "vs", "cf", "e.g", "i.e", "gen", "gov", "sen",
+    "rep", "col", "capt", "lt", "sgt", "rev", "hon", "dept"
+};
+const std::string_view GERMAN_ABBREVIATIONS[] = {
+    "dr", "prof", "hr", "fr", "bzw", "vgl", "z.b", "d.h", "evtl", "ggf", "ca", "sog", "inkl", "zzgl"
+};
+const std::string_view FRENCH_ABBREVIATIONS[] = {"mme", "mlle", "mm", "dr", "pr", "cf", "p.ex"};
+
+// Abbreviations that are also ordinary words or often end a sentence ("The
+// answer was no.", "born in Dec.", "on Main St."); they only count before a
+// number ("No. 5", "Dec. 25"). Before a lower case word SB8 already keeps the
+// sentence open.
+const std::string_view ENGLISH_NUMERAL_ABBREVIATIONS[] = {
+    "no", "nos", "al", "st", "ft", "est", "fig", "figs", "vol", "pp", "approx", "jan", "feb", "mar",
+    "apr", "jun", "jul", "aug", "sep", "sept", "oct", "nov", "dec"
+};
+const std::string_view GERMAN_NUMERAL_ABBREVIATIONS[] = {
+    "nr", "abs", "bd", "jan", "feb", "apr", "aug", "sept", "okt", "nov", "dez"
+};
+const std::string_view FRENCH_NUMERAL_ABBREVIATIONS[] = {
+    "no", "art", "chap", "vol", "janv", "avr", "juil", "sept", "oct", "nov"
+};
+
+struct WordList {
+    const std::string_view* first;
+    const std::string_view* last;
+
+    bool contains(std::string_view word) const { return std::find(first, last, word) != last; }
+};
+
+struct AbbreviationList {
+    std::string_view language; // Language part of the language code
+    WordList always;
+    WordList beforeNumber;
+};
+
+const AbbreviationList ABBREVIATION_LISTS[] = {
+    {"en", {std::begin(ENGLISH_ABBREVIATIONS), std::end(ENGLISH_ABBREVIATIONS)},
+     {std::begin(ENGLISH_NUMERAL_ABBREVIATIONS), std::end(ENGLISH_NUMERAL_ABBREVIATIONS)}},
+    {"de", {std::begin(GERMAN_ABBREVIATIONS), std::end(GERMAN_ABBREVIATIONS)},
+     {std::begin(GERMAN_NUMERAL_ABBREVIATIONS), std::end(GERMAN_NUMERAL_ABBREVIATIONS)}},
+    {"fr", {std::begin(FRENCH_ABBREVIATIONS), std::end(FRENCH_ABBREVIATIONS)},
+     {std::begin(FRENCH_NUMERAL_ABBREVIATIONS), std::end(FRENCH_NUMERAL_ABBREVIATIONS)}},
+};
+
+// Helper function to find the abbreviations of a language such as "en_US".
+// Text without a language uses the English lists; languages without lists
+// only recognise single letter initials.
+const AbbreviationList* abbreviationsFor(std::string_view languageCode) {
+    std::string_view language = languageCode.empty() ? "en" : languageCode.substr(0, languageCode.find_first_of("_-"));
+    for (const auto& list : ABBREVIATION_LISTS) {
+        if (list.language == language) {
+            return &list;
+        }
+    }
+    return nullptr;
+}
+
+// Returns true if the full stop at termPos follows an abbreviation or a single
+// letter initial; nextPos is where the text resumes after the spaces following
+// it. Only ASCII words are considered.
+bool isAbbreviationBefore(std::string_view text, size_t sentenceStart, size_t termPos, size_t nextPos,
+                          const AbbreviationList* abbreviations) {
+    size_t wordStart = termPos;
+    while (wordStart > sentenceStart) {
+        unsigned char c = static_cast<unsigned char>(text[wordStart - 1]);
+        if (classifyCharacter(c) != CharClass::Alphanumeric && c != '.') {
+            break;
+        }
+        --wordStart;
+    }
+    if (wordStart == termPos || termPos - wordStart > 6) {
+        return false;
+    }
+
+    // A single letter is an initial, except the pronoun "I" ("So did I. Then...")
+    if (termPos - wordStart == 1 && std::isalpha(static_cast<unsigned char>(text[wordStart]))) {
+        return text[wordStart] != 'I';
+    }
+    if (!abbreviations) {
+        return false;
+    }
+
+    char word[8];
+    for (size_t i = wordStart; i < termPos; ++i) {
+        word[i - wordStart] = static_cast<char>(std::tolower(static_cast<unsigned char>(text[i])));
+    }
+    std::string_view lowered(word, termPos - wordStart);
+    if (abbreviations->beforeNumber.contains(lowered)) {
+        return nextPos < text.size() && std::isdigit(static_cast<unsigned char>(text[nextPos]));
+    }
+    return abbreviations->always.contains(lowered);
+}
+
+// Finds the end of the sentence starting at start under rules SB3 to SB11
+size_t nextSentenceEnd(std::string_view text, size_t start, const AbbreviationList* abbreviations) {
+    const auto& ascii = asciiProperties();
+    SentenceBreak before = SentenceBreak::Other;
+    size_t pos = start;
+
+    while (pos < text.size()) {
+        size_t charStart = pos;
+        unsigned char byte = static_cast<unsigned char>(text[pos]);
+        BreakProperties props;
+        if (byte < 0x80) {
+            // ASCII fast path: only terminators and line breaks need the rules below
+            props = ascii[byte];
+            ++pos;
+        } else {
+            DecodedChar decoded = decodeAt(text, pos);
+            props = decoded.props;
+            pos += decoded.length;
+        }
+        SentenceBreak sb = props.sentence;
+
+        if (isSentenceIgnorable(sb)) {
+            continue;
+        }
+        if (sb == SentenceBreak::CR) {
+            return pos < text.size() && text[pos] == '\n' ? pos + 1 : pos;
+        }
+        if (sb == SentenceBreak::LF || sb == SentenceBreak::Sep) {
+            return pos;
+        }
+        if (sb != SentenceBreak::ATerm && sb != SentenceBreak::STerm) {
+            before = sb;
+            continue;
+        }
+
+        bool isATerm = sb == SentenceBreak::ATerm;
+        pos = skipSentenceIgnorables(text, pos);
+        SentenceBreak following = peekSentenceBreak(text, pos);
+
+        // SB6: a full stop followed directly by a digit is a decimal point
+        // SB7: an upper case letter after "x.y" style initials continues the sentence
+        if (isATerm && (following == SentenceBreak::Numeric ||
+                        ((before == SentenceBreak::Upper || before == SentenceBreak::Lower) &&
+                         following == SentenceBreak::Upper))) {
+            before = sb;
+            continue;
+        }
+
+        // SB9 and SB10: closing punctuation and spaces stay with the sentence
+        while (pos < text.size()) {
+            DecodedChar next = decodeAt(text, pos);
+            if (next.props.sentence != SentenceBreak::Close && !isSentenceIgnorable(next.props.sentence)) {
+                break;
+            }
+            pos += next.length;
+        }
+        while (pos < text.size()) {
+            DecodedChar next = decodeAt(text, pos);
+            if (next.props.sentence != SentenceBreak::Sp && !isSentenceIgnorable(next.props.sentence)) {
+                break;
+            }
+            pos += next.length;
+        }
+
+        // SB11: a paragraph separator after the terminator ends the sentence after it
+        if (pos < text.size()) {
+            DecodedChar next = decodeAt(text, pos);
+            if (isParaSep(next.props.sentence)) {
+                pos += next.length;
+                if (next.props.sentence == SentenceBreak::CR && pos < text.size() && text[pos] == '\n') {
+                    ++pos;
+                }
+                return pos;
+            }
+        }
+
+        // SB8a: a continuation or another terminator keeps the sentence open
+        following = peekSentenceBreak(text, pos);
+        if (following == SentenceBreak::SContinue || following == SentenceBreak::ATerm ||
+            following == SentenceBreak::STerm) {
+            before = sb;
+            continue;
+        }
+
+        // SB8: after a full stop, a lower case letter before any other letter
+        // or terminator means the full stop did not end the sentence
+        if (isATerm) {
+            size_t scan = pos;
+            while (scan < text.size()) {
+                DecodedChar next = decodeAt(text, scan);
+                SentenceBreak ahead = next.props.sentence;
+                if (ahead == SentenceBreak::OLetter || ahead == SentenceBreak::Upper ||
+                    ahead == SentenceBreak::Lower || isParaSep(ahead) ||
+                    ahead == SentenceBreak::ATerm || ahead == SentenceBreak::STerm) {
+                    following = ahead;
+                    break;
+                }
+                scan += next.length;
+            }
+            if (scan < text.size() && following == SentenceBreak::Lower) {
+                before = sb;
+                continue;
+            }
+
+            // Beyond UAX #29: a full stop after a known abbreviation or a
+            // single initial does not end the sentence ("Dr. Watson", "J. Smith")
+            if (scan < text.size() && isAbbreviationBefore(text, start, charStart, pos, abbreviations)) {
+                before = sb;
+                continue;
+            }
+        }
+
+        return pos;
+    }
+
+    return text.size();
+}
+
+// Shared by the heap and arena-backed overloads below
+template <typename TokenVector>
+void appendTokens(std::string_view text, TokenVector& tokens, WordTable* words) {
+    // Words average around five characters plus a separator, so this avoids
+    // most reallocations without over-reserving for punctuation-heavy text
+    tokens.reserve(tokens.size() + text.size() / 6 + 1);
+
+    size_t pos = 0;
+    while (pos < text.size()) {
+        // ASCII whitespace only separates tokens
+        if (classifyCharacter(static_cast<unsigned char>(text[pos])) == CharClass::Whitespace) {
+            pos = skipWhitespace(text.data(), text.size(), pos + 1);
+            continue;
+        }
+
+        WordSegment segment = nextWordSegment(text, pos);
+        if (!segment.isWhitespace) {
+            tokens.push_back({text.substr(pos, segment.end - pos), pos, segment.end - pos, segment.type});
+
+            // Words are interned so later stages look them up by ID instead of rehashing the text
+            if (words && segment.type == TokenType::Word) {
+                tokens.back().wordId = words->intern(tokens.back().text);
+            }
+        }
+        pos = segment.end;
+    }
+}
+
+template <typename SegmentVector>
+void appendSentences(std::string_view text, std::string_view languageCode, SegmentVector& sentences) {
+    const AbbreviationList* abbreviations = abbreviationsFor(languageCode);
+    size_t pos = 0;
+    while (pos < text.size()) {
+        size_t end = nextSentenceEnd(text, pos, abbreviations);
+        sentences.push_back({text.substr(pos, end - pos), pos, end - pos});
+        pos = end;
+    }
+}
+
+} // namespace
+
+std::vector<TextToken> tokenizeText(std::string_view text) {
+    std::vector<TextToken> tokens;
+    appendTokens(text, tokens, nullptr);
+    return tokens;
+}
+
+std::pmr::vector<TextToken> tokenizeText(std::string_view text, std::pmr::memory_resource* resource) {
+    std::pmr::vector<TextToken> tokens(resource);
+    appendTokens(text, tokens, nullptr);
+    return tokens;
+}
+
+std::vector<TextToken> tokenizeText(std::string_view text, WordTable& words) {
+    std::vector<TextToken> tokens;
+    appendTokens(text, tokens, &words);
+    return tokens;
+}
+
+std::pmr::vector<TextToken> tokenizeText(std::string_view text, std::pmr::memory_resource* resource, WordTable& words) {
+    std::pmr::vector<TextToken> tokens(resource);
+    appendTokens(text, tokens, &words);
+    return tokens;
+}
+
+SentenceSplitter::SentenceSplitter(std::string_view text, std::string_view languageCode)
+    : m_text(text), m_languageCode(languageCode), m_position(0) {
+}
+
+bool SentenceSplitter::next(TextSegment& sentence) {
+    if (m_position >= m_text.size()) {
+        return false;
+    }
+
+    // Only the text up to the next boundary is examined, so callers can start
+    // checking a sentence before the rest of the text has been segmented
+    size_t end = nextSentenceEnd(m_text, m_position, abbreviationsFor(m_languageCode));
+    sentence = {m_text.substr(m_position, end - m_position), m_position, end - m_position};
+    m_position = end;
+    return true;
+}
+
+std::vector<TextSegment> splitIntoSentences(std::string_view text, std::string_view languageCode) {
+    std::vector<TextSegment> sentences;
+    appendSentences(text, languageCode, sentences);
+    return sentences;
+}
+
+std::pmr::vector<TextSegment> splitIntoSentences(std::string_view text, std::pmr::memory_resource* resource,
+                                                 std::string_view languageCode) {
+    std::pmr::vector<TextSegment> sentences(resource);
+    appendSentences(text, languageCode, sentences);
+    return sentences;
+}
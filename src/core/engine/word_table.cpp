@@ -0,0 +1,242 @@
+#include <string>
+#include <string_view>
+#include <vector>
+#include <memory>
+#include <mutex>
+#include <shared_mutex>
+#include <atomic>
+#include <cstdint>
+#include <cstring>
+#include <algorithm>
+#include "word_table.h"
+
+// Interned words are stored once per process and identified by a 32-bit ID.
+// The table is split into shards selected by the top bits of the word's hash,
+// so threads interning different words rarely contend on the same lock. The
+// low bits of an ID name the shard and the remaining bits the entry inside it.
+//
+// Entries are never freed, since IDs are held by tokens, caches and custom
+// dictionaries for the life of the process. Every distinct token is interned,
+// typos included, so each shard stops growing at its share of the table's
+// word limit; words first seen after that get INVALID_WORD_ID, like overlong
+// ones, and are looked up by text. With the default limit the table stays
+// around 50 MB at most however long the process runs.
+//
+// Each thread keeps a small direct-mapped cache of the words it interned last.
+// A document repeats a few hundred common words, so most tokens are answered
+// there without touching a shard lock. Entries are tagged with the table's
+// instance number, which is never reused, and point at text that lives as long
+// as the table.
+const uint32_t WORD_TABLE_SHARD_BITS = 6;
+const uint32_t WORD_TABLE_SHARDS = 1u << WORD_TABLE_SHARD_BITS;
+const size_t MAX_INTERNED_WORD_LENGTH = 64;   // Longer "words" are usually URLs or encoded data
+const size_t WORD_STORAGE_CHUNK_BYTES = 64 * 1024;
+const size_t INITIAL_SLOTS_PER_SHARD = 1024;  // Must be a power of two
+const size_t DEFAULT_MAX_INTERNED_WORDS = 1u << 20;
+const size_t WORD_FRONT_CACHE_SLOTS = 512;    // Per thread; must be a power of two
+
+struct WordTable::Entry {
+    std::string_view text;
+    uint64_t hash;
+};
+
+struct WordTable::Shard {
+    mutable std::shared_mutex mutex;
+
+    // Open-addressing index of entry positions plus one; zero marks an empty slot
+    std::vector<uint32_t> slots = std::vector<uint32_t>(INITIAL_SLOTS_PER_SHARD, 0);
+    std::vector<Entry> entries;
+
+    // Word text lives in fixed chunks that are never moved, so views stay valid
+    std::vector<std::unique_ptr<char[]>> chunks;
+    size_t chunkUsed = WORD_STORAGE_CHUNK_BYTES;
+
+    uint32_t findLocked(std::string_view word, uint64_t hash) const;
+    uint32_t insertLocked(std::string_view word, uint64_t hash);
+    void growIndexLocked();
+};
+
+namespace {
+
+struct FrontCacheSlot {
+    uint64_t table = 0;
+    uint64_t hash = 0;
+    std::string_view text;
+    uint32_t id = INVALID_WORD_ID;
+};
+
+std::atomic<uint64_t> nextTableInstance{1};
+
+// Helper function to return the calling thread's cache slot for a word hash
+FrontCacheSlot& frontCacheSlot(uint64_t hash) {
+    thread_local FrontCacheSlot cache[WORD_FRONT_CACHE_SLOTS];
+    return cache[hash & (WORD_FRONT_CACHE_SLOTS - 1)];
+}
+
+} // namespace
+
+uint64_t hashWord(std::string_view word) {
+    // 64-bit FNV-1a; words are short, so a simple byte loop beats block hashes
+    uint64_t hash = 14695981039346656037ull;
+    for (unsigned char c : word) {
+        hash ^= c;
+        hash *= 1099511628211ull;
+    }
+    return hash;
+}
+
+uint32_t WordTable::Shard::findLocked(std::string_view word, uint64_t hash) const {
+    size_t mask = slots.size() - 1;
+    for (size_t slot = hash & mask; slots[slot] != 0; slot = (slot + 1) & mask) {
+        const Entry& entry = entries[slots[slot] - 1];
+        if (entry.hash == hash && entry.text == word) {
+            return slots[slot] - 1;
+        }
+    }
+    return INVALID_WORD_ID;
+}
+
+uint32_t WordTable::Shard::insertLocked(std::string_view word, uint64_t hash) {
+    // Copy the text into the current storage chunk, starting a new one if it is full
+    if (chunkUsed + word.size() > WORD_STORAGE_CHUNK_BYTES) {
+        chunks.push_back(std::make_unique<char[]>(WORD_STORAGE_CHUNK_BYTES));
+        chunkUsed = 0;
+    }
+    char* storage = chunks.back().get() + chunkUsed;
+    std::memcpy(storage, word.data(), word.size());
+    chunkUsed += word.size();
+
+    uint32_t index = static_cast<uint32_t>(entries.size());
+    entries.push_back({std::string_view(storage, word.size()), hash});
+
+    // Keep the index at most half full so probe sequences stay short
+    if (entries.size() * 2 > slots.size()) {
+        growIndexLocked();
+    } else {
+        size_t mask = slots.size() - 1;
+        size_t slot = hash & mask;
+        while (slots[slot] != 0) {
+            slot = (slot + 1) & mask;
+        }
+        slots[slot] = index + 1;
+    }
+    return index;
+}
+
+void WordTable::Shard::growIndexLocked() {
+    // Rebuild the index from the stored hashes; no word is hashed again
+    std::vector<uint32_t> grown(slots.size() * 2, 0);
+    size_t mask = grown.size() - 1;
+    for (uint32_t i = 0; i < entries.size(); ++i) {
+        size_t slot = entries[i].hash & mask;
+        while (grown[slot] != 0) {
+            slot = (slot + 1) & mask;
+        }
+        grown[slot] = i + 1;
+    }
+    slots.swap(grown);
+}
+
+WordTable::WordTable(size_t maxWords)
+    : m_maxWordsPerShard(std::max<size_t>(1, maxWords / WORD_TABLE_SHARDS)),
+      m_instance(nextTableInstance.fetch_add(1, std::memory_order_relaxed)) {
+    for (uint32_t i = 0; i < WORD_TABLE_SHARDS; ++i) {
+        m_shards.push_back(std::make_unique<Shard>());
+    }
+}
+
+WordTable::~WordTable() = default;
+
+WordTable& WordTable::global() {
+    // IDs must agree between every checker in the process, so they share one table
+    static WordTable table;
+    return table;
+}
+
+uint32_t WordTable::intern(std::string_view word) {
+    if (word.empty() || word.size() > MAX_INTERNED_WORD_LENGTH) {
+        return INVALID_WORD_ID;
+    }
+
+    uint64_t hash = hashWord(word);
+    FrontCacheSlot& cached = frontCacheSlot(hash);
+    if (cached.table == m_instance && cached.hash == hash && cached.text == word) {
+        return cached.id;
+    }
+
+    uint32_t shardIndex = static_cast<uint32_t>(hash >> (64 - WORD_TABLE_SHARD_BITS));
+    Shard& shard = *m_shards[shardIndex];
+
+    // Nearly every word of a long document has been seen before, so try a
+    // shared lock first and only take the exclusive lock to insert. A full
+    // shard keeps answering for the words it holds but takes no more, which is
+    // known under the shared lock too.
+    uint32_t index;
+    std::string_view text;
+    {
+        std::shared_lock<std::shared_mutex> lock(shard.mutex);
+        index = shard.findLocked(word, hash);
+        if (index == INVALID_WORD_ID && shard.entries.size() >= m_maxWordsPerShard) {
+            return INVALID_WORD_ID;
+        }
+        if (index != INVALID_WORD_ID) {
+            text = shard.entries[index].text;
+        }
+    }
+
+    if (index == INVALID_WORD_ID) {
+        std::unique_lock<std::shared_mutex> lock(shard.mutex);
+        index = shard.findLocked(word, hash);
+        if (index == INVALID_WORD_ID) {
+            if (shard.entries.size() >= m_maxWordsPerShard) {
+                return INVALID_WORD_ID;
+            }
+            index = shard.insertLocked(word, hash);
+        }
+        text = shard.entries[index].text;
+    }
+
+    uint32_t wordId = (index << WORD_TABLE_SHARD_BITS) | shardIndex;
+    cached = {m_instance, hash, text, wordId};
+    return wordId;
+}
+
+uint32_t WordTable::find(std::string_view word) const {
+    if (word.empty() || word.size() > MAX_INTERNED_WORD_LENGTH) {
+        return INVALID_WORD_ID;
+    }
+
+    uint64_t hash = hashWord(word);
+    const FrontCacheSlot& cached = frontCacheSlot(hash);
+    if (cached.table == m_instance && cached.hash == hash && cached.text == word) {
+        return cached.id;
+    }
+
+    uint32_t shardIndex = static_cast<uint32_t>(hash >> (64 - WORD_TABLE_SHARD_BITS));
+    const Shard& shard = *m_shards[shardIndex];
+
+    std::shared_lock<std::shared_mutex> lock(shard.mutex);
+    uint32_t index = shard.findLocked(word, hash);
+    return index == INVALID_WORD_ID ? INVALID_WORD_ID : (index << WORD_TABLE_SHARD_BITS) | shardIndex;
+}
+
+std::string_view WordTable::text(uint32_t wordId) const {
+    const Shard& shard = *m_shards[wordId & (WORD_TABLE_SHARDS - 1)];
+    std::shared_lock<std::shared_mutex> lock(shard.mutex);
+    return shard.entries[wordId >> WORD_TABLE_SHARD_BITS].text;
+}
+
+uint64_t WordTable::hash(uint32_t wordId) const {
+    const Shard& shard = *m_shards[wordId & (WORD_TABLE_SHARDS - 1)];
+    std::shared_lock<std::shared_mutex> lock(shard.mutex);
+    return shard.entries[wordId >> WORD_TABLE_SHARD_BITS].hash;
+}
+
+size_t WordTable::size() const {
+    size_t total = 0;
+    for (const auto& shard : m_shards) {
+        std::shared_lock<std::shared_mutex> lock(shard->mutex);
+        total += shard->entries.size();
+    }
+    return total;
+}
@@ -0,0 +1,175 @@
+#include <deque>
+#include <atomic>
+#include <algorithm>
+#include <mutex>
+#include <thread>
+#include <vector>
+#include <memory>
+#include <functional>
+#include <exception>
+#include <condition_variable>
+#include "work_stealing_pool.h"
+
+namespace {
+
+// Identifies the pool and worker running on the current thread, so that tasks
+// submitted from inside a task go to the submitting worker's own queue
+thread_local const WorkStealingPool* t_currentPool = nullptr;
+thread_local size_t t_currentWorker = 0;
+
+} // namespace
+
+WorkStealingPool::WorkStealingPool(size_t threadCount) {
+    if (threadCount == 0) {
+        threadCount = std::max<size_t>(1, std::thread::hardware_concurrency());
+    }
+
+    // Create one task queue per worker before any worker starts stealing
+    for (size_t i = 0; i < threadCount; ++i) {
+        m_queues.push_back(std::make_unique<WorkerQueue>());
+    }
+
+    // Start the worker threads
+    for (size_t i = 0; i < threadCount; ++i) {
+        m_threads.emplace_back([this, i] { workerLoop(i); });
+    }
+}
+
+WorkStealingPool::~WorkStealingPool() {
+    // Let the workers drain the queued tasks, then stop them
+    {
+        std::lock_guard<std::mutex> lock(m_wakeMutex);
+        m_stopping = true;
+    }
+    m_wakeCondition.notify_all();
+
+    for (auto& thread : m_threads) {
+        thread.join();
+    }
+}
+
+void WorkStealingPool::submit(Task task) {
+    // Workers push to their own queue; other threads spread tasks round-robin
+    size_t queueIndex = t_currentPool == this
+        ? t_currentWorker
+        : m_nextQueue.fetch_add(1, std::memory_order_relaxed) % m_queues.size();
+
+    {
+        std::lock_guard<std::mutex> lock(m_wakeMutex);
+        ++m_pendingTasks;
+    }
+    {
+        std::lock_guard<std::mutex> lock(m_queues[queueIndex]->mutex);
+        m_queues[queueIndex]->tasks.push_back(std::move(task));
+    }
+    m_wakeCondition.notify_one();
+}
+
+void WorkStealingPool::parallelFor(size_t count, size_t maxHelpers, const std::function<void(size_t index)>& body) {
+    // Shared with the helper tasks. A helper may start only after the caller
+    // has claimed every index and returned, so helpers touch the caller's
+    // body only for an index they claimed, which the caller waits for.
+    struct Loop {
+        size_t count = 0;
+        const std::function<void(size_t)>* body = nullptr;
+        std::atomic<size_t> nextIndex{0};
+
+        std::mutex mutex;
+        std::condition_variable doneCondition;
+        size_t finished = 0;
+        std::exception_ptr error;
+
+        void run() {
+            for (size_t index = nextIndex++; index < count; index = nextIndex++) {
+                try {
+                    (*body)(index);
+                } catch (...) {
+                    std::lock_guard<std::mutex> lock(mutex);
+                    if (!error) {
+                        error = std::current_exception();
+                    }
+                }
+
+                std::lock_guard<std::mutex> lock(mutex);
+                if (++finished == count) {
+                    doneCondition.notify_all();
+                }
+            }
+        }
+    };
+
+    if (count == 0) {
+        return;
+    }
+    auto loop = std::make_shared<Loop>();
+    loop->count = count;
+    loop->body = &body;
+
+    // The calling thread claims indices too, so the loop finishes even when
+    // every worker is busy, including when called from one of the workers
+    size_t helpers = std::min({maxHelpers, threadCount(), count - 1});
+    for (size_t i = 0; i < helpers; ++i) {
+        submit([loop](size_t) { loop->run(); });
+    }
+    loop->run();
+
+    std::unique_lock<std::mutex> lock(loop->mutex);
+    loop->doneCondition.wait(lock, [&] { return loop->finished == loop->count; });
+    if (loop->error) {
+        std::rethrow_exception(loop->error);
+    }
+}
+
+size_t WorkStealingPool::threadCount() const {
+    return m_threads.size();
+}
+
+void WorkStealingPool::workerLoop(size_t workerIndex) {
+    t_currentPool = this;
+    t_currentWorker = workerIndex;
+
+    while (true) {
+        Task task;
+        if (popLocal(workerIndex, task) || steal(workerIndex, task)) {
+            {
+                std::lock_guard<std::mutex> lock(m_wakeMutex);
+                --m_pendingTasks;
+            }
+            task(workerIndex);
+            continue;
+        }
+
+        // Sleep until a task is submitted or the pool shuts down
+        std::unique_lock<std::mutex> lock(m_wakeMutex);
+        m_wakeCondition.wait(lock, [this] { return m_stopping || m_pendingTasks > 0; });
+        if (m_stopping && m_pendingTasks == 0) {
+            return;
+        }
+    }
+}
+
+bool WorkStealingPool::popLocal(size_t workerIndex, Task& task) {
+    // Take the most recently pushed task, which is most likely still in cache
+    WorkerQueue& queue = *m_queues[workerIndex];
+    std::lock_guard<std::mutex> lock(queue.mutex);
+    if (queue.tasks.empty()) {
+        return false;
+    }
+    task = std::move(queue.tasks.back());
+    queue.tasks.pop_back();
+    return true;
+}
+
+bool WorkStealingPool::steal(size_t thiefIndex, Task& task) {
+    // Take the oldest task from the next non-empty queue after our own
+    for (size_t offset = 1; offset < m_queues.size(); ++offset) {
+        WorkerQueue& queue = *m_queues[(thiefIndex + offset) % m_queues.size()];
+        std::lock_guard<std::mutex> lock(queue.mutex);
+        if (!queue.tasks.empty()) {
+            task = std::move(queue.tasks.front());
+            queue.tasks.pop_front();
+            return true;
+        }
+    }
+    return false;
+}
@@ -0,0 +1,86 @@
+#include <string>
+#include <iostream>
+#include <cstdlib>
+#include <hunspell/hunspell.hxx>
+#include "../engine/compiled_dictionary.h"
+#include "../engine/symspell_index.h"
+
+// Offline compiler from a Hunspell .aff/.dic pair to the memory-mapped image
+// loaded by SpellCheck. The image is written next to the dictionary as
+// <name>.cdic, where LanguageManager's dictionary path points.
+//
+// With --frequency-list, the most frequent surface forms that Hunspell accepts
+// are also stored in a perfect-hash set that is checked before anything else.
+// Dictionaries the stem format cannot model then still get an image holding
+// just that set.
+//
+// With --symspell, the suggestion index used by SpellCheck's SymSpell backend
+// is also built ahead of time as <name>.symspell, from the stems and the
+// optional <name>.freq word list, instead of on the first suggestion request.
+//
+// Usage: compile_dictionary [--frequency-list FILE] [--known-words N] [--symspell]
+//                           <dictionary path without extension> [output]
+// Exit codes: 0 compiled, 1 failed, 3 the dictionary needs Hunspell at runtime
+int main(int argc, char** argv) {
+    DictionaryCompileOptions options;
+    std::string dictionaryPath;
+    std::string outputPath;
+    bool buildSymSpell = false;
+
+    for (int i = 1; i < argc; ++i) {
+        std::string argument = argv[i];
+        if (argument == "--frequency-list" && i + 1 < argc) {
+            options.frequencyListPath = argv[++i];
+        } else if (argument == "--known-words" && i + 1 < argc) {
+            options.knownWordLimit = static_cast<size_t>(std::atoll(argv[++i]));
+        } else if (argument == "--symspell") {
+            buildSymSpell = true;
+        } else if (dictionaryPath.empty()) {
+            dictionaryPath = argument;
+        } else if (outputPath.empty()) {
+            outputPath = argument;
+        } else {
+            dictionaryPath.clear();
+            break;
+        }
+    }
+    if (dictionaryPath.empty()) {
+        std::cerr << "Usage: compile_dictionary [--frequency-list FILE] [--known-words N] [--symspell] "
+                     "<dictionary path without extension> [output]" << std::endl;
+        return 1;
+    }
+    if (outputPath.empty()) {
+        outputPath = dictionaryPath + ".cdic";
+    }
+
+    // Known words are filtered through Hunspell itself, so the fast path can
+    // never accept a word that Hunspell would reject
+    std::string affPath = dictionaryPath + ".aff";
+    std::string dicPath = dictionaryPath + ".dic";
+    Hunspell hunspell(affPath.c_str(), dicPath.c_str());
+    options.isCorrect = [&hunspell](const std::string& word) { return hunspell.spell(word); };
+
+    std::string message;
+    DictionaryCompileResult result = compileDictionary(affPath, dicPath, outputPath, options, message);
+
+    if (buildSymSpell && result != DictionaryCompileResult::Failed) {
+        auto index = SymSpellIndex::buildFromDictionary(dictionaryPath, options.isCorrect);
+        if (!index || !index->save(dictionaryPath + ".symspell")) {
+            std::cerr << dictionaryPath << ": failed to write the SymSpell index" << std::endl;
+            return 1;
+        }
+        std::cout << dictionaryPath << ".symspell: " << index->wordCount() << " words" << std::endl;
+    }
+
+    switch (result) {
+        case DictionaryCompileResult::Compiled:
+            std::cout << outputPath << ": " << message << std::endl;
+            return 0;
+        case DictionaryCompileResult::Unsupported:
+            std::cerr << dictionaryPath << " left to Hunspell: " << message << std::endl;
+            return 3;
+        default:
+            std::cerr << dictionaryPath << ": " << message << std::endl;
+            return 1;
+    }
+}
@@ -0,0 +1,122 @@
+import os
+import json
+import subprocess
+import argparse
+import logging
+
+# Define global variables
+SCRIPT_DIR = os.path.dirname(os.path.abspath(__file__))
+ROOT_DIR = os.path.abspath(os.path.join(SCRIPT_DIR, '..', '..'))
+BUILD_DIR = os.path.join(ROOT_DIR, 'build')
+BENCHMARK_DIR = os.path.join(ROOT_DIR, 'tests', 'core', 'engine', 'benchmarks')
+DEFAULT_BINARY = os.path.join(BUILD_DIR, 'benchmarks', 'text_processing_benchmark')
+DEFAULT_SUGGESTION_BINARY = os.path.join(BUILD_DIR, 'benchmarks', 'suggestion_benchmark')
+DEFAULT_BASELINE = os.path.join(BENCHMARK_DIR, 'baseline.json')
+CORPUS_DIR = os.path.join(BENCHMARK_DIR, 'corpora')
+QUALITY_TOLERANCE = 0.02
+logger = logging.getLogger(__name__)
+
+def setup_logging():
+    """Sets up logging configuration"""
+    logging.basicConfig(format='%(asctime)s - %(name)s - %(levelname)s - %(message)s', level=logging.INFO)
+
+def parse_arguments():
+    """Parses command-line arguments"""
+    parser = argparse.ArgumentParser(description="Run the text-processing benchmarks and check for regressions")
+    parser.add_argument('--binary', default=DEFAULT_BINARY, help="Path to the text_processing_benchmark executable")
+    parser.add_argument('--suggestion-binary', default=DEFAULT_SUGGESTION_BINARY, help="Path to the suggestion_benchmark executable, run with --dictionary-dir")
+    parser.add_argument('--baseline', default=DEFAULT_BASELINE, help="Baseline results to compare against")
+    parser.add_argument('--output', default=os.path.join(BUILD_DIR, 'benchmark_results.json'), help="Where to write the new results")
+    parser.add_argument('--iterations', type=int, default=3, help="Passes over each corpus")
+    parser.add_argument('--dictionary-dir', help="Directory with <lang>.aff/.dic/.cdic files for the dictionary stages (optional)")
+    parser.add_argument('--tolerance', type=float, default=0.10, help="Allowed fractional slowdown before failing (default 0.10)")
+    parser.add_argument('--update-baseline', action='store_true', help="Record the new results as the baseline instead of comparing")
+    return parser.parse_args()
+
+def run_benchmark(binary, output, iterations, dictionary_dir=None):
+    """Runs the benchmark executable and returns its parsed results"""
+    logger.info(f"Running {binary}")
+    os.makedirs(os.path.dirname(os.path.abspath(output)), exist_ok=True)
+    command = [binary, '--corpus-dir', CORPUS_DIR, '--output', output, '--iterations', str(iterations)]
+    if dictionary_dir:
+        command += ['--dictionary-dir', dictionary_dir]
+    subprocess.run(command, check=True)
+    with open(output) as f:
+        return json.load(f)
+
+def run_suggestion_benchmark(binary, output, iterations, dictionary_dir):
+    """Runs the suggestion benchmark and returns its parsed results"""
+    logger.info(f"Running {binary}")
+    command = [binary, '--corpus-dir', CORPUS_DIR, '--output', output, '--iterations', str(iterations),
+               '--dictionary-dir', dictionary_dir]
+    subprocess.run(command, check=True)
+    with open(output) as f:
+        return json.load(f)
+
+def index_results(results):
+    """Keys each result by its corpus and stage"""
+    return {(r['corpus'], r['stage']): r for r in results['results']}
+
+def compare_results(baseline, current, tolerance):
+    """Returns a list of regressions of current against baseline"""
+    regressions = []
+    baseline_index = index_results(baseline)
+    current_index = index_results(current)
+
+    for key, base in baseline_index.items():
+        result = current_index.get(key)
+        if result is None:
+            regressions.append(f"{key[0]}/{key[1]}: missing from current results")
+            continue
+
+        # Throughput must not drop and tail latency must not grow beyond the tolerance
+        if result['mb_per_s'] < base['mb_per_s'] * (1.0 - tolerance):
+            regressions.append(f"{key[0]}/{key[1]}: throughput {result['mb_per_s']:.2f} MB/s vs baseline {base['mb_per_s']:.2f} MB/s")
+        if result['p99_us'] > base['p99_us'] * (1.0 + tolerance):
+            regressions.append(f"{key[0]}/{key[1]}: p99 {result['p99_us']:.2f} us vs baseline {base['p99_us']:.2f} us")
+
+        # Suggestion stages must also keep their quality
+        if 'top1' in base and result.get('top1', 0.0) < base['top1'] - QUALITY_TOLERANCE:
+            regressions.append(f"{key[0]}/{key[1]}: top1 {result.get('top1', 0.0):.1%} vs baseline {base['top1']:.1%}")
+
+    return regressions
+
+def main():
+    """Main function to orchestrate the benchmark run"""
+    setup_logging()
+    args = parse_arguments()
+
+    current = run_benchmark(args.binary, args.output, args.iterations, args.dictionary_dir)
+    if args.dictionary_dir:
+        suggestion_output = os.path.splitext(args.output)[0] + '_suggestions.json'
+        suggestions = run_suggestion_benchmark(args.suggestion_binary, suggestion_output, args.iterations, args.dictionary_dir)
+        current['results'] += suggestions['results']
+
+    if args.update_baseline:
+        with open(args.baseline, 'w') as f:
+            json.dump(current, f, indent=2)
+            f.write('\n')
+        logger.info(f"Baseline updated at {args.baseline}")
+        exit(0)
+
+    # Timings only compare on the machine that recorded them, so a checkout
+    # without a baseline skips the comparison instead of failing
+    if not os.path.exists(args.baseline):
+        logger.warning(f"No baseline at {args.baseline}; skipping the comparison (record one with --update-baseline)")
+        exit(0)
+
+    with open(args.baseline) as f:
+        baseline = json.load(f)
+
+    regressions = compare_results(baseline, current, args.tolerance)
+    if regressions:
+        for regression in regressions:
+            logger.error(regression)
+        logger.error(f"{len(regressions)} benchmark regression(s) beyond {args.tolerance:.0%}")
+        exit(1)
+
+    logger.info("No benchmark regressions")
+    exit(0)
+
+if __name__ == '__main__':
+    main()
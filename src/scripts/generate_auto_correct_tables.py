@@ -0,0 +1,157 @@
+import os
+import sys
+import argparse
+import logging
+
+# Define global variables
+SCRIPT_DIR = os.path.dirname(os.path.abspath(__file__))
+ROOT_DIR = os.path.abspath(os.path.join(SCRIPT_DIR, '..', '..'))
+RULES_DIR = os.path.join(SCRIPT_DIR, 'auto_correct_rules')
+OUTPUT_PATH = os.path.join(ROOT_DIR, 'src', 'core', 'engine', 'default_auto_correct_rules.inc')
+RULES_PER_BUCKET = 4       # Average bucket size of the hash-and-displace construction
+SLOT_LOAD_FACTOR = 0.8     # Rules per slot; spare slots keep the displacement search short
+MAX_DISPLACEMENT = 1 << 20
+MASK64 = (1 << 64) - 1
+logger = logging.getLogger(__name__)
+
+def setup_logging():
+    """Sets up logging configuration"""
+    logging.basicConfig(format='%(asctime)s - %(name)s - %(levelname)s - %(message)s', level=logging.INFO)
+
+def parse_arguments():
+    """Parses command-line arguments"""
+    parser = argparse.ArgumentParser(description="Generate the default auto-correct rule tables")
+    parser.add_argument('--rules', default=RULES_DIR, help="Directory of <language>.tsv rule files")
+    parser.add_argument('--output', default=OUTPUT_PATH, help="Path of the generated table file")
+    return parser.parse_args()
+
+def hash_word(text):
+    """64-bit FNV-1a of the UTF-8 bytes, as hashWord in word_table.cpp"""
+    value = 14695981039346656037
+    for byte in text.encode('utf-8'):
+        value ^= byte
+        value = (value * 1099511628211) & MASK64
+    return value
+
+def bucket_for(value, bucket_count):
+    """Bucket of a hash, as bucketFor in default_auto_correct_rules.cpp"""
+    return (value >> 32) % bucket_count
+
+def slot_for(value, displacement, slot_count):
+    """Slot of a hash under a displacement, as slotFor in default_auto_correct_rules.cpp"""
+    mixed = value ^ ((displacement * 0x9E3779B97F4A7C15) & MASK64)
+    mixed ^= mixed >> 33
+    mixed = (mixed * 0xFF51AFD7ED558CCD) & MASK64
+    mixed ^= mixed >> 33
+    return mixed % slot_count
+
+def read_rules(path):
+    """Reads the tab-separated rules of one language, skipping comments and blank lines"""
+    rules = {}
+    with open(path, encoding='utf-8') as source:
+        for number, line in enumerate(source, 1):
+            line = line.rstrip('\n')
+            if not line or line.startswith('#'):
+                continue
+            fields = line.split('\t')
+            if len(fields) != 2 or not fields[0] or not fields[1]:
+                raise ValueError(f"{path}:{number}: expected incorrect text, a tab and its replacement")
+            if fields[0] in rules:
+                raise ValueError(f"{path}:{number}: duplicate rule for '{fields[0]}'")
+            rules[fields[0]] = fields[1]
+    return sorted(rules.items())
+
+def build_perfect_hash(rules):
+    """Finds a displacement per bucket so that every rule gets a slot of its own"""
+    bucket_count = max(1, (len(rules) + RULES_PER_BUCKET - 1) // RULES_PER_BUCKET)
+    slot_count = max(1, int(len(rules) / SLOT_LOAD_FACTOR) + 1)
+    buckets = [[] for _ in range(bucket_count)]
+    for index, (incorrect, _) in enumerate(rules):
+        value = hash_word(incorrect)
+        buckets[bucket_for(value, bucket_count)].append((index, value))
+
+    # Place the largest buckets first, while most slots are still free
+    displacements = [0] * bucket_count
+    slots = [0] * slot_count
+    for bucket in sorted(range(bucket_count), key=lambda b: -len(buckets[b])):
+        if not buckets[bucket]:
+            continue
+        for displacement in range(MAX_DISPLACEMENT):
+            targets = [slot_for(value, displacement, slot_count) for _, value in buckets[bucket]]
+            if len(set(targets)) == len(targets) and all(slots[target] == 0 for target in targets):
+                break
+        else:
+            raise RuntimeError("No displacement found; lower SLOT_LOAD_FACTOR")
+        displacements[bucket] = displacement
+        for (index, _), target in zip(buckets[bucket], targets):
+            slots[target] = index + 1
+    return displacements, slots
+
+def cpp_string(text):
+    """Quotes text as a C++ string literal, escaping non-ASCII bytes"""
+    quoted = '"'
+    escaped = False
+    for byte in text.encode('utf-8'):
+        char = chr(byte)
+        if escaped and char in '0123456789abcdefABCDEF':
+            quoted += '""'  # End the literal so the digit is not read as part of the escape
+        escaped = False
+        if char in '"\\':
+            quoted += '\\' + char
+        elif 0x20 <= byte < 0x7F:
+            quoted += char
+        else:
+            quoted += '\\x%02X' % byte
+            escaped = True
+    return quoted + '"'
+
+def write_numbers(out, name, values):
+    """Writes an array of unsigned integers, eight per line"""
+    out.write('static const uint32_t %s[%d] = {\n' % (name, len(values)))
+    for i in range(0, len(values), 8):
+        out.write('    ' + ', '.join(str(value) for value in values[i:i + 8]) + ',\n')
+    out.write('};\n\n')
+
+def write_tables(languages, output_path):
+    """Writes the tables as a C++ fragment included by default_auto_correct_rules.cpp"""
+    with open(output_path, 'w', newline='\n') as out:
+        out.write('// Generated by src/scripts/generate_auto_correct_tables.py from src/scripts/auto_correct_rules. Do not edit.\n')
+        out.write('//\n')
+        out.write('// Per language: the rules sorted by incorrect text, a displacement per hash\n')
+        out.write('// bucket, and the slots, each holding a rule index plus one or zero when free.\n\n')
+        for language, rules, displacements, slots in languages:
+            prefix = language.upper()
+            out.write('static const DefaultAutoCorrectRule %s_RULES[%d] = {\n' % (prefix, len(rules)))
+            for incorrect, correct in rules:
+                out.write('    {%s, %s},\n' % (cpp_string(incorrect), cpp_string(correct)))
+            out.write('};\n\n')
+            write_numbers(out, prefix + '_DISPLACEMENTS', displacements)
+            write_numbers(out, prefix + '_SLOTS', slots)
+        out.write('static const DefaultAutoCorrectTable DEFAULT_AUTO_CORRECT_TABLES[%d] = {\n' % len(languages))
+        for language, rules, displacements, slots in languages:
+            prefix = language.upper()
+            out.write('    {"%s", %s_RULES, %d, %s_DISPLACEMENTS, %d, %s_SLOTS, %d},\n'
+                      % (language, prefix, len(rules), prefix, len(displacements), prefix, len(slots)))
+        out.write('};\n')
+
+def main():
+    """Main function to generate the default auto-correct rule tables"""
+    setup_logging()
+    args = parse_arguments()
+
+    languages = []
+    for name in sorted(os.listdir(args.rules)):
+        if not name.endswith('.tsv'):
+            continue
+        language = name[:-len('.tsv')]
+        rules = read_rules(os.path.join(args.rules, name))
+        displacements, slots = build_perfect_hash(rules)
+        languages.append((language, rules, displacements, slots))
+        logger.info(f"{language}: {len(rules)} rules in {len(slots)} slots")
+
+    write_tables(languages, args.output)
+    logger.info(f"Wrote {len(languages)} rule tables to {args.output}")
+    return 0
+
+if __name__ == '__main__':
+    sys.exit(main())
@@ -0,0 +1,236 @@
+import os
+import sys
+import argparse
+import logging
+import unicodedata
+
+# Define global variables
+SCRIPT_DIR = os.path.dirname(os.path.abspath(__file__))
+ROOT_DIR = os.path.abspath(os.path.join(SCRIPT_DIR, '..', '..'))
+OUTPUT_PATH = os.path.join(ROOT_DIR, 'src', 'core', 'engine', 'unicode_break_tables.inc')
+MAX_CODE_POINT = 0x10FFFF
+logger = logging.getLogger(__name__)
+
+# Word_Break values, in the order of the WordBreak enum in text_segmentation.cpp.
+# Extended_Pictographic is folded in as an extra value because those code points
+# are Word_Break=Other everywhere it matters for rule WB3c.
+WB_OTHER, WB_CR, WB_LF, WB_NEWLINE, WB_EXTEND, WB_ZWJ, WB_REGIONAL_INDICATOR, WB_FORMAT, \
+    WB_KATAKANA, WB_HEBREW_LETTER, WB_ALETTER, WB_SINGLE_QUOTE, WB_DOUBLE_QUOTE, WB_MID_NUM_LET, \
+    WB_MID_LETTER, WB_MID_NUM, WB_NUMERIC, WB_EXTEND_NUM_LET, WB_WSEG_SPACE, WB_EXT_PICT = range(20)
+
+# Sentence_Break values, in the order of the SentenceBreak enum in text_segmentation.cpp
+SB_OTHER, SB_CR, SB_LF, SB_EXTEND, SB_SEP, SB_FORMAT, SB_SP, SB_LOWER, SB_UPPER, SB_OLETTER, \
+    SB_NUMERIC, SB_ATERM, SB_SCONTINUE, SB_STERM, SB_CLOSE = range(15)
+
+# Token content classes: word characters, and characters of scripts written
+# without spaces between words (which are not sent to the spell checker)
+CLS_NONE, CLS_WORD, CLS_NO_SPACE_SCRIPT = range(3)
+
+MID_LETTER = {0x003A, 0x00B7, 0x0387, 0x055F, 0x05F4, 0x2027, 0xFE13, 0xFE55, 0xFF1A}
+MID_NUM = {0x002C, 0x003B, 0x037E, 0x0589, 0x060C, 0x060D, 0x066C, 0x07F8, 0x2044,
+           0xFE10, 0xFE14, 0xFE50, 0xFE54, 0xFF0C, 0xFF1B}
+MID_NUM_LET = {0x002E, 0x2018, 0x2019, 0x2024, 0xFE52, 0xFF07, 0xFF0E}
+NEWLINE = {0x000B, 0x000C, 0x0085, 0x2028, 0x2029}
+NO_BREAK_SPACES = {0x00A0, 0x2007, 0x202F}
+KATAKANA_EXTRAS = {0x3031, 0x3032, 0x3033, 0x3034, 0x3035, 0x309B, 0x309C, 0x30A0, 0x30FC, 0xFF70}
+
+SENTENCE_SEPARATORS = {0x0085, 0x2028, 0x2029}
+ATERM = {0x002E, 0x2024, 0xFE52, 0xFF0E}
+STERM = {0x0021, 0x003F, 0x0589, 0x061D, 0x061E, 0x061F, 0x06D4, 0x0700, 0x0701, 0x0702,
+         0x07F9, 0x0837, 0x0839, 0x083D, 0x083E, 0x0964, 0x0965, 0x104A, 0x104B, 0x1362,
+         0x1367, 0x1368, 0x166E, 0x1735, 0x1736, 0x1803, 0x1809, 0x1944, 0x1945, 0x1AA8,
+         0x1AA9, 0x1AAA, 0x1AAB, 0x1B5A, 0x1B5B, 0x1B5E, 0x1B5F, 0x1C3B, 0x1C3C, 0x1C7E,
+         0x1C7F, 0x203C, 0x203D, 0x2047, 0x2048, 0x2049, 0x2E2E, 0x2E3C, 0x3002, 0xA4FF,
+         0xA60E, 0xA60F, 0xA6F3, 0xA6F7, 0xA876, 0xA877, 0xA8CE, 0xA8CF, 0xA92F, 0xA9C8,
+         0xA9C9, 0xAA5D, 0xAA5E, 0xAA5F, 0xAAF0, 0xAAF1, 0xABEB, 0xFE56, 0xFE57, 0xFF01,
+         0xFF1F, 0xFF61}
+SCONTINUE = {0x002C, 0x002D, 0x003A, 0x055D, 0x060C, 0x060D, 0x07F8, 0x1802, 0x1808, 0x2013,
+             0x2014, 0x3001, 0xFE10, 0xFE11, 0xFE13, 0xFE31, 0xFE32, 0xFE50, 0xFE51, 0xFE55,
+             0xFE58, 0xFE63, 0xFF0C, 0xFF0D, 0xFF1A, 0xFF64}
+QUOTATION_MARKS = {0x0022, 0x0027, 0x00AB, 0x00BB, 0x2018, 0x2019, 0x201A, 0x201B, 0x201C,
+                   0x201D, 0x201E, 0x201F, 0x2039, 0x203A, 0x2E42, 0x300C, 0x300D, 0x300E,
+                   0x300F, 0x301D, 0x301E, 0x301F, 0xFE41, 0xFE42, 0xFE43, 0xFE44, 0xFF02,
+                   0xFF07, 0xFF62, 0xFF63}
+
+# Blocks whose letters have Line_Break=Complex_Context and need dictionary-based
+# word segmentation, so UAX #29 leaves them as Word_Break=Other
+COMPLEX_CONTEXT_RANGES = [(0x0E00, 0x0EFF), (0x1000, 0x109F), (0x1780, 0x17FF), (0x1950, 0x19DF),
+                          (0x19E0, 0x19FF), (0x1A20, 0x1AAF), (0xA9E0, 0xA9FF), (0xAA60, 0xAADF),
+                          (0x11700, 0x1174F)]
+
+EXTENDED_PICTOGRAPHIC_RANGES = [(0x00A9, 0x00A9), (0x00AE, 0x00AE), (0x203C, 0x203C), (0x2049, 0x2049),
+                                (0x2122, 0x2122), (0x2139, 0x2139), (0x2194, 0x2199), (0x21A9, 0x21AA),
+                                (0x231A, 0x231B), (0x2328, 0x2328), (0x2388, 0x2388), (0x23CF, 0x23CF),
+                                (0x23E9, 0x23F3), (0x23F8, 0x23FA), (0x24C2, 0x24C2), (0x25AA, 0x25AB),
+                                (0x25B6, 0x25B6), (0x25C0, 0x25C0), (0x25FB, 0x25FE), (0x2600, 0x2605),
+                                (0x2607, 0x2612), (0x2614, 0x2685), (0x2690, 0x2705), (0x2708, 0x2712),
+                                (0x2714, 0x2714), (0x2716, 0x2716), (0x271D, 0x271D), (0x2721, 0x2721),
+                                (0x2728, 0x2728), (0x2733, 0x2734), (0x2744, 0x2744), (0x2747, 0x2747),
+                                (0x274C, 0x274C), (0x274E, 0x274E), (0x2753, 0x2755), (0x2757, 0x2757),
+                                (0x2763, 0x2767), (0x2795, 0x2797), (0x27A1, 0x27A1), (0x27B0, 0x27B0),
+                                (0x27BF, 0x27BF), (0x2934, 0x2935), (0x2B05, 0x2B07), (0x2B1B, 0x2B1C),
+                                (0x2B50, 0x2B50), (0x2B55, 0x2B55), (0x3030, 0x3030), (0x303D, 0x303D),
+                                (0x3297, 0x3297), (0x3299, 0x3299), (0x1F000, 0x1F0FF), (0x1F10D, 0x1F10F),
+                                (0x1F12F, 0x1F12F), (0x1F16C, 0x1F171), (0x1F17E, 0x1F17F), (0x1F18E, 0x1F18E),
+                                (0x1F191, 0x1F19A), (0x1F1AD, 0x1F1E5), (0x1F201, 0x1F20F), (0x1F21A, 0x1F21A),
+                                (0x1F22F, 0x1F22F), (0x1F232, 0x1F23A), (0x1F23C, 0x1F23F), (0x1F249, 0x1F3FA),
+                                (0x1F400, 0x1F53D), (0x1F546, 0x1F64F), (0x1F680, 0x1F6FF), (0x1F774, 0x1F77F),
+                                (0x1F7D5, 0x1F7FF), (0x1F80C, 0x1F80F), (0x1F848, 0x1F84F), (0x1F85A, 0x1F85F),
+                                (0x1F888, 0x1F88F), (0x1F8AE, 0x1F8FF), (0x1F90C, 0x1F93A), (0x1F93C, 0x1F945),
+                                (0x1F947, 0x1FAFF), (0x1FC00, 0x1FFFD)]
+
+def setup_logging():
+    """Sets up logging configuration"""
+    logging.basicConfig(format='%(asctime)s - %(name)s - %(levelname)s - %(message)s', level=logging.INFO)
+
+def parse_arguments():
+    """Parses command-line arguments"""
+    parser = argparse.ArgumentParser(description="Generate Unicode word and sentence break property tables")
+    parser.add_argument('--output', default=OUTPUT_PATH, help="Path of the generated table file")
+    return parser.parse_args()
+
+def in_ranges(cp, ranges):
+    """Returns True if the code point lies in one of the inclusive ranges"""
+    return any(start <= cp <= end for start, end in ranges)
+
+def is_extend(cp, category):
+    """Grapheme_Extend or SpacingMark, approximated from the general category"""
+    return category in ('Mn', 'Me', 'Mc') or cp == 0x200C or 0x1F3FB <= cp <= 0x1F3FF
+
+def script_kind(cp, category):
+    """Classifies letters of scripts that UAX #29 does not treat as ALetter"""
+    if category not in ('Lo', 'Lm', 'Nl'):
+        return None
+    name = unicodedata.name(chr(cp), '')
+    if 'KATAKANA' in name or cp in KATAKANA_EXTRAS:
+        return 'katakana'
+    if 'HIRAGANA' in name or 'IDEOGRAPH' in name or 0x3005 <= cp <= 0x3007 or 0x3021 <= cp <= 0x3029:
+        return 'ideographic'
+    if in_ranges(cp, COMPLEX_CONTEXT_RANGES):
+        return 'complex'
+    if name.startswith('HEBREW LETTER'):
+        return 'hebrew'
+    return None
+
+def word_break(cp, category):
+    """Derives the Word_Break property of a code point"""
+    if cp == 0x000D:
+        return WB_CR
+    if cp == 0x000A:
+        return WB_LF
+    if cp in NEWLINE:
+        return WB_NEWLINE
+    if cp == 0x200D:
+        return WB_ZWJ
+    if is_extend(cp, category):
+        return WB_EXTEND
+    if 0x1F1E6 <= cp <= 0x1F1FF:
+        return WB_REGIONAL_INDICATOR
+    if category == 'Cf' and cp not in (0x200B, 0x200C, 0x200D):
+        return WB_FORMAT
+    kind = script_kind(cp, category)
+    if kind == 'katakana':
+        return WB_KATAKANA
+    if kind == 'hebrew':
+        return WB_HEBREW_LETTER
+    if kind is None and category in ('Lu', 'Ll', 'Lt', 'Lm', 'Lo', 'Nl'):
+        return WB_ALETTER
+    if cp == 0x0027:
+        return WB_SINGLE_QUOTE
+    if cp == 0x0022:
+        return WB_DOUBLE_QUOTE
+    if cp in MID_NUM_LET:
+        return WB_MID_NUM_LET
+    if cp in MID_LETTER:
+        return WB_MID_LETTER
+    if cp in MID_NUM:
+        return WB_MID_NUM
+    if category == 'Nd':
+        return WB_NUMERIC
+    if category == 'Pc' or cp == 0x202F:
+        return WB_EXTEND_NUM_LET
+    if category == 'Zs' and cp not in NO_BREAK_SPACES:
+        return WB_WSEG_SPACE
+    if in_ranges(cp, EXTENDED_PICTOGRAPHIC_RANGES):
+        return WB_EXT_PICT
+    return WB_OTHER
+
+def sentence_break(cp, category):
+    """Derives the Sentence_Break property of a code point"""
+    if cp == 0x000D:
+        return SB_CR
+    if cp == 0x000A:
+        return SB_LF
+    if cp in SENTENCE_SEPARATORS:
+        return SB_SEP
+    if is_extend(cp, category) or cp == 0x200D:
+        return SB_EXTEND
+    if category == 'Cf' and cp not in (0x200B, 0x200C, 0x200D):
+        return SB_FORMAT
+    if category == 'Zs' or cp in (0x0009, 0x000B, 0x000C):
+        return SB_SP
+    if category == 'Ll':
+        return SB_LOWER
+    if category in ('Lu', 'Lt'):
+        return SB_UPPER
+    if category in ('Lm', 'Lo', 'Nl'):
+        return SB_OLETTER
+    if category == 'Nd':
+        return SB_NUMERIC
+    if cp in ATERM:
+        return SB_ATERM
+    if cp in STERM:
+        return SB_STERM
+    if cp in SCONTINUE:
+        return SB_SCONTINUE
+    if category in ('Ps', 'Pe', 'Pi', 'Pf') or cp in QUOTATION_MARKS:
+        return SB_CLOSE
+    return SB_OTHER
+
+def content_class(cp, category):
+    """Determines whether a code point makes its segment a word"""
+    kind = script_kind(cp, category)
+    if kind in ('katakana', 'ideographic', 'complex'):
+        return CLS_NO_SPACE_SCRIPT
+    if category[0] == 'L' or category in ('Nd', 'Nl', 'No'):
+        return CLS_WORD
+    return CLS_NONE
+
+def build_runs():
+    """Collapses the per-code-point properties into runs of identical values"""
+    runs = []
+    previous = None
+    for cp in range(MAX_CODE_POINT + 1):
+        category = unicodedata.category(chr(cp))
+        packed = (word_break(cp, category) << 6) | (sentence_break(cp, category) << 2) | content_class(cp, category)
+        if packed != previous:
+            runs.append((cp << 11) | packed)
+            previous = packed
+    return runs
+
+def write_table(runs, output_path):
+    """Writes the runs as a C++ array fragment included by text_segmentation.cpp"""
+    with open(output_path, 'w', newline='\n') as out:
+        out.write('// Generated by src/scripts/generate_unicode_tables.py from Unicode %s data. Do not edit.\n'
+                  % unicodedata.unidata_version)
+        out.write('//\n')
+        out.write('// Each entry starts a run of code points sharing the same properties:\n')
+        out.write('// bits 31-11 first code point, 10-6 WordBreak, 5-2 SentenceBreak, 1-0 ContentClass.\n\n')
+        out.write('static const uint32_t BREAK_PROPERTY_RUNS[%d] = {\n' % len(runs))
+        for i in range(0, len(runs), 8):
+            out.write('    ' + ', '.join('0x%08X' % run for run in runs[i:i + 8]) + ',\n')
+        out.write('};\n')
+
+def main():
+    """Main function to generate the break property tables"""
+    setup_logging()
+    args = parse_arguments()
+
+    runs = build_runs()
+    write_table(runs, args.output)
+
+    logger.info(f"Wrote {len(runs)} property runs ({len(runs) * 4} bytes) to {args.output}")
+    return 0
+
+if __name__ == '__main__':
+    sys.exit(main())
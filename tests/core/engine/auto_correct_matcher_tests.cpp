@@ -0,0 +1,176 @@
+#include <catch2/catch.hpp>
+#include "../../src/core/engine/auto_correct_matcher.h"
+#include "../../src/core/engine/auto_correct.h"
+#include <string>
+#include <string_view>
+#include <unordered_map>
+#include <vector>
+
+// Helper function to apply a matcher's rules to a text
+std::string correctText(const AutoCorrectMatcher& matcher, std::string text) {
+    std::vector<AutoCorrectMatcher::Match> matches;
+    matcher.findMatches(text, matches);
+    applyAutoCorrectMatches(text, matches);
+    return text;
+}
+
+// Helper function to type a text at the end of a document the way an editor
+// would, applying each replacement to the document as it is returned
+std::string typeText(AutoCorrect& autoCorrect, const std::string& text, std::string document = "") {
+    for (char c : text) {
+        document.push_back(c);
+        auto replacement = autoCorrect.typeCharacter(c);
+        if (replacement) {
+            document.replace(replacement->offset, replacement->length, replacement->text);
+        }
+    }
+    return document;
+}
+
+TEST_CASE("AutoCorrectMatcher", "[auto_correct]") {
+    SECTION("PreservesSpacing") {
+        AutoCorrectMatcher matcher({{"teh", "the"}, {"adn", "and"}});
+        REQUIRE(correctText(matcher, "teh cat\tadn\n\nteh  dog, adn teh.") == "the cat\tand\n\nthe  dog, and the.");
+        REQUIRE(correctText(matcher, "") == "");
+        REQUIRE(correctText(AutoCorrectMatcher(), "teh cat") == "teh cat");
+    }
+
+    SECTION("WholeWordsOnly") {
+        AutoCorrectMatcher matcher({{"teh", "the"}, {"adn", "and"}});
+        REQUIRE(correctText(matcher, "tehran steh teh2 teh") == "tehran steh teh2 the");
+        REQUIRE(correctText(matcher, "(teh)") == "(the)");
+    }
+
+    SECTION("MultiWordAndPunctuationRules") {
+        AutoCorrectMatcher matcher({{"(c)", "©"}, {"-->", "→"}, {"a lot of", "many"}, {"lot", "plenty"}});
+        REQUIRE(correctText(matcher, "a lot of cats (c) 2024 --> dogs") == "many cats © 2024 → dogs");
+
+        // Rules spanning words still need word boundaries at their ends
+        REQUIRE(correctText(matcher, "a lot ofcats") == "a plenty ofcats");
+        REQUIRE(correctText(matcher, "x-->y") == "x→y");
+    }
+
+    SECTION("LeftmostLongestWins") {
+        AutoCorrectMatcher matcher({{"new york", "New York"}, {"york city", "York City"}, {"new", "old"}});
+        REQUIRE(correctText(matcher, "new york city") == "New York city");
+        REQUIRE(correctText(matcher, "new yorkshire") == "old yorkshire");
+    }
+
+    SECTION("CapitalisationCarriesOver") {
+        AutoCorrectMatcher matcher({{"teh", "the"}, {"Smtih", "Smith"}, {"i", "I"}});
+        REQUIRE(correctText(matcher, "Teh cat. teh dog. TEH end.") == "The cat. the dog. TEH end.");
+        REQUIRE(correctText(matcher, "smtih Smtih i") == "smtih Smith I");
+    }
+
+    SECTION("ManyRules") {
+        // Every rule is found in one scan, whatever the number of rules
+        std::unordered_map<std::string, std::string> rules;
+        std::string text;
+        std::string expected;
+        for (int i = 0; i < 5000; ++i) {
+            rules["wrong" + std::to_string(i)] = "right" + std::to_string(i);
+            if (i % 100 == 0) {
+                text += "wrong" + std::to_string(i) + " ";
+                expected += "right" + std::to_string(i) + " ";
+            }
+        }
+        AutoCorrectMatcher matcher(std::vector<std::pair<std::string_view, std::string_view>>(rules.begin(), rules.end()));
+        REQUIRE(matcher.ruleCount() == 5000);
+        REQUIRE(correctText(matcher, text) == expected);
+    }
+}
+
+TEST_CASE("AutoCorrect", "[auto_correct]") {
+    SECTION("UserRulesTakePriority") {
+        AutoCorrect autoCorrect;
+        autoCorrect.loadLanguageSpecificRules("en_US");
+        std::string text = "teh cat,\nteh dog";
+        autoCorrect.applyAutoCorrect(text);
+        REQUIRE(text == "the cat,\nthe dog");
+
+        // A user rule for the same word replaces the language rule
+        REQUIRE(autoCorrect.addAutoCorrectRule("teh", "THE"));
+        text = "teh cat,\nTeh dog";
+        autoCorrect.applyAutoCorrect(text);
+        REQUIRE(text == "THE cat,\nTHE dog");
+
+        // Removing it masks the language rule as well
+        REQUIRE(autoCorrect.removeAutoCorrectRule("teh"));
+        text = "teh cat";
+        autoCorrect.applyAutoCorrect(text);
+        REQUIRE(text == "teh cat");
+    }
+
+    SECTION("TypingCorrectsAtBoundaries") {
+        AutoCorrect autoCorrect;
+        REQUIRE(autoCorrect.addAutoCorrectRule("teh", "the"));
+        REQUIRE(autoCorrect.addAutoCorrectRule("(c)", "©"));
+
+        // Nothing happens until the word is complete
+        for (char c : std::string("teh")) {
+            REQUIRE_FALSE(autoCorrect.typeCharacter(c));
+        }
+        auto replacement = autoCorrect.typeCharacter(' ');
+        REQUIRE(replacement);
+        REQUIRE(replacement->offset == 0);
+        REQUIRE(replacement->length == 3);
+        REQUIRE(replacement->text == "the");
+
+        // Offsets continue in the corrected text until the typing is reset
+        REQUIRE(typeText(autoCorrect, "Teh tehran (c)\n", "the ") == "the The tehran ©\n");
+        autoCorrect.resetTyping();
+        REQUIRE(typeText(autoCorrect, "x teh.") == "x the.");
+    }
+
+    SECTION("TypingMatchesWholeText") {
+        AutoCorrect autoCorrect;
+        autoCorrect.loadLanguageSpecificRules("en_US");
+        REQUIRE(autoCorrect.addAutoCorrectRule("new yrok", "New York"));
+
+        // A long paragraph, so the typed text is trimmed many times over
+        std::string text;
+        for (int i = 0; i < 5000; ++i) {
+            text += i % 7 == 0 ? "Teh cat\t" : i % 5 == 0 ? "in new yrok, " : "adn teh dog ";
+        }
+        std::string expected = text;
+        autoCorrect.applyAutoCorrect(expected);
+        REQUIRE(typeText(autoCorrect, text) == expected);
+
+        // Rules added while typing apply from the next boundary
+        autoCorrect.resetTyping();
+        std::string document = typeText(autoCorrect, "one wrod ");
+        REQUIRE(autoCorrect.addAutoCorrectRule("wrod", "word"));
+        REQUIRE(typeText(autoCorrect, "two wrod ", document) == "one wrod two word ");
+    }
+
+    SECTION("RuleSnapshots") {
+        AutoCorrect autoCorrect;
+        autoCorrect.loadLanguageSpecificRules("en_US");
+        AutoCorrectRules before = autoCorrect.getAutoCorrectRules();
+        REQUIRE(before.find("teh") == std::string_view("the"));
+        REQUIRE_FALSE(before.find("wrod"));
+
+        // A user rule overrides a language rule and adds one of its own
+        REQUIRE(autoCorrect.addAutoCorrectRule("teh", "THE"));
+        REQUIRE(autoCorrect.addAutoCorrectRule("wrod", "word"));
+        REQUIRE(autoCorrect.removeAutoCorrectRule("adn"));
+        AutoCorrectRules after = autoCorrect.getAutoCorrectRules();
+        REQUIRE(after.find("teh") == std::string_view("THE"));
+        REQUIRE(after.find("wrod") == std::string_view("word"));
+        REQUIRE_FALSE(after.find("adn"));
+        REQUIRE(after.size() == before.size());
+
+        // Every rule in effect is visited once
+        size_t visited = 0;
+        after.forEach([&visited](std::string_view incorrect, std::string_view) {
+            REQUIRE(incorrect != "adn");
+            ++visited;
+        });
+        REQUIRE(visited == after.size());
+
+        // Snapshots taken earlier are unaffected by the changes
+        REQUIRE(before.find("teh") == std::string_view("the"));
+        REQUIRE(before.find("adn") == std::string_view("and"));
+        REQUIRE_FALSE(before.find("wrod"));
+    }
+}
@@ -0,0 +1,224 @@
+#include "../../../src/core/engine/symspell_index.h"
+#include <hunspell/hunspell.hxx>
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <fstream>
+#include <functional>
+#include <iostream>
+#include <string>
+#include <vector>
+
+// Suggestion latency and quality benchmark: Hunspell::suggest against the
+// symmetric-delete index of SpellCheck's SymSpell backend.
+//
+// Usage: suggestion_benchmark --dictionary-dir DIR [--corpus-dir DIR]
+//                             [--output FILE] [--iterations N]
+//
+// For every corpora/misspellings_<lang>.tsv with a matching <code>.aff/.dic in
+// the dictionary directory, each misspelling is looked up with both engines.
+// Quality is the share of misspellings whose intended word is the first
+// suggestion (top1) or among the first five (top5). The index is loaded from
+// <code>.symspell when present and built from the dictionary otherwise; the
+// build time is reported separately. Results use the same JSON layout as
+// text_processing_benchmark, plus the quality fields, so src/scripts/benchmark.py
+// can compare both against the baseline.
+
+const int DEFAULT_ITERATIONS = 3;
+const size_t SUGGESTION_LIMIT = 5;
+
+struct Misspelling {
+    std::string misspelled;
+    std::string intended;
+};
+
+struct SuggestionResult {
+    std::string corpus;
+    std::string stage;
+    size_t bytes = 0;
+    size_t words = 0;
+    double seconds = 0.0;
+    double p50Microseconds = 0.0;
+    double p99Microseconds = 0.0;
+    double top1 = 0.0;
+    double top5 = 0.0;
+};
+
+// Helper function to load tab-separated "misspelling<TAB>intended" pairs
+std::vector<Misspelling> loadMisspellings(const std::string& path) {
+    std::vector<Misspelling> misspellings;
+    std::ifstream file(path, std::ios::binary);
+    std::string line;
+    while (std::getline(file, line)) {
+        size_t tab = line.find('\t');
+        if (tab != std::string::npos && tab > 0) {
+            misspellings.push_back({line.substr(0, tab), line.substr(tab + 1)});
+        }
+    }
+    return misspellings;
+}
+
+// Helper function to return the given percentile of the latency samples
+double percentile(std::vector<double> samples, double fraction) {
+    if (samples.empty()) {
+        return 0.0;
+    }
+    size_t index = std::min(samples.size() - 1, static_cast<size_t>(fraction * static_cast<double>(samples.size())));
+    std::nth_element(samples.begin(), samples.begin() + index, samples.end());
+    return samples[index];
+}
+
+// Runs one suggestion engine over every misspelling and records latency and quality
+SuggestionResult runEngine(const std::string& corpus, const std::string& stage, const std::vector<Misspelling>& misspellings,
+                           int iterations, const std::function<std::vector<std::string>(const std::string&)>& suggest) {
+    using Clock = std::chrono::steady_clock;
+
+    SuggestionResult result;
+    result.corpus = corpus;
+    result.stage = stage;
+
+    std::vector<double> latencies;
+    size_t top1 = 0;
+    size_t top5 = 0;
+    for (int iteration = 0; iteration < iterations; ++iteration) {
+        for (const auto& misspelling : misspellings) {
+            auto start = Clock::now();
+            std::vector<std::string> suggestions = suggest(misspelling.misspelled);
+            std::chrono::duration<double> elapsed = Clock::now() - start;
+            result.seconds += elapsed.count();
+            latencies.push_back(elapsed.count() * 1e6);
+            result.bytes += misspelling.misspelled.size();
+            result.words += 1;
+
+            if (iteration == 0) {
+                auto found = std::find(suggestions.begin(), suggestions.end(), misspelling.intended);
+                top1 += found == suggestions.begin() && found != suggestions.end() ? 1 : 0;
+                top5 += found != suggestions.end() && found - suggestions.begin() < static_cast<long>(SUGGESTION_LIMIT) ? 1 : 0;
+            }
+        }
+    }
+
+    double count = static_cast<double>(std::max<size_t>(1, misspellings.size()));
+    result.p50Microseconds = percentile(latencies, 0.50);
+    result.p99Microseconds = percentile(latencies, 0.99);
+    result.top1 = static_cast<double>(top1) / count;
+    result.top5 = static_cast<double>(top5) / count;
+    return result;
+}
+
+// Helper function to escape a string for JSON output
+std::string jsonString(const std::string& value) {
+    std::string escaped = "\"";
+    for (char c : value) {
+        if (c == '"' || c == '\\') {
+            escaped += '\\';
+        }
+        escaped += c;
+    }
+    return escaped + "\"";
+}
+
+void writeResults(const std::vector<SuggestionResult>& results, int iterations, std::ostream& out) {
+    out << "{\n  \"schema\": 1,\n  \"iterations\": " << iterations << ",\n  \"results\": [\n";
+    for (size_t i = 0; i < results.size(); ++i) {
+        const auto& r = results[i];
+        double seconds = std::max(r.seconds, 1e-9);
+        char line[640];
+        std::snprintf(line, sizeof(line),
+                      "    {\"corpus\": %s, \"stage\": %s, \"bytes\": %zu, \"words\": %zu, \"seconds\": %.6f, "
+                      "\"mb_per_s\": %.3f, \"words_per_s\": %.1f, \"p50_us\": %.2f, \"p99_us\": %.2f, "
+                      "\"top1\": %.3f, \"top5\": %.3f}%s\n",
+                      jsonString(r.corpus).c_str(), jsonString(r.stage).c_str(), r.bytes, r.words, r.seconds,
+                      static_cast<double>(r.bytes) / seconds / 1e6, static_cast<double>(r.words) / seconds,
+                      r.p50Microseconds, r.p99Microseconds, r.top1, r.top5, i + 1 == results.size() ? "" : ",");
+        out << line;
+    }
+    out << "  ]\n}\n";
+}
+
+int main(int argc, char** argv) {
+    std::string corpusDir = "tests/core/engine/benchmarks/corpora";
+    std::string outputPath = "suggestion_output.json";
+    std::string dictionaryDir;
+    int iterations = DEFAULT_ITERATIONS;
+
+    for (int i = 1; i < argc; i += 2) {
+        std::string option = argv[i];
+        if (i + 1 == argc) {
+            std::cerr << "Missing value for option: " << option << std::endl;
+            return 2;
+        }
+        std::string value = argv[i + 1];
+        if (option == "--corpus-dir") {
+            corpusDir = value;
+        } else if (option == "--output") {
+            outputPath = value;
+        } else if (option == "--iterations") {
+            iterations = std::max(1, std::atoi(value.c_str()));
+        } else if (option == "--dictionary-dir") {
+            dictionaryDir = value;
+        } else {
+            std::cerr << "Unknown option: " << option << std::endl;
+            return 2;
+        }
+    }
+    if (dictionaryDir.empty()) {
+        std::cerr << "Usage: suggestion_benchmark --dictionary-dir DIR [--corpus-dir DIR] [--output FILE] [--iterations N]"
+                  << std::endl;
+        return 2;
+    }
+
+    static const std::pair<const char*, const char*> MISSPELLING_CORPORA[] = {
+        {"en", "en_US"}, {"de", "de_DE"}, {"fr", "fr_FR"}, {"ru", "ru_RU"}
+    };
+
+    std::vector<SuggestionResult> results;
+    for (const auto& entry : MISSPELLING_CORPORA) {
+        auto misspellings = loadMisspellings(corpusDir + "/misspellings_" + entry.first + ".tsv");
+        std::string dictionaryPath = dictionaryDir + "/" + entry.second;
+        if (misspellings.empty() || !std::ifstream(dictionaryPath + ".dic")) {
+            continue;
+        }
+        std::string corpus = std::string("misspellings_") + entry.first;
+
+        Hunspell hunspell((dictionaryPath + ".aff").c_str(), (dictionaryPath + ".dic").c_str());
+        results.push_back(runEngine(corpus, "suggest_hunspell", misspellings, iterations, [&](const std::string& word) {
+            std::vector<std::string> suggestions = hunspell.suggest(word);
+            suggestions.resize(std::min(suggestions.size(), SUGGESTION_LIMIT));
+            return suggestions;
+        }));
+
+        auto buildStart = std::chrono::steady_clock::now();
+        auto index = SymSpellIndex::load(dictionaryPath + ".symspell");
+        if (!index) {
+            index = SymSpellIndex::buildFromDictionary(dictionaryPath, [&](const std::string& word) {
+                return hunspell.spell(word);
+            });
+        }
+        std::chrono::duration<double> buildSeconds = std::chrono::steady_clock::now() - buildStart;
+        if (!index) {
+            continue;
+        }
+        std::printf("%-18s symspell index: %zu words, %.1f MB, ready in %.2f s\n", corpus.c_str(), index->wordCount(),
+                    static_cast<double>(index->memoryBytes()) / 1e6, buildSeconds.count());
+
+        results.push_back(runEngine(corpus, "suggest_symspell", misspellings, iterations, [&](const std::string& word) {
+            return index->lookup(word, SUGGESTION_LIMIT);
+        }));
+    }
+
+    for (const auto& r : results) {
+        std::printf("%-18s %-17s p50 %10.2f us  p99 %10.2f us  top1 %5.1f%%  top5 %5.1f%%\n",
+                    r.corpus.c_str(), r.stage.c_str(), r.p50Microseconds, r.p99Microseconds,
+                    r.top1 * 100.0, r.top5 * 100.0);
+    }
+
+    std::ofstream output(outputPath);
+    if (!output) {
+        std::cerr << "Failed to open output file: " << outputPath << std::endl;
+        return 1;
+    }
+    writeResults(results, iterations, output);
+    return 0;
+}
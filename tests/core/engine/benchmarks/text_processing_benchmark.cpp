@@ -0,0 +1,385 @@
+#include "../../../src/core/engine/text_processing.h"
+#include "../../../src/core/engine/text_segmentation.h"
+#include "../../../src/core/engine/spell_check.h"
+#include "../../../src/core/engine/grammar_check.h"
+#include "../../../src/core/engine/auto_correct.h"
+#include "../../../src/core/engine/compiled_dictionary.h"
+#include <hunspell/hunspell.hxx>
+#include <algorithm>
+#include <cctype>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <fstream>
+#include <functional>
+#include <iostream>
+#include <random>
+#include <sstream>
+#include <string>
+#include <vector>
+
+// Throughput and latency benchmark for the text-processing engine.
+//
+// Usage: text_processing_benchmark [--corpus-dir DIR] [--output FILE]
+//                                  [--iterations N] [--target-bytes N]
+//                                  [--dictionary-dir DIR]
+//
+// Real-world corpora are public-domain excerpts, repeated up to the target size:
+//   en.txt  Dickens, "A Tale of Two Cities"; Austen, "Pride and Prejudice"
+//   de.txt  Kafka, "Die Verwandlung"
+//   fr.txt  Hugo, "Les Misérables"; Flaubert, "Madame Bovary"
+//   ru.txt  Tolstoy, "Anna Karenina"
+//   ja.txt  Natsume Soseki, "I Am a Cat"
+// The synthetic corpus is generated from a fixed seed so every run measures the
+// same text. Repeated excerpts are mostly answered by the spelling verdict and
+// grammar result caches, so spell_check and grammar_check measure warm caches;
+// their _cold stages run with both caches disabled and measure the checkers. With --dictionary-dir, corpora whose language has both
+// <code>.aff/.dic and a compiled <code>.cdic there also compare the compiled
+// dictionary, including its known-word set, with Hunspell on the same words.
+// Results are written as JSON for src/scripts/benchmark.py to compare
+// against the stored baseline.
+
+const size_t DEFAULT_TARGET_BYTES = 1024 * 1024; // Each corpus is repeated up to about 1 MB
+const int DEFAULT_ITERATIONS = 3;
+const unsigned SYNTHETIC_SEED = 20240601;
+
+struct Corpus {
+    std::string name;
+    std::string languageCode;
+    std::vector<std::string> paragraphs;
+    size_t bytes = 0;
+    size_t words = 0;
+};
+
+struct StageResult {
+    std::string corpus;
+    std::string stage;
+    size_t bytes = 0;
+    size_t words = 0;
+    double seconds = 0.0;
+    double p50Microseconds = 0.0;
+    double p99Microseconds = 0.0;
+};
+
+// Helper function to split text into non-empty paragraphs
+std::vector<std::string> splitParagraphs(const std::string& text) {
+    std::vector<std::string> paragraphs;
+    std::istringstream stream(text);
+    std::string line;
+    while (std::getline(stream, line)) {
+        if (!line.empty()) {
+            paragraphs.push_back(line);
+        }
+    }
+    return paragraphs;
+}
+
+// Helper function to repeat paragraphs until the corpus reaches the target size
+Corpus buildCorpus(const std::string& name, const std::string& languageCode,
+                   const std::vector<std::string>& source, size_t targetBytes) {
+    Corpus corpus;
+    corpus.name = name;
+    corpus.languageCode = languageCode;
+    while (!source.empty() && corpus.bytes < targetBytes) {
+        for (const auto& paragraph : source) {
+            corpus.paragraphs.push_back(paragraph);
+            corpus.bytes += paragraph.size() + 1;
+        }
+    }
+    for (const auto& paragraph : corpus.paragraphs) {
+        for (const auto& token : tokenizeText(paragraph)) {
+            corpus.words += token.type == TokenType::Word ? 1 : 0;
+        }
+    }
+    return corpus;
+}
+
+// Helper function to generate English-like text with a Zipf word distribution
+// and about three percent misspelled words
+std::vector<std::string> generateSyntheticParagraphs(size_t targetBytes) {
+    static const char* VOCABULARY[] = {
+        "the", "of", "and", "to", "in", "a", "is", "that", "for", "it", "as", "was", "with", "be",
+        "by", "on", "not", "he", "this", "are", "or", "his", "from", "at", "which", "but", "have",
+        "an", "had", "they", "you", "were", "their", "one", "all", "we", "can", "her", "has",
+        "there", "been", "if", "more", "when", "will", "would", "who", "so", "no", "agreement",
+        "party", "document", "shall", "provided", "section", "receive", "separate", "necessary",
+        "occurrence", "accommodate", "government", "environment", "information", "development"
+    };
+    const size_t vocabularySize = sizeof(VOCABULARY) / sizeof(VOCABULARY[0]);
+
+    std::mt19937 random(SYNTHETIC_SEED);
+    std::vector<double> weights;
+    for (size_t i = 0; i < vocabularySize; ++i) {
+        weights.push_back(1.0 / static_cast<double>(i + 1));
+    }
+    std::discrete_distribution<size_t> wordChoice(weights.begin(), weights.end());
+    std::uniform_int_distribution<int> sentenceLength(5, 25);
+    std::uniform_int_distribution<int> paragraphLength(3, 8);
+    std::uniform_int_distribution<int> percent(0, 99);
+
+    std::vector<std::string> paragraphs;
+    size_t bytes = 0;
+    while (bytes < targetBytes) {
+        std::string paragraph;
+        int sentences = paragraphLength(random);
+        for (int s = 0; s < sentences; ++s) {
+            int words = sentenceLength(random);
+            for (int w = 0; w < words; ++w) {
+                std::string word = VOCABULARY[wordChoice(random)];
+                if (percent(random) < 3 && word.size() > 3) {
+                    // Transpose two letters to produce a realistic typo
+                    std::swap(word[1], word[2]);
+                }
+                if (w == 0) {
+                    word[0] = static_cast<char>(std::toupper(static_cast<unsigned char>(word[0])));
+                }
+                paragraph += word;
+                paragraph += w + 1 == words ? ". " : (percent(random) < 8 ? ", " : " ");
+            }
+        }
+        paragraph.pop_back();
+        bytes += paragraph.size() + 1;
+        paragraphs.push_back(std::move(paragraph));
+    }
+    return paragraphs;
+}
+
+// Helper function to load a corpus file from the corpus directory
+std::vector<std::string> loadCorpusFile(const std::string& path) {
+    std::ifstream file(path, std::ios::binary);
+    if (!file) {
+        std::cerr << "Failed to open corpus file: " << path << std::endl;
+        return {};
+    }
+    std::string text((std::istreambuf_iterator<char>(file)), std::istreambuf_iterator<char>());
+    return splitParagraphs(text);
+}
+
+// Helper function to return the given percentile of the latency samples
+double percentile(std::vector<double> samples, double fraction) {
+    if (samples.empty()) {
+        return 0.0;
+    }
+    size_t index = std::min(samples.size() - 1, static_cast<size_t>(fraction * static_cast<double>(samples.size())));
+    std::nth_element(samples.begin(), samples.begin() + index, samples.end());
+    return samples[index];
+}
+
+// Runs one operation over every paragraph of the corpus and records the total
+// time and the per-paragraph latency distribution
+StageResult runStage(const Corpus& corpus, const std::string& stage, int iterations,
+                     const std::function<void(const std::string&)>& operation) {
+    using Clock = std::chrono::steady_clock;
+
+    // Warm up caches and lazily loaded resources before measuring
+    for (size_t i = 0; i < std::min<size_t>(10, corpus.paragraphs.size()); ++i) {
+        operation(corpus.paragraphs[i]);
+    }
+
+    std::vector<double> latencies;
+    latencies.reserve(corpus.paragraphs.size() * iterations);
+    double totalSeconds = 0.0;
+    for (int iteration = 0; iteration < iterations; ++iteration) {
+        for (const auto& paragraph : corpus.paragraphs) {
+            auto start = Clock::now();
+            operation(paragraph);
+            std::chrono::duration<double> elapsed = Clock::now() - start;
+            totalSeconds += elapsed.count();
+            latencies.push_back(elapsed.count() * 1e6);
+        }
+    }
+
+    StageResult result;
+    result.corpus = corpus.name;
+    result.stage = stage;
+    result.bytes = corpus.bytes * iterations;
+    result.words = corpus.words * iterations;
+    result.seconds = totalSeconds;
+    result.p50Microseconds = percentile(latencies, 0.50);
+    result.p99Microseconds = percentile(latencies, 0.99);
+    return result;
+}
+
+std::vector<StageResult> benchmarkCorpus(const Corpus& corpus, int iterations, const std::string& dictionaryDir) {
+    std::vector<StageResult> results;
+
+    SpellCheck spellChecker;
+    spellChecker.setLanguage(corpus.languageCode);
+    GrammarCheck grammarChecker;
+    grammarChecker.setLanguage(corpus.languageCode);
+    AutoCorrect autoCorrect;
+    autoCorrect.loadLanguageSpecificRules(corpus.languageCode);
+    TextProcessing textProcessor;
+
+    results.push_back(runStage(corpus, "tokenize", iterations, [](const std::string& paragraph) {
+        auto tokens = tokenizeText(paragraph);
+        if (tokens.empty() && !paragraph.empty()) {
+            std::abort();
+        }
+    }));
+
+    auto spellCheckStage = [&](SpellCheck& checker) {
+        return [&checker](const std::string& paragraph) {
+            std::string word;
+            for (const auto& token : tokenizeText(paragraph)) {
+                if (token.type == TokenType::Word) {
+                    word.assign(token.text);
+                    checker.checkWord(word);
+                }
+            }
+        };
+    };
+    results.push_back(runStage(corpus, "spell_check", iterations, spellCheckStage(spellChecker)));
+
+    // A zero budget keeps no verdicts, so every word reaches the dictionary
+    SpellCheck coldSpellChecker;
+    coldSpellChecker.setLanguage(corpus.languageCode);
+    coldSpellChecker.setVerdictCacheBudget(0);
+    results.push_back(runStage(corpus, "spell_check_cold", iterations, spellCheckStage(coldSpellChecker)));
+
+    // Compiled dictionary against plain Hunspell, when both are available
+    std::string dictionaryPath = dictionaryDir + "/" + corpus.languageCode;
+    auto compiled = dictionaryDir.empty() ? nullptr : CompiledDictionary::open(dictionaryPath + ".cdic", dictionaryPath + ".aff",
+                                                                                   dictionaryPath + ".dic");
+    if (compiled) {
+        Hunspell hunspell((dictionaryPath + ".aff").c_str(), (dictionaryPath + ".dic").c_str());
+        std::string word;
+        results.push_back(runStage(corpus, "compiled_dictionary", iterations, [&](const std::string& paragraph) {
+            for (const auto& token : tokenizeText(paragraph)) {
+                if (token.type != TokenType::Word) {
+                    continue;
+                }
+                auto verdict = compiled->check(token.text);
+                if (verdict == CompiledDictionary::Verdict::Unknown) {
+                    word.assign(token.text);
+                    hunspell.spell(word);
+                }
+            }
+        }));
+        results.push_back(runStage(corpus, "hunspell", iterations, [&](const std::string& paragraph) {
+            for (const auto& token : tokenizeText(paragraph)) {
+                if (token.type == TokenType::Word) {
+                    word.assign(token.text);
+                    hunspell.spell(word);
+                }
+            }
+        }));
+    }
+
+    results.push_back(runStage(corpus, "grammar_check", iterations, [&](const std::string& paragraph) {
+        grammarChecker.checkParagraph(paragraph);
+    }));
+
+    GrammarCheck coldGrammarChecker;
+    coldGrammarChecker.setLanguage(corpus.languageCode);
+    coldGrammarChecker.setResultCache(nullptr);
+    results.push_back(runStage(corpus, "grammar_check_cold", iterations, [&](const std::string& paragraph) {
+        coldGrammarChecker.checkParagraph(paragraph);
+    }));
+
+    results.push_back(runStage(corpus, "auto_correct", iterations, [&](const std::string& paragraph) {
+        std::string text = paragraph;
+        autoCorrect.applyAutoCorrect(text);
+    }));
+
+    results.push_back(runStage(corpus, "process_text", iterations, [&](const std::string& paragraph) {
+        textProcessor.processText(paragraph);
+    }));
+
+    return results;
+}
+
+// Helper function to escape a string for JSON output
+std::string jsonString(const std::string& value) {
+    std::string escaped = "\"";
+    for (char c : value) {
+        if (c == '"' || c == '\\') {
+            escaped += '\\';
+        }
+        escaped += c;
+    }
+    return escaped + "\"";
+}
+
+void writeResults(const std::vector<StageResult>& results, int iterations, std::ostream& out) {
+    out << "{\n  \"schema\": 1,\n  \"iterations\": " << iterations << ",\n  \"results\": [\n";
+    for (size_t i = 0; i < results.size(); ++i) {
+        const auto& r = results[i];
+        double seconds = std::max(r.seconds, 1e-9);
+        char line[512];
+        std::snprintf(line, sizeof(line),
+                      "    {\"corpus\": %s, \"stage\": %s, \"bytes\": %zu, \"words\": %zu, \"seconds\": %.6f, "
+                      "\"mb_per_s\": %.3f, \"words_per_s\": %.1f, \"p50_us\": %.2f, \"p99_us\": %.2f}%s\n",
+                      jsonString(r.corpus).c_str(), jsonString(r.stage).c_str(), r.bytes, r.words, r.seconds,
+                      static_cast<double>(r.bytes) / seconds / 1e6, static_cast<double>(r.words) / seconds,
+                      r.p50Microseconds, r.p99Microseconds, i + 1 == results.size() ? "" : ",");
+        out << line;
+    }
+    out << "  ]\n}\n";
+}
+
+int main(int argc, char** argv) {
+    std::string corpusDir = "tests/core/engine/benchmarks/corpora";
+    std::string outputPath = "bench_output.json";
+    int iterations = DEFAULT_ITERATIONS;
+    size_t targetBytes = DEFAULT_TARGET_BYTES;
+    std::string dictionaryDir;
+
+    for (int i = 1; i < argc; i += 2) {
+        std::string option = argv[i];
+        if (i + 1 == argc) {
+            std::cerr << "Missing value for option: " << option << std::endl;
+            return 2;
+        }
+        std::string value = argv[i + 1];
+        if (option == "--corpus-dir") {
+            corpusDir = value;
+        } else if (option == "--output") {
+            outputPath = value;
+        } else if (option == "--iterations") {
+            iterations = std::max(1, std::atoi(value.c_str()));
+        } else if (option == "--dictionary-dir") {
+            dictionaryDir = value;
+        } else if (option == "--target-bytes") {
+            targetBytes = static_cast<size_t>(std::atoll(value.c_str()));
+        } else {
+            std::cerr << "Unknown option: " << option << std::endl;
+            return 2;
+        }
+    }
+
+    static const std::pair<const char*, const char*> REAL_WORLD_CORPORA[] = {
+        {"en", "en_US"}, {"de", "de_DE"}, {"fr", "fr_FR"}, {"ru", "ru_RU"}, {"ja", "ja_JP"}
+    };
+
+    std::vector<Corpus> corpora;
+    corpora.push_back(buildCorpus("synthetic", "en_US", generateSyntheticParagraphs(targetBytes), targetBytes));
+    for (const auto& entry : REAL_WORLD_CORPORA) {
+        auto paragraphs = loadCorpusFile(corpusDir + "/" + entry.first + ".txt");
+        if (paragraphs.empty()) {
+            return 1;
+        }
+        corpora.push_back(buildCorpus(entry.first, entry.second, paragraphs, targetBytes));
+    }
+
+    std::vector<StageResult> results;
+    for (const auto& corpus : corpora) {
+        auto corpusResults = benchmarkCorpus(corpus, iterations, dictionaryDir);
+        for (const auto& r : corpusResults) {
+            std::printf("%-10s %-18s %10.2f MB/s %12.0f words/s  p50 %9.2f us  p99 %9.2f us\n",
+                        r.corpus.c_str(), r.stage.c_str(),
+                        static_cast<double>(r.bytes) / std::max(r.seconds, 1e-9) / 1e6,
+                        static_cast<double>(r.words) / std::max(r.seconds, 1e-9),
+                        r.p50Microseconds, r.p99Microseconds);
+        }
+        results.insert(results.end(), corpusResults.begin(), corpusResults.end());
+    }
+
+    std::ofstream output(outputPath);
+    if (!output) {
+        std::cerr << "Failed to open output file: " << outputPath << std::endl;
+        return 1;
+    }
+    writeResults(results, iterations, output);
+    return 0;
+}
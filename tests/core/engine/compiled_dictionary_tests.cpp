@@ -0,0 +1,150 @@
+#include <catch2/catch.hpp>
+#include "../../src/core/engine/compiled_dictionary.h"
+#include <filesystem>
+#include <fstream>
+#include <string>
+#include <set>
+
+// Helper function to write a test dictionary and return its path without extension
+std::string writeTestDictionary(const std::string& name, const std::string& aff, const std::string& dic) {
+    std::string path = (std::filesystem::temp_directory_path() / name).string();
+    std::ofstream(path + ".aff") << aff;
+    std::ofstream(path + ".dic") << dic;
+    return path;
+}
+
+const std::string TEST_AFF =
+    "SET UTF-8\n"
+    "ICONV 1\n"
+    "ICONV \xE2\x80\x99 '\n"
+    "PFX A Y 1\n"
+    "PFX A 0 re .\n"
+    "SFX S Y 4\n"
+    "SFX S y ies [^aeiou]y\n"
+    "SFX S 0 s [aeiou]y\n"
+    "SFX S 0 es [sxzh]\n"
+    "SFX S 0 s [^sxzhy]\n"
+    "SFX D Y 2\n"
+    "SFX D 0 d e\n"
+    "SFX D 0 ed [^ey]\n";
+
+const std::string TEST_DIC = "6\ncat/S\nbox/S\ntry/S\npaint/ADS\nParis\nNASA\n";
+
+TEST_CASE("CompiledDictionary", "[compiled_dictionary]") {
+    std::string path = writeTestDictionary("compiled_dictionary_test", TEST_AFF, TEST_DIC);
+    std::string message;
+    REQUIRE(compileDictionary(path + ".aff", path + ".dic", path + ".cdic", message) == DictionaryCompileResult::Compiled);
+    auto dictionary = CompiledDictionary::open(path + ".cdic");
+    REQUIRE(dictionary);
+    REQUIRE(dictionary->wordCount() == 6);
+
+    using Verdict = CompiledDictionary::Verdict;
+
+    SECTION("StemsAndAffixes") {
+        // Verify stems, suffixes with conditions and cross-product prefixes
+        REQUIRE(dictionary->check("cat") == Verdict::Correct);
+        REQUIRE(dictionary->check("boxes") == Verdict::Correct);
+        REQUIRE(dictionary->check("tries") == Verdict::Correct);
+        REQUIRE(dictionary->check("repainted") == Verdict::Correct);
+        REQUIRE(dictionary->check("boxs") == Verdict::Misspelled);
+        REQUIRE(dictionary->check("recat") == Verdict::Misspelled);
+    }
+
+    SECTION("Capitalization") {
+        // Verify the case variants Hunspell accepts, and the ones it does not
+        REQUIRE(dictionary->check("Cats") == Verdict::Correct);
+        REQUIRE(dictionary->check("REPAINTED") == Verdict::Correct);
+        REQUIRE(dictionary->check("PARIS") == Verdict::Correct);
+        REQUIRE(dictionary->check("paris") == Verdict::Misspelled);
+        REQUIRE(dictionary->check("Nasa") == Verdict::Misspelled);
+        REQUIRE(dictionary->check("cAt") == Verdict::Misspelled);
+    }
+
+    SECTION("DefersToHunspell") {
+        // Verify words outside the compiled subset are left undecided
+        REQUIRE(dictionary->check("it\xE2\x80\x99s") == Verdict::Unknown);
+        REQUIRE(dictionary->check("well-known") == Verdict::Unknown);
+        REQUIRE(dictionary->check("na\xC3\xAFve") == Verdict::Unknown);
+        REQUIRE(dictionary->check("1st") == Verdict::Unknown);
+    }
+
+    SECTION("KnownWords") {
+        std::ofstream(path + ".freq") << "the 900\ncats 500\nthe 400\nteh 300\nrepainted 100\n";
+        DictionaryCompileOptions options;
+        options.frequencyListPath = path + ".freq";
+        options.isCorrect = [](const std::string& word) { return word != "teh"; };
+        REQUIRE(compileDictionary(path + ".aff", path + ".dic", path + ".known.cdic", options, message) ==
+                DictionaryCompileResult::Compiled);
+        auto known = CompiledDictionary::open(path + ".known.cdic");
+        REQUIRE(known);
+
+        // Verify only the words accepted by the reference checker are stored, and
+        // that stem lookups still answer everything else
+        REQUIRE(known->knownWordCount() == 3);
+        REQUIRE(known->check("the") == Verdict::Correct);
+        REQUIRE(known->check("teh") == Verdict::Misspelled);
+        REQUIRE(known->check("boxes") == Verdict::Correct);
+    }
+
+    SECTION("KnownWordsOnly") {
+        std::string compound = writeTestDictionary("compiled_dictionary_known_only",
+            "COMPOUNDFLAG Y\n", "2\nfoot/Y\nball/Y\n");
+        std::set<std::string> vocabulary;
+        {
+            std::ofstream list(compound + ".freq");
+            for (int i = 0; i < 20000; ++i) {
+                vocabulary.insert("word" + std::to_string(i));
+                list << "word" << i << "\n";
+            }
+        }
+        DictionaryCompileOptions options;
+        options.frequencyListPath = compound + ".freq";
+        options.isCorrect = [](const std::string&) { return true; };
+        REQUIRE(compileDictionary(compound + ".aff", compound + ".dic", compound + ".cdic", options, message) ==
+                DictionaryCompileResult::Compiled);
+        auto known = CompiledDictionary::open(compound + ".cdic");
+        REQUIRE(known);
+
+        // Verify every stored word is found through the perfect hash and other
+        // words are left to Hunspell rather than reported as misspelled
+        REQUIRE(known->knownWordCount() == vocabulary.size());
+        for (const auto& word : vocabulary) {
+            REQUIRE(known->check(word) == Verdict::Correct);
+        }
+        REQUIRE(known->check("word20000") == Verdict::Unknown);
+        REQUIRE(known->check("football") == Verdict::Unknown);
+    }
+
+    SECTION("RecompileReplacesImage") {
+        std::string other = writeTestDictionary("compiled_dictionary_recompile", TEST_AFF, "1\ndog/S\n");
+        REQUIRE(compileDictionary(other + ".aff", other + ".dic", path + ".cdic", message) == DictionaryCompileResult::Compiled);
+        REQUIRE_FALSE(std::filesystem::exists(path + ".cdic.tmp"));
+
+        // The image mapped before recompiling is untouched; new opens see the new one
+        REQUIRE(dictionary->check("cats") == Verdict::Correct);
+        auto recompiled = CompiledDictionary::open(path + ".cdic");
+        REQUIRE(recompiled);
+        REQUIRE(recompiled->check("dogs") == Verdict::Correct);
+        REQUIRE(recompiled->check("cats") == Verdict::Misspelled);
+    }
+
+    SECTION("StaleImageIsRejected") {
+        // The image matches the sources it was compiled from
+        REQUIRE(CompiledDictionary::open(path + ".cdic", path + ".aff", path + ".dic"));
+
+        // Updating the word list without recompiling makes the image stale
+        std::ofstream(path + ".dic") << TEST_DIC << "dog/S\n";
+        REQUIRE_FALSE(CompiledDictionary::open(path + ".cdic", path + ".aff", path + ".dic"));
+        REQUIRE(compileDictionary(path + ".aff", path + ".dic", path + ".cdic", message) == DictionaryCompileResult::Compiled);
+        REQUIRE(CompiledDictionary::open(path + ".cdic", path + ".aff", path + ".dic"));
+    }
+
+    SECTION("UnsupportedFeatures") {
+        std::string compound = writeTestDictionary("compiled_dictionary_compound",
+            "COMPOUNDFLAG Y\n", "2\nfoot/Y\nball/Y\n");
+
+        // Verify dictionaries relying on compounding stay with Hunspell
+        REQUIRE(compileDictionary(compound + ".aff", compound + ".dic", compound + ".cdic", message) ==
+                DictionaryCompileResult::Unsupported);
+    }
+}
@@ -0,0 +1,205 @@
+#include <catch2/catch.hpp>
+#include "../../src/core/engine/custom_dictionary.h"
+#include "../../src/core/engine/word_table.h"
+#include <algorithm>
+#include <filesystem>
+#include <fstream>
+#include <iterator>
+#include <random>
+#include <string>
+
+// Helper function to get a fresh dictionary path in the temporary directory
+std::string customDictionaryPath(const std::string& name) {
+    std::string path = (std::filesystem::temp_directory_path() / name).string();
+    std::filesystem::remove(path);
+    return path;
+}
+
+// Helper function to read the lines of a file
+std::vector<std::string> readLines(const std::string& path) {
+    std::ifstream file(path);
+    std::vector<std::string> lines;
+    for (std::string line; std::getline(file, line);) {
+        lines.push_back(line);
+    }
+    return lines;
+}
+
+// Helper function to count the lines of a file
+size_t countLines(const std::string& path) {
+    std::ifstream file(path);
+    return std::count(std::istreambuf_iterator<char>(file), std::istreambuf_iterator<char>(), '\n');
+}
+
+TEST_CASE("CustomDictionary", "[custom_dictionary]") {
+    SECTION("AddAndRemoveWords") {
+        CustomDictionary dictionary;
+        REQUIRE(dictionary.addWord("Kubernetes"));
+        REQUIRE(dictionary.addWord("gRPC"));
+        REQUIRE_FALSE(dictionary.addWord("gRPC"));
+        REQUIRE_FALSE(dictionary.addWord(""));
+        REQUIRE_FALSE(dictionary.addWord("two\nlines"));
+
+        // Lookups are case-sensitive, by text or by interned word ID
+        REQUIRE(dictionary.contains("Kubernetes"));
+        REQUIRE_FALSE(dictionary.contains("kubernetes"));
+        REQUIRE(dictionary.containsId(WordTable::global().find("gRPC")));
+        REQUIRE(dictionary.size() == 2);
+        REQUIRE(dictionary.words() == std::vector<std::string>{"Kubernetes", "gRPC"});
+
+        uint64_t version = dictionary.version();
+        REQUIRE(dictionary.removeWord("gRPC"));
+        REQUIRE_FALSE(dictionary.removeWord("gRPC"));
+        REQUIRE_FALSE(dictionary.contains("gRPC"));
+        REQUIRE_FALSE(dictionary.containsId(WordTable::global().find("gRPC")));
+        REQUIRE(dictionary.version() > version);
+    }
+
+    SECTION("JournalIsReplayed") {
+        std::string path = customDictionaryPath("custom_dictionary_journal.dic");
+        {
+            CustomDictionary dictionary(path);
+            dictionary.addWord("zebrafish");
+            dictionary.addWord("axolotl");
+            dictionary.addWord("quokka");
+            dictionary.removeWord("zebrafish");
+        }
+
+        // Each change is one appended line after the header
+        REQUIRE(countLines(path) == 5);
+
+        CustomDictionary reloaded(path);
+        REQUIRE(reloaded.words() == std::vector<std::string>{"axolotl", "quokka"});
+    }
+
+    SECTION("UnterminatedLastLineIsKept") {
+        std::string path = customDictionaryPath("custom_dictionary_unterminated.dic");
+        std::ofstream(path) << "#custom-dictionary 1\n+axolotl\n+quokka";
+        {
+            CustomDictionary dictionary(path);
+            REQUIRE(dictionary.words() == std::vector<std::string>{"axolotl", "quokka"});
+            dictionary.addWord("zebrafish");
+        }
+
+        // The missing newline was added, so the appended word has its own line
+        REQUIRE(countLines(path) == 4);
+        CustomDictionary reloaded(path);
+        REQUIRE(reloaded.words() == std::vector<std::string>{"axolotl", "quokka", "zebrafish"});
+
+        // A file of a single unterminated line keeps its word too
+        std::string single = customDictionaryPath("custom_dictionary_single.dic");
+        std::ofstream(single) << "+axolotl";
+        REQUIRE(CustomDictionary(single).words() == std::vector<std::string>{"axolotl"});
+        REQUIRE(std::filesystem::file_size(single) == 9);
+    }
+
+    SECTION("CompactionRewritesLiveWords") {
+        std::string path = customDictionaryPath("custom_dictionary_compact.dic");
+        CustomDictionary dictionary(path);
+
+        // Churn on one word compacts the journal automatically
+        dictionary.addWord("axolotl");
+        for (int i = 0; i < 2000; ++i) {
+            dictionary.addWord("temporary");
+            dictionary.removeWord("temporary");
+        }
+        REQUIRE(countLines(path) < 1100);
+
+        dictionary.addWord("quokka");
+        REQUIRE(dictionary.compact());
+        REQUIRE(countLines(path) == 3);
+        REQUIRE(CustomDictionary(path).words() == std::vector<std::string>{"axolotl", "quokka"});
+    }
+
+    SECTION("FailedCompactionKeepsJournal") {
+        // A directory in the way of the temporary file makes every rewrite fail
+        std::string path = customDictionaryPath("custom_dictionary_blocked.dic");
+        std::filesystem::create_directory(path + ".tmp");
+        {
+            CustomDictionary dictionary(path);
+            dictionary.addWord("axolotl");
+            for (int i = 0; i < 2000; ++i) {
+                dictionary.addWord("temporary");
+                dictionary.removeWord("temporary");
+            }
+            REQUIRE_FALSE(dictionary.compact());
+        }
+
+        // Nothing was lost, and compaction works again once the way is clear
+        REQUIRE(countLines(path) == 4002);
+        std::filesystem::remove(path + ".tmp");
+        CustomDictionary reloaded(path);
+        REQUIRE(reloaded.words() == std::vector<std::string>{"axolotl"});
+        REQUIRE(countLines(path) == 2);
+    }
+
+    SECTION("OpenSharesOneInstancePerFile") {
+        std::string path = customDictionaryPath("custom_dictionary_shared.dic");
+        auto first = CustomDictionary::open(path);
+        auto second = CustomDictionary::open(path);
+        REQUIRE(first.get() == second.get());
+
+        first->addWord("axolotl");
+        REQUIRE(second->contains("axolotl"));
+    }
+
+    SECTION("LargeGlossary") {
+        std::string path = customDictionaryPath("custom_dictionary_glossary.dic");
+        {
+            CustomDictionary dictionary(path);
+            for (int i = 0; i < 50000; ++i) {
+                dictionary.addWord("term" + std::to_string(i));
+            }
+            REQUIRE(dictionary.compact());
+        }
+
+        CustomDictionary reloaded(path);
+        REQUIRE(reloaded.size() == 50000);
+        REQUIRE(reloaded.contains("term49999"));
+        REQUIRE_FALSE(reloaded.contains("term50000"));
+
+        // Each word is stored once in the arena plus a fixed-size index entry
+        REQUIRE(reloaded.memoryBytes() < 50000 * 32);
+    }
+
+    SECTION("ShuffledJournalLoadsSorted") {
+        // A glossary added in random order, with some words removed again,
+        // leaves an unsorted journal with history
+        std::string path = customDictionaryPath("custom_dictionary_shuffled.dic");
+        std::vector<std::string> terms;
+        for (int i = 0; i < 50000; ++i) {
+            terms.push_back("term" + std::to_string(i));
+        }
+        std::shuffle(terms.begin(), terms.end(), std::mt19937(42));
+        {
+            std::ofstream file(path, std::ios::binary);
+            file << "#custom-dictionary 1\n";
+            for (const auto& term : terms) {
+                file << '+' << term << '\n';
+            }
+            for (int i = 0; i < 50000; i += 2) {
+                file << "-term" << i << '\n';
+            }
+            file << "+term0\n";
+        }
+
+        CustomDictionary dictionary(path);
+        REQUIRE(dictionary.size() == 25001);
+        REQUIRE(dictionary.contains("term0"));
+        REQUIRE(dictionary.contains("term49999"));
+        REQUIRE_FALSE(dictionary.contains("term49998"));
+        REQUIRE(dictionary.containsId(WordTable::global().find("term12345")));
+        REQUIRE_FALSE(dictionary.containsId(WordTable::global().find("term12344")));
+
+        // The file was rewritten as the sorted live words
+        std::vector<std::string> lines = readLines(path);
+        REQUIRE(lines.size() == 25002);
+        REQUIRE(std::is_sorted(lines.begin() + 1, lines.end()));
+        REQUIRE(lines[1] == "+term0");
+
+        // Loading the sorted file leaves it untouched
+        auto modified = std::filesystem::last_write_time(path);
+        REQUIRE(CustomDictionary(path).words() == dictionary.words());
+        REQUIRE(std::filesystem::last_write_time(path) == modified);
+    }
+}
@@ -0,0 +1,36 @@
+#include <catch2/catch.hpp>
+#include "../../src/core/engine/default_auto_correct_rules.h"
+#include <string>
+#include <string_view>
+
+TEST_CASE("DefaultAutoCorrectRules", "[auto_correct]") {
+    SECTION("EveryRuleIsFound") {
+        for (std::string_view languageCode : {"en_US", "de_DE", "fr_FR", "es_ES"}) {
+            const DefaultAutoCorrectTable* table = findDefaultAutoCorrectTable(languageCode);
+            REQUIRE(table);
+            REQUIRE(table->ruleCount > 0);
+            REQUIRE(table->slotCount >= table->ruleCount);
+
+            // The perfect hash sends every rule to its own slot
+            for (uint32_t i = 0; i < table->ruleCount; ++i) {
+                REQUIRE(findDefaultAutoCorrection(*table, table->rules[i].incorrect) == &table->rules[i]);
+            }
+        }
+    }
+
+    SECTION("OtherTextIsNotFound") {
+        const DefaultAutoCorrectTable* table = findDefaultAutoCorrectTable("en_US");
+        REQUIRE(findDefaultAutoCorrection(*table, "teh")->correct == "the");
+        REQUIRE(findDefaultAutoCorrection(*table, "(c)")->correct == "\xC2\xA9");
+        REQUIRE_FALSE(findDefaultAutoCorrection(*table, "the"));
+        REQUIRE_FALSE(findDefaultAutoCorrection(*table, "Teh"));
+        REQUIRE_FALSE(findDefaultAutoCorrection(*table, ""));
+        for (int i = 0; i < 1000; ++i) {
+            REQUIRE_FALSE(findDefaultAutoCorrection(*table, "word" + std::to_string(i)));
+        }
+    }
+
+    SECTION("UnknownLanguage") {
+        REQUIRE_FALSE(findDefaultAutoCorrectTable("xx_XX"));
+    }
+}
@@ -0,0 +1,57 @@
+#include <catch2/catch.hpp>
+#include "../../src/core/engine/grammar_check.h"
+#include "../../src/core/engine/language_resources.h"
+#include <atomic>
+#include <string>
+#include <thread>
+#include <vector>
+
+TEST_CASE("GrammarCheck", "[grammar_check]") {
+    SECTION("ParallelParagraphMatchesSequential") {
+        std::string paragraph;
+        for (int i = 0; i < 40; ++i) {
+            paragraph += i % 2 == 0 ? "This are a test number " + std::to_string(i) + ". " : "The dog run fast. ";
+        }
+
+        // Check every sentence with LanguageTool, on one thread and then on many
+        GrammarCheck grammarChecker;
+        grammarChecker.setResultCache(nullptr);
+        size_t poolSize = LanguageResourceRegistry::global().grammarPoolSize();
+        LanguageResourceRegistry::global().setGrammarPoolSize(1);
+        auto sequential = grammarChecker.checkParagraph(paragraph);
+        LanguageResourceRegistry::global().setGrammarPoolSize(8);
+        auto parallel = grammarChecker.checkParagraph(paragraph);
+        LanguageResourceRegistry::global().setGrammarPoolSize(poolSize);
+
+        // Errors come back in document order whatever thread checked them
+        REQUIRE(parallel.size() == sequential.size());
+        for (size_t i = 0; i < sequential.size(); ++i) {
+            REQUIRE(parallel[i].startPos == sequential[i].startPos);
+            REQUIRE(parallel[i].endPos == sequential[i].endPos);
+            REQUIRE(parallel[i].message == sequential[i].message);
+        }
+    }
+
+    SECTION("ConcurrentReadersDuringLanguageSwitch") {
+        GrammarCheck grammarChecker;
+        std::atomic<bool> stop(false);
+
+        // Readers without a proofing arena may share one checker
+        std::vector<std::thread> readers;
+        for (int i = 0; i < 4; ++i) {
+            readers.emplace_back([&grammarChecker, &stop] {
+                while (!stop.load()) {
+                    grammarChecker.checkParagraph("This are a test. The dog run fast.");
+                }
+            });
+        }
+        for (int i = 0; i < 50; ++i) {
+            grammarChecker.setLanguage(i % 2 == 0 ? "de_DE" : "en_US");
+        }
+        stop = true;
+        for (auto& reader : readers) {
+            reader.join();
+        }
+        REQUIRE(grammarChecker.getLanguage() == "en_US");
+    }
+}
@@ -0,0 +1,110 @@
+#include <catch2/catch.hpp>
+#include "../../src/core/engine/grammar_result_cache.h"
+#include "../../src/core/engine/grammar_check.h"
+#include <memory_resource>
+#include <string>
+
+// Helper function to build the cached errors of one sentence
+std::pmr::vector<GrammarError> makeErrors(int count) {
+    std::pmr::vector<GrammarError> errors;
+    for (int i = 0; i < count; ++i) {
+        GrammarError error;
+        error.message = "Possible agreement error";
+        error.startPos = i;
+        error.endPos = i + 3;
+        error.errorType = "grammar";
+        errors.push_back(error);
+    }
+    return errors;
+}
+
+TEST_CASE("GrammarResultCache", "[grammar_result_cache]") {
+    SECTION("StoreAndLookup") {
+        GrammarResultCache cache(1024 * 1024);
+        auto key = GrammarResultCache::makeKey("en_US", 1, "This are a test.");
+        std::pmr::vector<GrammarError> errors;
+        REQUIRE_FALSE(cache.lookup(key, errors));
+
+        cache.store(key, makeErrors(2));
+        REQUIRE(cache.lookup(key, errors));
+        REQUIRE(errors.size() == 2);
+        REQUIRE(errors[1].startPos == 1);
+        REQUIRE(errors[1].message == "Possible agreement error");
+
+        // Sentences without errors are cached too
+        auto cleanKey = GrammarResultCache::makeKey("en_US", 1, "This is a test.");
+        cache.store(cleanKey, makeErrors(0));
+        REQUIRE(cache.lookup(cleanKey, errors));
+        REQUIRE(errors.empty());
+
+        GrammarResultCache::Stats stats = cache.stats();
+        REQUIRE(stats.hits == 2);
+        REQUIRE(stats.misses == 1);
+        REQUIRE(stats.entries == 2);
+    }
+
+    SECTION("KeyCoversLanguageAndRuleSet") {
+        GrammarResultCache cache(1024 * 1024);
+        cache.store(GrammarResultCache::makeKey("en_US", 1, "This are a test."), makeErrors(1));
+
+        std::pmr::vector<GrammarError> errors;
+        REQUIRE_FALSE(cache.lookup(GrammarResultCache::makeKey("en_GB", 1, "This are a test."), errors));
+        REQUIRE_FALSE(cache.lookup(GrammarResultCache::makeKey("en_US", 2, "This are a test."), errors));
+        REQUIRE_FALSE(cache.lookup(GrammarResultCache::makeKey("en_US", 1, "This are a test!"), errors));
+    }
+
+    SECTION("HashCollisionIsAMiss") {
+        GrammarResultCache cache(1024 * 1024);
+        auto key = GrammarResultCache::makeKey("en_US", 1, "This are a test.");
+        cache.store(key, makeErrors(1));
+
+        // A sentence of the same length whose hash collides gets no errors of another
+        auto colliding = key;
+        colliding.sentence = "This are a tost.";
+        std::pmr::vector<GrammarError> errors;
+        REQUIRE_FALSE(cache.lookup(colliding, errors));
+        colliding = key;
+        colliding.context = GrammarResultCache::makeKey("de_DE", 1, "This are a test.").context;
+        REQUIRE_FALSE(cache.lookup(colliding, errors));
+        REQUIRE(cache.lookup(key, errors));
+    }
+
+    SECTION("EvictsLeastRecentlyUsed") {
+        GrammarResultCache cache(64 * 1024);
+        auto first = GrammarResultCache::makeKey("en_US", 1, "sentence 0");
+        cache.store(first, makeErrors(1));
+        for (int i = 1; i < 2000; ++i) {
+            std::pmr::vector<GrammarError> errors;
+            cache.lookup(first, errors);
+            cache.store(GrammarResultCache::makeKey("en_US", 1, "sentence " + std::to_string(i)), makeErrors(1));
+        }
+
+        // Frequently used sentences survive; the rest stay within the budget
+        GrammarResultCache::Stats stats = cache.stats();
+        REQUIRE(stats.bytes <= 64 * 1024);
+        REQUIRE(stats.evictions > 0);
+        std::pmr::vector<GrammarError> errors;
+        REQUIRE(cache.lookup(first, errors));
+    }
+
+    SECTION("SharedAcrossCheckers") {
+        auto cache = std::make_shared<GrammarResultCache>();
+        GrammarCheck first;
+        GrammarCheck second;
+        first.setResultCache(cache);
+        second.setResultCache(cache);
+
+        auto errors = first.checkParagraph("This are a test. The dog run fast.");
+        REQUIRE(cache->stats().misses == 2);
+
+        // The second checker reuses both sentences, each with its own offsets
+        REQUIRE(second.checkParagraph("The dog run fast. This are a test.").size() == errors.size());
+        REQUIRE(cache->stats().hits == 2);
+        auto repeated = second.checkParagraph("This are a test. The dog run fast.");
+        REQUIRE(repeated.size() == errors.size());
+        for (size_t i = 0; i < errors.size(); ++i) {
+            REQUIRE(repeated[i].startPos == errors[i].startPos);
+            REQUIRE(repeated[i].endPos == errors[i].endPos);
+        }
+    }
+}
@@ -0,0 +1,226 @@
+#include <catch2/catch.hpp>
+#include "../../src/core/engine/language_resources.h"
+#include "../../src/core/engine/word_table.h"
+#include <chrono>
+#include <memory>
+#include <string>
+#include <thread>
+#include <vector>
+
+// Helper function to find a language in the registry's memory report
+LanguageMemoryUsage findUsage(const LanguageResourceRegistry& registry, const std::string& languageCode) {
+    for (const auto& usage : registry.memoryReport()) {
+        if (usage.languageCode == languageCode) {
+            return usage;
+        }
+    }
+    return LanguageMemoryUsage();
+}
+
+TEST_CASE("LanguageResourceRegistry", "[language_resources]") {
+    SECTION("HandlesShareOneLoad") {
+        LanguageResourceRegistry registry;
+        auto first = registry.acquire("en_US");
+        auto second = registry.acquire("en_US");
+
+        // Both handles refer to the same resources, counted once per handle
+        REQUIRE(first.get() == second.get());
+        REQUIRE(first->languageCode() == "en_US");
+        REQUIRE(findUsage(registry, "en_US").handles == 2);
+
+        second.reset();
+        REQUIRE(findUsage(registry, "en_US").handles == 1);
+    }
+
+    SECTION("ConcurrentAcquiresShareOneLoad") {
+        // Callers arriving while a language loads wait for that load, and
+        // other languages load alongside it
+        LanguageResourceRegistry registry;
+        std::vector<std::shared_ptr<const LanguageResources>> handles(8);
+        std::vector<std::thread> threads;
+        for (size_t i = 0; i < handles.size(); ++i) {
+            threads.emplace_back([&registry, &handles, i]() {
+                handles[i] = registry.acquire(i % 2 == 0 ? "en_US" : "de_DE");
+            });
+        }
+        for (auto& thread : threads) {
+            thread.join();
+        }
+
+        for (size_t i = 2; i < handles.size(); ++i) {
+            REQUIRE(handles[i].get() == handles[i % 2].get());
+        }
+        REQUIRE(handles[0].get() != handles[1].get());
+        REQUIRE(findUsage(registry, "en_US").handles == 4);
+        REQUIRE(findUsage(registry, "de_DE").handles == 4);
+    }
+
+    SECTION("IdleLanguagesAreUnloaded") {
+        // Without warm languages, the idle timeout alone decides
+        LanguageResourceRegistry registry;
+        registry.setWarmLanguageCount(0);
+        registry.setIdleTimeout(std::chrono::hours(1));
+        registry.acquire("en_US").reset();
+
+        // Released but not idle for long enough yet
+        REQUIRE(registry.isLoaded("en_US"));
+        registry.unloadIdle();
+        REQUIRE(registry.isLoaded("en_US"));
+
+        // A language in use is never unloaded
+        auto handle = registry.acquire("en_US");
+        registry.setIdleTimeout(std::chrono::seconds(0));
+        REQUIRE(registry.isLoaded("en_US"));
+
+        // Dropping the last handle now unloads it right away
+        handle.reset();
+        REQUIRE_FALSE(registry.isLoaded("en_US"));
+        REQUIRE(registry.memoryReport().empty());
+    }
+
+    SECTION("IdleLanguagesAreSwept") {
+        // A language released before its timeout is unloaded by the sweep
+        // later, without any further call into the registry
+        LanguageResourceRegistry registry;
+        registry.setWarmLanguageCount(0);
+        registry.setIdleTimeout(std::chrono::milliseconds(50));
+        registry.setSweepInterval(std::chrono::milliseconds(10));
+        registry.acquire("en_US").reset();
+        REQUIRE(registry.isLoaded("en_US"));
+
+        auto deadline = std::chrono::steady_clock::now() + std::chrono::seconds(5);
+        while (registry.isLoaded("en_US") && std::chrono::steady_clock::now() < deadline) {
+            std::this_thread::sleep_for(std::chrono::milliseconds(10));
+        }
+        REQUIRE_FALSE(registry.isLoaded("en_US"));
+    }
+
+    SECTION("RecentLanguagesStayWarm") {
+        LanguageResourceRegistry registry;
+        registry.setIdleTimeout(std::chrono::seconds(0));
+        registry.setWarmLanguageCount(2);
+
+        // The two most recently released languages outlive the idle timeout
+        registry.acquire("en_US").reset();
+        std::this_thread::sleep_for(std::chrono::milliseconds(2));
+        registry.acquire("de_DE").reset();
+        REQUIRE(registry.isLoaded("en_US"));
+        REQUIRE(registry.isLoaded("de_DE"));
+
+        // Releasing a third language unloads the oldest one
+        std::this_thread::sleep_for(std::chrono::milliseconds(2));
+        registry.acquire("fr_FR").reset();
+        REQUIRE_FALSE(registry.isLoaded("en_US"));
+        REQUIRE(registry.isLoaded("de_DE"));
+        REQUIRE(registry.isLoaded("fr_FR"));
+    }
+
+    SECTION("PreloadedLanguagesStayLoaded") {
+        LanguageResourceRegistry registry;
+        registry.setIdleTimeout(std::chrono::seconds(0));
+        registry.setWarmLanguageCount(0);
+        registry.preloadLanguages({"en_US", "de_DE"});
+
+        // Loaded with compiled grammar rules, although nobody holds a handle
+        REQUIRE(registry.isLoaded("en_US"));
+        REQUIRE(findUsage(registry, "en_US").handles == 0);
+        REQUIRE(findUsage(registry, "en_US").languageToolInstances == 1);
+        registry.acquire("fr_FR").reset();
+        REQUIRE(registry.isLoaded("de_DE"));
+        REQUIRE_FALSE(registry.isLoaded("fr_FR"));
+
+        // A language dropped from the configuration is unloaded as usual
+        registry.preloadLanguages({"de_DE"});
+        REQUIRE_FALSE(registry.isLoaded("en_US"));
+        REQUIRE(registry.isLoaded("de_DE"));
+    }
+
+    SECTION("HandlesOutliveTheRegistry") {
+        std::shared_ptr<const LanguageResources> handle;
+        {
+            LanguageResourceRegistry registry;
+            handle = registry.acquire("en_US");
+        }
+        REQUIRE(handle->languageCode() == "en_US");
+        handle.reset();
+    }
+
+    SECTION("SharedAutoCorrectRules") {
+        LanguageResourceRegistry registry;
+        auto resources = registry.acquire("en_US");
+
+        // Language rules are found by text or by interned word ID
+        auto correction = resources->findAutoCorrection(WordTable::global().intern("teh"));
+        REQUIRE(correction);
+        REQUIRE(*correction == "the");
+        REQUIRE(resources->findAutoCorrection("teh") == correction);
+        REQUIRE_FALSE(resources->findAutoCorrection("the"));
+        REQUIRE(resources->autoCorrectRuleCount() > 0);
+
+        LanguageMemoryUsage usage = findUsage(registry, "en_US");
+        REQUIRE(usage.autoCorrectBytes > 0);
+        REQUIRE(usage.totalBytes >= usage.autoCorrectBytes);
+    }
+
+    SECTION("GrammarPoolSizeIsCapped") {
+        LanguageResourceRegistry registry;
+        registry.setGrammarPoolSize(2);
+        auto resources = registry.acquire("en_US");
+
+        // Concurrent checks beyond the pool size wait for a free instance
+        std::vector<std::thread> checkers;
+        for (int i = 0; i < 6; ++i) {
+            checkers.emplace_back([&resources] {
+                std::pmr::vector<std::string_view> tokens = {"This", "are", "a", "test", "."};
+                for (int j = 0; j < 20; ++j) {
+                    resources->checkGrammar(tokens);
+                }
+            });
+        }
+        for (auto& checker : checkers) {
+            checker.join();
+        }
+        REQUIRE(findUsage(registry, "en_US").languageToolInstances <= 2);
+        REQUIRE(registry.grammarPoolSize() == 2);
+    }
+
+    SECTION("UnknownLanguage") {
+        LanguageResourceRegistry registry;
+        auto resources = registry.acquire("xx");
+        REQUIRE(resources->dictionaryPath().empty());
+        REQUIRE_FALSE(resources->hasGrammarRules());
+    }
+
+    SECTION("GrammarInstancesArePooled") {
+        LanguageResourceRegistry registry;
+        auto resources = registry.acquire("en_US");
+        REQUIRE(resources->hasGrammarRules());
+
+        // Sequential checks reuse the same LanguageTool instance
+        std::pmr::vector<std::string_view> tokens = {"This", "are", "a", "test", "."};
+        resources->checkGrammar(tokens);
+        resources->checkGrammar(tokens);
+        REQUIRE(findUsage(registry, "en_US").languageToolInstances == 1);
+    }
+
+    SECTION("HunspellInstancesAreCapped") {
+        LanguageResourceRegistry registry;
+        auto resources = registry.acquire("en_US");
+
+        // A burst of concurrent callers shares at most a pool's worth of instances
+        std::vector<std::thread> threads;
+        for (int i = 0; i < 16; ++i) {
+            threads.emplace_back([&resources]() {
+                for (int j = 0; j < 20; ++j) {
+                    resources->suggest("quik");
+                }
+            });
+        }
+        for (auto& thread : threads) {
+            thread.join();
+        }
+        size_t instances = findUsage(registry, "en_US").hunspellInstances;
+        REQUIRE(instances >= 1);
+        REQUIRE(instances <= DEFAULT_HUNSPELL_POOL_SIZE);
+    }
+}
@@ -0,0 +1,49 @@
+#include <catch2/catch.hpp>
+#include "../../src/core/engine/parallel_proofing.h"
+#include "../../src/core/engine/text_processing.h"
+#include <string>
+#include <vector>
+
+// Helper function to create a multi-paragraph document with known misspellings
+std::string createLargeDocument(int paragraphCount) {
+    std::string document;
+    for (int i = 0; i < paragraphCount; ++i) {
+        document += "The quik brown fox jumpps over the lasy dog. He don't like it.\n";
+    }
+    return document;
+}
+
+TEST_CASE("ParallelProofing", "[parallel_proofing]") {
+    SECTION("MatchesSequentialResults") {
+        std::string document = createLargeDocument(500);
+
+        // Proof the document sequentially and in parallel with small shards
+        TextProcessing sequential;
+        auto expectedSpelling = sequential.checkSpelling(document);
+        auto expectedGrammar = sequential.checkGrammar(document);
+
+        ParallelProofing parallel(4, 256);
+        auto results = parallel.proofDocument(document);
+
+        // Verify results are merged in document order with global offsets
+        REQUIRE(results.spelling.size() == expectedSpelling.size());
+        for (size_t i = 0; i < expectedSpelling.size(); ++i) {
+            REQUIRE(results.spelling[i].word == expectedSpelling[i].word);
+            REQUIRE(results.spelling[i].startPos == expectedSpelling[i].startPos);
+        }
+        REQUIRE(results.grammar.size() == expectedGrammar.size());
+    }
+
+    SECTION("DeterministicAcrossThreadCounts") {
+        std::string document = createLargeDocument(200);
+
+        // Verify the output does not depend on the number of workers
+        auto singleThreaded = ParallelProofing(1, 256).proofDocument(document);
+        auto multiThreaded = ParallelProofing(8, 256).proofDocument(document);
+
+        REQUIRE(singleThreaded.spelling.size() == multiThreaded.spelling.size());
+        for (size_t i = 0; i < singleThreaded.spelling.size(); ++i) {
+            REQUIRE(singleThreaded.spelling[i].startPos == multiThreaded.spelling[i].startPos);
+        }
+    }
+}
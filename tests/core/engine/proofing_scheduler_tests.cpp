@@ -0,0 +1,146 @@
+#include <catch2/catch.hpp>
+#include "../../src/core/engine/proofing_scheduler.h"
+#include "../../src/core/engine/text_processing.h"
+#include <chrono>
+#include <memory>
+#include <string>
+
+// Helper function to create a document of equally long paragraphs, each with a
+// misspelling and a grammar error
+std::string createParagraphs(int count) {
+    std::string text;
+    for (int i = 0; i < count; ++i) {
+        text += "Paragraph " + std::to_string(100 + i) + " are Zyxwrong here.\n";
+    }
+    return text;
+}
+
+// Helper function to tell whether a document position has a spelling result
+bool hasSpellingAt(const ProofingResults& results, size_t start, size_t end) {
+    for (const auto& suggestion : results.spelling) {
+        if (static_cast<size_t>(suggestion.startPos) >= start && static_cast<size_t>(suggestion.endPos) <= end) {
+            return true;
+        }
+    }
+    return false;
+}
+
+TEST_CASE("ProofingScheduler", "[proofing_scheduler]") {
+    auto processor = std::make_shared<TextProcessing>();
+    std::string text = createParagraphs(100);
+    size_t paragraphLength = text.find('\n') + 1;
+
+    SECTION("VisibleParagraphsFirst") {
+        ProofingScheduler scheduler(processor);
+        scheduler.setText(text);
+        scheduler.setViewport(50 * paragraphLength, 51 * paragraphLength);
+        REQUIRE(scheduler.stats().queuedVisible == 2);
+
+        // Spelling and grammar of the visible paragraph, then its neighbours
+        REQUIRE(scheduler.runNextJob());
+        REQUIRE(scheduler.runNextJob());
+        REQUIRE(scheduler.stats().queuedVisible == 0);
+        REQUIRE(hasSpellingAt(scheduler.results(), 50 * paragraphLength, 51 * paragraphLength));
+        REQUIRE(scheduler.results().spelling.size() == 1);
+
+        REQUIRE(scheduler.runNextJob());
+        ProofingResults results = scheduler.results();
+        REQUIRE(results.spelling.size() == 2);
+        REQUIRE((hasSpellingAt(results, 49 * paragraphLength, 50 * paragraphLength)
+                 || hasSpellingAt(results, 51 * paragraphLength, 52 * paragraphLength)));
+
+        // Nearby paragraphs are done before the rest of the document
+        size_t nearby = scheduler.stats().queuedNearby;
+        for (size_t i = 0; i < nearby; ++i) {
+            scheduler.runNextJob();
+        }
+        REQUIRE(scheduler.stats().queuedNearby == 0);
+        REQUIRE_FALSE(hasSpellingAt(scheduler.results(), 0, paragraphLength));
+        REQUIRE(scheduler.stats().queuedBackground > 0);
+    }
+
+    SECTION("SliceDrainsTheQueue") {
+        ProofingScheduler scheduler(processor);
+        scheduler.setText(text);
+        REQUIRE(scheduler.runSlice(std::chrono::seconds(0)) == 0);
+
+        while (!scheduler.isIdle()) {
+            scheduler.runSlice(std::chrono::milliseconds(5));
+        }
+        REQUIRE(scheduler.runSlice(std::chrono::milliseconds(5)) == 0);
+
+        ProofingResults results = scheduler.results();
+        REQUIRE(results.spelling.size() == 100);
+        ProofingScheduler::Stats stats = scheduler.stats();
+        REQUIRE(stats.completedJobs == 200);
+        REQUIRE(stats.maxLatency >= stats.meanLatency);
+    }
+
+    SECTION("EditsCancelQueuedWork") {
+        ProofingScheduler scheduler(processor);
+        scheduler.setText(text);
+        while (scheduler.runNextJob()) {
+        }
+
+        // Only the edited paragraph, now split in two, is queued again
+        scheduler.applyEdit(10 * paragraphLength, 0, "Another Zyxtypo line.\n");
+        REQUIRE(scheduler.stats().queuedBackground == 4);
+
+        // Editing the new line before it was checked replaces its queued jobs
+        scheduler.applyEdit(10 * paragraphLength + 8, 6, "Zyxbad");
+        ProofingScheduler::Stats stats = scheduler.stats();
+        REQUIRE(stats.cancelledJobs == 2);
+        REQUIRE(stats.queuedBackground == 4);
+        while (scheduler.runNextJob()) {
+        }
+
+        // The result matches checking the edited text from scratch
+        ProofingScheduler fresh(processor);
+        fresh.setText(scheduler.text());
+        while (fresh.runNextJob()) {
+        }
+        ProofingResults edited = scheduler.results();
+        ProofingResults expected = fresh.results();
+        REQUIRE(edited.spelling.size() == expected.spelling.size());
+        for (size_t i = 0; i < expected.spelling.size(); ++i) {
+            REQUIRE(edited.spelling[i].startPos == expected.spelling[i].startPos);
+            REQUIRE(edited.spelling[i].word == expected.spelling[i].word);
+        }
+        REQUIRE(edited.grammar.size() == expected.grammar.size());
+    }
+
+    SECTION("RepeatedEditsMatchAFreshCheck") {
+        ProofingScheduler scheduler(processor);
+        scheduler.setText(text);
+        scheduler.setViewport(40 * paragraphLength, 42 * paragraphLength);
+        while (scheduler.runNextJob()) {
+        }
+
+        // Lines inserted again and again at one place use up the gap between
+        // their neighbours' order IDs; typing, joins and deletions follow
+        for (int i = 0; i < 80; ++i) {
+            scheduler.applyEdit(40 * paragraphLength, 0, "Inserted Zyxline " + std::to_string(i) + ".\n");
+            scheduler.runNextJob();
+        }
+        scheduler.applyEdit(5 * paragraphLength + 3, 0, "Zyx");
+        scheduler.applyEdit(20 * paragraphLength - 1, 1, " ");
+        scheduler.applyEdit(60 * paragraphLength, 3 * paragraphLength, "");
+        scheduler.applyEdit(scheduler.text().size(), 0, "Last Zyxword");
+        while (scheduler.runNextJob()) {
+        }
+
+        ProofingScheduler fresh(processor);
+        fresh.setText(scheduler.text());
+        while (fresh.runNextJob()) {
+        }
+        ProofingResults edited = scheduler.results();
+        ProofingResults expected = fresh.results();
+        REQUIRE(edited.spelling.size() == expected.spelling.size());
+        for (size_t i = 0; i < expected.spelling.size(); ++i) {
+            REQUIRE(edited.spelling[i].startPos == expected.spelling[i].startPos);
+            REQUIRE(edited.spelling[i].word == expected.spelling[i].word);
+        }
+        REQUIRE(edited.grammar.size() == expected.grammar.size());
+        REQUIRE(scheduler.stats().completedJobs > fresh.stats().completedJobs);
+    }
+}
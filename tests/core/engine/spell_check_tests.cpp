@@ -0,0 +1,88 @@
+#include <catch2/catch.hpp>
+#include "../../src/core/engine/spell_check.h"
+#include "../../src/core/engine/custom_dictionary.h"
+#include "../../src/core/engine/text_segmentation.h"
+#include "../../src/core/engine/word_table.h"
+#include <atomic>
+#include <memory>
+#include <string>
+#include <thread>
+#include <vector>
+
+TEST_CASE("SpellCheck", "[spell_check]") {
+    SECTION("LanguageSwitch") {
+        SpellCheck spellChecker;
+        REQUIRE(spellChecker.setLanguage("en_US"));
+        REQUIRE(spellChecker.getLanguage() == "en_US");
+        REQUIRE(spellChecker.checkWord("house"));
+
+        // An unknown language leaves the current one in place
+        REQUIRE_FALSE(spellChecker.setLanguage("xx_XX"));
+        REQUIRE(spellChecker.getLanguage() == "en_US");
+    }
+
+    SECTION("SharedCustomDictionary") {
+        SpellCheck first;
+        SpellCheck second;
+        auto dictionary = std::make_shared<CustomDictionary>();
+        first.setCustomDictionary(dictionary);
+        second.setCustomDictionary(dictionary);
+        REQUIRE_FALSE(second.checkWord("Zyxlor"));
+
+        // A word added through one checker drops the other's cached verdict
+        REQUIRE(first.addToCustomDictionary("Zyxlor"));
+        REQUIRE(second.checkWord("Zyxlor"));
+    }
+
+    SECTION("BatchedCheckMatchesSingleWords") {
+        // Enough distinct words to be checked on the helper threads, with repeats
+        std::string text = "Zyxlor house, Zyxlor mouse. ";
+        for (int i = 0; i < 600; ++i) {
+            text += (i % 3 == 0 ? "Zyxterm" : "term") + std::to_string(i % 400) + " house ";
+        }
+        auto tokens = tokenizeText(text, WordTable::global());
+
+        SpellCheck batchChecker;
+        SpellCheck wordChecker;
+        std::vector<bool> verdicts = batchChecker.checkWords(tokens.data(), tokens.size());
+        REQUIRE(verdicts.size() == tokens.size());
+        for (size_t i = 0; i < tokens.size(); ++i) {
+            bool expected = tokens[i].type != TokenType::Word || wordChecker.checkWord(std::string(tokens[i].text));
+            REQUIRE(verdicts[i] == expected);
+        }
+        REQUIRE_FALSE(verdicts[0]);
+
+        // Words of the custom dictionary are correct in a batch too
+        REQUIRE(batchChecker.addToCustomDictionary("Zyxlor"));
+        REQUIRE(batchChecker.checkWords(tokens.data(), 1).front());
+    }
+
+    SECTION("ConcurrentReadersDuringLanguageSwitch") {
+        SpellCheck spellChecker;
+        std::atomic<bool> stop(false);
+
+        // Readers keep checking and asking for suggestions while the language flips
+        std::vector<std::thread> readers;
+        for (int i = 0; i < 4; ++i) {
+            readers.emplace_back([&spellChecker, &stop] {
+                while (!stop.load()) {
+                    spellChecker.checkWord("house");
+                    spellChecker.checkWord("Haus");
+                    spellChecker.getSuggestions("hause");
+                }
+            });
+        }
+        for (int i = 0; i < 50; ++i) {
+            spellChecker.setLanguage(i % 2 == 0 ? "de_DE" : "en_US");
+            spellChecker.setSuggestionBackend("en_US", i % 4 == 1 ? SuggestionBackend::SymSpell : SuggestionBackend::Hunspell);
+        }
+        stop = true;
+        for (auto& reader : readers) {
+            reader.join();
+        }
+
+        // Once the swaps are done, verdicts belong to the final language only
+        REQUIRE(spellChecker.getLanguage() == "en_US");
+        REQUIRE(spellChecker.checkWord("house"));
+    }
+}
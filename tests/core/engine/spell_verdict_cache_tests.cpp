@@ -0,0 +1,84 @@
+#include <catch2/catch.hpp>
+#include "../../src/core/engine/spell_verdict_cache.h"
+#include <string>
+#include <thread>
+#include <vector>
+
+TEST_CASE("SpellVerdictCache", "[spell_verdict_cache]") {
+    SECTION("HitsAndMisses") {
+        SpellVerdictCache cache(1024 * 1024);
+        bool verdict = false;
+
+        // Verify a stored verdict is returned and counted as a hit
+        REQUIRE_FALSE(cache.lookup("teh", verdict));
+        cache.store(cache.generation(), "teh", false);
+        verdict = true;
+        REQUIRE(cache.lookup("teh", verdict));
+        REQUIRE_FALSE(verdict);
+
+        // Verify case is preserved, since dictionary verdicts are case-sensitive
+        REQUIRE_FALSE(cache.lookup("Teh", verdict));
+
+        auto stats = cache.stats();
+        REQUIRE(stats.hits == 1);
+        REQUIRE(stats.misses == 2);
+        REQUIRE(stats.entries == 1);
+    }
+
+    SECTION("Invalidation") {
+        SpellVerdictCache cache(1024 * 1024);
+        bool verdict = false;
+        uint64_t staleGeneration = cache.generation();
+        cache.store(staleGeneration, "colour", false);
+
+        // Verify invalidation drops entries and rejects verdicts computed before it
+        cache.invalidate();
+        REQUIRE_FALSE(cache.lookup("colour", verdict));
+        cache.store(staleGeneration, "colour", false);
+        REQUIRE_FALSE(cache.lookup("colour", verdict));
+        cache.store(cache.generation(), "colour", true);
+        REQUIRE(cache.lookup("colour", verdict));
+        REQUIRE(verdict);
+    }
+
+    SECTION("MemoryBudget") {
+        SpellVerdictCache cache(64 * 1024);
+        for (int i = 0; i < 10000; ++i) {
+            cache.store(cache.generation(), "word" + std::to_string(i), true);
+        }
+
+        // Verify the cache evicts to stay within its budget and keeps recent words
+        auto stats = cache.stats();
+        REQUIRE(stats.bytes <= 64 * 1024);
+        REQUIRE(stats.entries < 10000);
+        bool verdict = false;
+        REQUIRE(cache.lookup("word9999", verdict));
+    }
+
+    SECTION("ConcurrentAccess") {
+        SpellVerdictCache cache(1024 * 1024);
+        std::vector<std::thread> threads;
+
+        // Read, write and invalidate from several threads at once
+        for (int t = 0; t < 4; ++t) {
+            threads.emplace_back([&cache, t] {
+                bool verdict = false;
+                for (int i = 0; i < 2000; ++i) {
+                    std::string word = "w" + std::to_string(i % 300);
+                    if (!cache.lookup(word, verdict)) {
+                        cache.store(cache.generation(), word, i % 2 == 0);
+                    }
+                    if (t == 0 && i % 500 == 0) {
+                        cache.invalidate();
+                    }
+                }
+            });
+        }
+        for (auto& thread : threads) {
+            thread.join();
+        }
+
+        auto stats = cache.stats();
+        REQUIRE(stats.hits + stats.misses == 8000);
+    }
+}
@@ -0,0 +1,131 @@
+#include <catch2/catch.hpp>
+#include "../../src/core/engine/suggestion_service.h"
+#include "../../src/core/engine/spell_check.h"
+#include <string>
+#include <vector>
+#include <algorithm>
+
+TEST_CASE("SuggestionService", "[suggestion_service]") {
+    SECTION("RequestResolvesAndCaches") {
+        SuggestionService service;
+
+        // The first request goes to the pool and resolves asynchronously
+        SuggestionRequest request = service.requestSuggestions("quik");
+        std::vector<std::string> suggestions = request.future().get();
+        REQUIRE(std::find(suggestions.begin(), suggestions.end(), "quick") != suggestions.end());
+        REQUIRE(request.isReady());
+
+        // The result is now cached and a second request is answered immediately
+        std::vector<std::string> cached;
+        REQUIRE(service.cachedSuggestions("quik", cached));
+        REQUIRE(cached == suggestions);
+
+        SuggestionRequest again = service.requestSuggestions("quik");
+        REQUIRE(again.isReady());
+        REQUIRE(again.future().get() == suggestions);
+        REQUIRE(service.stats().cacheHits == 1);
+    }
+
+    SECTION("ConcurrentRequestsShareOneComputation") {
+        SuggestionService service;
+
+        // Requests for a word already in flight join the pending computation
+        SuggestionRequest first = service.requestSuggestions("jumpps");
+        SuggestionRequest second = service.requestSuggestions("jumpps");
+        REQUIRE(first.future().get() == second.future().get());
+        REQUIRE(service.stats().inFlight == 0);
+        REQUIRE(service.stats().cachedWords == 1);
+    }
+
+    SECTION("CancelledRequestsAreDropped") {
+        SuggestionService service;
+
+        // Keep the single worker busy so the following requests stay queued
+        SuggestionRequest busy = service.requestSuggestions("lasy");
+        std::vector<SuggestionRequest> queued;
+        for (int i = 0; i < 32; ++i) {
+            queued.push_back(service.requestSuggestions("wrold" + std::to_string(i)));
+        }
+
+        // The last request is still queued behind all the others, so cancelling
+        // it drops it and resolves it right away without suggestions
+        SuggestionRequest& last = queued.back();
+        REQUIRE(last.cancel());
+        REQUIRE_FALSE(last.cancel());
+        REQUIRE(last.isReady());
+        REQUIRE(last.future().get().empty());
+        REQUIRE(service.stats().cancelled >= 1);
+
+        // Nothing is computed or cached for it once the worker gets there
+        for (auto& request : queued) {
+            request.cancel();
+        }
+        busy.future().get();
+        for (auto& request : queued) {
+            request.future().wait();
+        }
+        std::vector<std::string> cached;
+        REQUIRE_FALSE(service.cachedSuggestions("wrold31", cached));
+        REQUIRE(service.stats().inFlight == 0);
+    }
+
+    SECTION("CancelKeepsOtherInterest") {
+        SuggestionService service;
+
+        // Cancelling one of two handles for the same word keeps the computation
+        SuggestionRequest first = service.requestSuggestions("quik");
+        SuggestionRequest second = service.requestSuggestions("quik");
+        first.cancel();
+        std::vector<std::string> suggestions = second.future().get();
+        REQUIRE(std::find(suggestions.begin(), suggestions.end(), "quick") != suggestions.end());
+    }
+
+    SECTION("PrefetchFillsCache") {
+        SuggestionService service;
+        service.prefetch({"quik", "quik"});
+
+        // A request made after the prefetch completes is a cache hit
+        SuggestionRequest request = service.requestSuggestions("quik");
+        request.future().get();
+
+        std::vector<std::string> cached;
+        REQUIRE(service.cachedSuggestions("quik", cached));
+        REQUIRE(service.stats().cacheHits + service.stats().cacheMisses == 1);
+    }
+
+    SECTION("LanguageChangeClearsCache") {
+        SuggestionService service;
+        service.requestSuggestions("quik").future().get();
+
+        std::vector<std::string> cached;
+        service.setLanguage("en_US");
+        REQUIRE_FALSE(service.cachedSuggestions("quik", cached));
+    }
+
+    SECTION("CacheCapacityIsBounded") {
+        SuggestionService service("", 1, 2);
+        for (const char* word : {"quik", "jumpps", "lasy"}) {
+            service.requestSuggestions(word).future().get();
+        }
+
+        // The least recently used word was evicted
+        std::vector<std::string> cached;
+        REQUIRE(service.stats().cachedWords == 2);
+        REQUIRE_FALSE(service.cachedSuggestions("quik", cached));
+        REQUIRE(service.cachedSuggestions("lasy", cached));
+    }
+
+    SECTION("SharedPerLanguageAndBackend") {
+        // Callers of the same language and backend share one service
+        auto first = SuggestionService::shared("en_US", SuggestionBackend::Hunspell);
+        auto second = SuggestionService::shared("en_US", SuggestionBackend::Hunspell);
+        REQUIRE(first.get() == second.get());
+        REQUIRE(SuggestionService::shared("de_DE", SuggestionBackend::Hunspell).get() != first.get());
+        REQUIRE(SuggestionService::shared("en_US", SuggestionBackend::SymSpell).get() != first.get());
+
+        // Suggestions come from the service's own backend
+        std::vector<std::string> suggestions = SuggestionService::shared("en_US", SuggestionBackend::SymSpell)
+            ->requestSuggestions("quik").future().get();
+        REQUIRE(std::find(suggestions.begin(), suggestions.end(), "quick") != suggestions.end());
+    }
+}
@@ -0,0 +1,125 @@
+#include <catch2/catch.hpp>
+#include "../../src/core/engine/symspell_index.h"
+#include <chrono>
+#include <filesystem>
+#include <fstream>
+#include <string>
+#include <vector>
+
+// Helper function to build an index over a small ranked vocabulary
+std::shared_ptr<SymSpellIndex> buildTestIndex() {
+    auto index = std::make_shared<SymSpellIndex>();
+    index->addWord("the", 1000);
+    index->addWord("they", 300);
+    index->addWord("then", 200);
+    index->addWord("quick", 50);
+    index->addWord("quack", 5);
+    index->addWord("receive", 40);
+    index->addWord("separate", 30);
+    index->addWord("accommodation", 10);
+    index->addWord("Paris", 20);
+    index->addWord("\xD0\xBA\xD0\xBE\xD1\x82", 10); // "кот"
+    index->addWord("the", 10);
+    index->finalize();
+    return index;
+}
+
+TEST_CASE("SymSpellIndex", "[symspell_index]") {
+    auto index = buildTestIndex();
+    REQUIRE(index->wordCount() == 10);
+
+    SECTION("SuggestsWithinEditDistance") {
+        // One substitution, one transposition and two deletions
+        REQUIRE(index->lookup("quikc", 5).front() == "quick");
+        REQUIRE(index->lookup("recieve", 5).front() == "receive");
+        REQUIRE(index->lookup("seperate", 5).front() == "separate");
+        REQUIRE(index->lookup("accomodaton", 5).front() == "accommodation");
+
+        // Nothing within two edits of an unrelated word
+        REQUIRE(index->lookup("xylophone", 5).empty());
+    }
+
+    SECTION("RanksByDistanceThenFrequency") {
+        auto suggestions = index->lookup("teh", 3);
+        REQUIRE(suggestions.size() == 3);
+        REQUIRE(suggestions[0] == "the");
+
+        // "quick" and "quack" are both one edit from "quck"; "quick" is more frequent
+        suggestions = index->lookup("quck", 5);
+        REQUIRE(suggestions.size() >= 2);
+        REQUIRE(suggestions[0] == "quick");
+        REQUIRE(suggestions[1] == "quack");
+
+        REQUIRE(index->lookup("teh", 1).size() == 1);
+    }
+
+    SECTION("CarriesCapitalisation") {
+        REQUIRE(index->lookup("Teh", 1).front() == "The");
+        REQUIRE(index->lookup("TEH", 1).front() == "THE");
+        REQUIRE(index->lookup("pariss", 1).front() == "Paris");
+    }
+
+    SECTION("HandlesNonAsciiWords") {
+        // "кто" is a transposition of "кот", "КОТЫ" one insertion away
+        REQUIRE(index->lookup("\xD0\xBA\xD1\x82\xD0\xBE", 1).front() == "\xD0\xBA\xD0\xBE\xD1\x82");
+        REQUIRE(index->lookup("\xD0\x9A\xD0\x9E\xD0\xA2\xD0\xAB", 1).front() == "\xD0\x9A\xD0\x9E\xD0\xA2");
+    }
+
+    SECTION("SaveAndLoad") {
+        std::string path = (std::filesystem::temp_directory_path() / "symspell_index_test.symspell").string();
+        REQUIRE(index->save(path));
+
+        auto loaded = SymSpellIndex::load(path);
+        REQUIRE(loaded);
+        REQUIRE(loaded->wordCount() == index->wordCount());
+        REQUIRE(loaded->lookup("recieve", 5) == index->lookup("recieve", 5));
+        REQUIRE(loaded->lookup("teh", 5) == index->lookup("teh", 5));
+
+        // A truncated file is rejected rather than read out of bounds
+        std::filesystem::resize_file(path, std::filesystem::file_size(path) - 3);
+        REQUIRE_FALSE(SymSpellIndex::load(path));
+        REQUIRE_FALSE(SymSpellIndex::load(path + ".missing"));
+    }
+
+    SECTION("BuildFromDictionary") {
+        std::string path = (std::filesystem::temp_directory_path() / "symspell_index_test").string();
+        std::ofstream(path + ".dic") << "3\nhouse/S\ngarden\nmouse/S\n";
+        std::ofstream(path + ".freq") << "houses 900\nhouse 800\nmouses 5\ngardn 700\n";
+
+        // Frequency-list words the spell checker rejects are left out
+        auto built = SymSpellIndex::buildFromDictionary(path, [](const std::string& word) { return word != "gardn"; });
+        REQUIRE(built);
+        REQUIRE(built->wordCount() == 5);
+        REQUIRE(built->lookup("housse", 1).front() == "houses");
+        REQUIRE(built->lookup("gardne", 1).front() == "garden");
+        REQUIRE_FALSE(SymSpellIndex::buildFromDictionary(path + ".missing", nullptr));
+    }
+
+    SECTION("CachedIndexMustBeCurrent") {
+        std::string path = (std::filesystem::temp_directory_path() / "symspell_cached_test").string();
+        std::filesystem::remove(path + ".freq");
+        std::ofstream(path + ".dic") << "2\nhouse/S\nmouse/S\n";
+        REQUIRE(index->save(path + ".symspell"));
+        auto indexTime = std::filesystem::last_write_time(path + ".symspell");
+        std::filesystem::last_write_time(path + ".dic", indexTime - std::chrono::hours(1));
+        REQUIRE(SymSpellIndex::loadCached(path));
+
+        // A frequency list edited after the index was built makes it stale
+        std::ofstream(path + ".freq") << "houses 900\n";
+        std::filesystem::last_write_time(path + ".freq", indexTime + std::chrono::hours(1));
+        REQUIRE_FALSE(SymSpellIndex::loadCached(path));
+        std::filesystem::last_write_time(path + ".freq", indexTime - std::chrono::hours(1));
+        REQUIRE(SymSpellIndex::loadCached(path));
+
+        // So does a newer dictionary, or an index built with other parameters
+        std::filesystem::last_write_time(path + ".dic", indexTime + std::chrono::hours(1));
+        REQUIRE_FALSE(SymSpellIndex::loadCached(path));
+        std::filesystem::last_write_time(path + ".dic", indexTime - std::chrono::hours(1));
+        SymSpellIndex narrow(1, 4);
+        narrow.addWord("house", 1);
+        narrow.finalize();
+        REQUIRE(narrow.save(path + ".symspell"));
+        std::filesystem::last_write_time(path + ".symspell", indexTime);
+        REQUIRE_FALSE(SymSpellIndex::loadCached(path));
+    }
+}
@@ -1,5 +1,7 @@
 #include <catch2/catch.hpp>
 #include "../../src/core/engine/text_processing.h"
+#include "../../src/core/engine/suggestion_service.h"
+#include "../../src/core/engine/spell_check.h"
 #include <string>
 #include <vector>
 
@@ -55,6 +57,59 @@ TEST_CASE("TextProcessing", "[text_processing]") {
         REQUIRE(std::find(misspelledWords.begin(), misspelledWords.end(), "fox") == misspelledWords.end());
     }
 
+    SECTION("IncrementalProofing") {
+        // Create a TextProcessing object and proof the whole text once
+        TextProcessing textProcessor;
+        textProcessor.processText("The quik brown fox. It jumpps over the dog.");
+
+        // Fix the first misspelling and verify later results are shifted
+        const auto& afterFix = textProcessor.processEdit(4, 4, "quick");
+        REQUIRE(afterFix.spelling.size() == 1);
+        REQUIRE(afterFix.spelling[0].word == "jumpps");
+        REQUIRE(afterFix.spelling[0].startPos == 24);
+
+        // Insert a new misspelling and verify it is found at its document offset
+        const auto& afterInsert = textProcessor.processEdit(40, 0, "lasy ");
+        REQUIRE(afterInsert.spelling.size() == 2);
+        REQUIRE(afterInsert.spelling[1].word == "lasy");
+        REQUIRE(afterInsert.spelling[1].startPos == 40);
+
+        // Verify the incremental results match a full re-proof of the same text
+        TextProcessing fullProcessor;
+        fullProcessor.processText("The quick brown fox. It jumpps over the lasy dog.");
+        const auto& full = fullProcessor.processEdit(0, 0, "");
+        REQUIRE(full.spelling.size() == afterInsert.spelling.size());
+        REQUIRE(full.grammar.size() == afterInsert.grammar.size());
+
+        // An edit that moves a sentence boundary before the edited sentence
+        // re-proofs the sentence split off in front of it too
+        TextProcessing splitProcessor;
+        splitProcessor.processText("Hello. 123 w");
+        const auto& afterSplit = splitProcessor.processEdit(11, 1, "W");
+        TextProcessing splitFullProcessor;
+        splitFullProcessor.processText("Hello. 123 W");
+        const auto& splitFull = splitFullProcessor.processEdit(0, 0, "");
+        REQUIRE(splitFull.grammar.size() == afterSplit.grammar.size());
+        for (size_t i = 0; i < splitFull.grammar.size(); ++i) {
+            REQUIRE(splitFull.grammar[i].startPos == afterSplit.grammar[i].startPos);
+            REQUIRE(splitFull.grammar[i].endPos == afterSplit.grammar[i].endPos);
+        }
+    }
+
+    SECTION("SharedSuggestionService") {
+        // Documents of the same language and backend share one suggestion service
+        TextProcessing first;
+        TextProcessing second;
+        REQUIRE(&first.suggestionService() == &second.suggestionService());
+
+        // A document moves to the service of its new language, then backend
+        REQUIRE(second.setLanguage("de_DE"));
+        REQUIRE(&second.suggestionService() == SuggestionService::shared("de_DE", SuggestionBackend::Hunspell).get());
+        second.setSuggestionBackend("de_DE", SuggestionBackend::SymSpell);
+        REQUIRE(&second.suggestionService() == SuggestionService::shared("de_DE", SuggestionBackend::SymSpell).get());
+        REQUIRE(&first.suggestionService() != &second.suggestionService());
+    }
+
     SECTION("GrammarChecking") {
         // Create a TextProcessing object
         TextProcessing textProcessor;
@@ -0,0 +1,130 @@
+#include <catch2/catch.hpp>
+#include "../../src/core/engine/text_segmentation.h"
+#include <string>
+#include <vector>
+
+// Helper function to collect the text of each token
+std::vector<std::string> tokenTexts(const std::vector<TextToken>& tokens) {
+    std::vector<std::string> texts;
+    for (const auto& token : tokens) {
+        texts.emplace_back(token.text);
+    }
+    return texts;
+}
+
+// Helper function to collect the text of each sentence
+std::vector<std::string> sentenceTexts(const std::vector<TextSegment>& sentences) {
+    std::vector<std::string> texts;
+    for (const auto& sentence : sentences) {
+        texts.emplace_back(sentence.text);
+    }
+    return texts;
+}
+
+TEST_CASE("TextSegmentation", "[text_segmentation]") {
+    SECTION("AsciiWords") {
+        std::string text = "The quick brown fox, don't jump!";
+        auto tokens = tokenizeText(text);
+
+        // Verify words, apostrophes and punctuation follow the word boundary rules
+        REQUIRE(tokenTexts(tokens) == std::vector<std::string>{"The", "quick", "brown", "fox", ",", "don't", "jump", "!"});
+        REQUIRE(tokens[5].type == TokenType::Word);
+        REQUIRE(tokens[4].type == TokenType::Punctuation);
+
+        // Verify offsets point back into the source text
+        for (const auto& token : tokens) {
+            REQUIRE(text.substr(token.offset, token.length) == token.text);
+        }
+    }
+
+    SECTION("NumbersAndQuotes") {
+        auto tokens = tokenizeText("'Pay 3.50 or 1,000' now");
+
+        // Verify decimal and thousands separators stay inside numbers while quotes split off
+        REQUIRE(tokenTexts(tokens) == std::vector<std::string>{"'", "Pay", "3.50", "or", "1,000", "'", "now"});
+    }
+
+    SECTION("UnicodeWords") {
+        auto tokens = tokenizeText("Hello, 世界! 😊 Здравствуй, мир! naïve");
+
+        // Verify multi-byte words are kept whole and ideographs are not treated as spellable words
+        REQUIRE(tokenTexts(tokens) == std::vector<std::string>{"Hello", ",", "世", "界", "!", "😊", "Здравствуй", ",", "мир", "!", "naïve"});
+        REQUIRE(tokens[2].type == TokenType::Ideographic);
+        REQUIRE(tokens[5].type == TokenType::Punctuation);
+        REQUIRE(tokens[6].type == TokenType::Word);
+    }
+
+    SECTION("MalformedUtf8") {
+        auto tokens = tokenizeText("ab\xff" "cd");
+
+        // Verify invalid bytes become single-byte tokens without swallowing neighbours
+        REQUIRE(tokenTexts(tokens) == std::vector<std::string>{"ab", "\xff", "cd"});
+    }
+
+    SECTION("Sentences") {
+        std::string text = "He paid $3.50 for it! Did he? \"Yes.\" Really... yes.\nNew paragraph";
+        auto sentences = splitIntoSentences(text);
+
+        // Verify decimals, closing quotes, ellipses and paragraph breaks
+        REQUIRE(sentenceTexts(sentences) == std::vector<std::string>{
+            "He paid $3.50 for it! ", "Did he? ", "\"Yes.\" ", "Really... yes.\n", "New paragraph"});
+        REQUIRE(sentences[1].offset == 22);
+    }
+
+    SECTION("UnicodeSentences") {
+        auto sentences = splitIntoSentences("第一句。第二句！");
+
+        // Verify ideographic full stops end sentences without trailing spaces
+        REQUIRE(sentenceTexts(sentences) == std::vector<std::string>{"第一句。", "第二句！"});
+    }
+
+    SECTION("Abbreviations") {
+        auto sentences = splitIntoSentences("Dr. Watson met J. Smith at 5 p.m. on Baker St. in London. It rained.");
+
+        // Verify abbreviations and initials do not end sentences
+        REQUIRE(sentenceTexts(sentences) == std::vector<std::string>{
+            "Dr. Watson met J. Smith at 5 p.m. on Baker St. in London. ", "It rained."});
+    }
+
+    SECTION("WordsThatEndSentences") {
+        auto sentences = splitIntoSentences("The answer was no. We left. So did I. Then it rained on No. 5 Main St. again.");
+
+        // Verify "no" and the pronoun "I" end sentences; "No." before a number does not
+        REQUIRE(sentenceTexts(sentences) == std::vector<std::string>{
+            "The answer was no. ", "We left. ", "So did I. ", "Then it rained on No. 5 Main St. again."});
+
+        // Verify months and street names end sentences unless a number follows
+        sentences = splitIntoSentences("It opened on Dec. 25 on Elm St. The shop closed in Dec. We moved to Oak St. Then it rained.");
+        REQUIRE(sentenceTexts(sentences) == std::vector<std::string>{
+            "It opened on Dec. 25 on Elm St. ", "The shop closed in Dec. ", "We moved to Oak St. ", "Then it rained."});
+    }
+
+    SECTION("AbbreviationsPerLanguage") {
+        auto german = splitIntoSentences("Wir treffen Prof. Meier bzw. Frau Schulz. Sie wohnt in Nr. 5 und kommt ca. 8 Uhr.", "de_DE");
+
+        // Verify each language uses its own abbreviations
+        REQUIRE(sentenceTexts(german) == std::vector<std::string>{
+            "Wir treffen Prof. Meier bzw. Frau Schulz. ", "Sie wohnt in Nr. 5 und kommt ca. 8 Uhr."});
+
+        // Verify the English list does not apply to other languages ("col" is cabbage in Spanish)
+        auto spanish = splitIntoSentences("Compré una col. Luego volví.", "es_ES");
+        REQUIRE(sentenceTexts(spanish) == std::vector<std::string>{"Compré una col. ", "Luego volví."});
+        REQUIRE(splitIntoSentences("He met Col. Brown.", "en_GB").size() == 1);
+    }
+
+    SECTION("StreamingSplitter") {
+        std::string text = "First one. Second one? Third.";
+        SentenceSplitter splitter(text);
+        TextSegment sentence;
+
+        // Verify sentences are produced one at a time as views into the text
+        REQUIRE(splitter.next(sentence));
+        REQUIRE(sentence.text == "First one. ");
+        REQUIRE(splitter.next(sentence));
+        REQUIRE(sentence.offset == 11);
+        REQUIRE(sentence.text.data() == text.data() + 11);
+        REQUIRE(splitter.next(sentence));
+        REQUIRE(sentence.text == "Third.");
+        REQUIRE_FALSE(splitter.next(sentence));
+    }
+}
@@ -0,0 +1,109 @@
+#include <catch2/catch.hpp>
+#include "../../src/core/engine/word_table.h"
+#include "../../src/core/engine/text_segmentation.h"
+#include <string>
+#include <thread>
+#include <vector>
+
+TEST_CASE("WordTable", "[word_table]") {
+    SECTION("StableIds") {
+        WordTable table;
+        uint32_t the = table.intern("the");
+        uint32_t cat = table.intern("cat");
+
+        // Verify repeated words map to the same ID and the text and hash round-trip
+        REQUIRE(the != cat);
+        REQUIRE(table.intern(std::string("the")) == the);
+        REQUIRE(table.find("cat") == cat);
+        REQUIRE(table.find("dog") == INVALID_WORD_ID);
+        REQUIRE(table.text(the) == "the");
+        REQUIRE(table.hash(cat) == hashWord("cat"));
+        REQUIRE(table.size() == 2);
+    }
+
+    SECTION("RejectsOverlongWords") {
+        WordTable table;
+
+        // Verify empty and overlong input is not interned
+        REQUIRE(table.intern("") == INVALID_WORD_ID);
+        REQUIRE(table.intern(std::string(200, 'a')) == INVALID_WORD_ID);
+        REQUIRE(table.size() == 0);
+    }
+
+    SECTION("GrowthIsCapped") {
+        // A table limited to 64 words holds at most one per shard
+        WordTable table(64);
+        std::vector<std::pair<std::string, uint32_t>> interned;
+        std::vector<std::string> rejected;
+        for (int i = 0; i < 10000; ++i) {
+            std::string word = "typo" + std::to_string(i);
+            uint32_t id = table.intern(word);
+            if (id != INVALID_WORD_ID) {
+                interned.emplace_back(word, id);
+            } else {
+                rejected.push_back(word);
+            }
+        }
+
+        // Verify the table stops at its limit and keeps the IDs it handed out
+        REQUIRE(table.size() <= 64);
+        REQUIRE(table.size() == interned.size());
+        for (const auto& word : interned) {
+            REQUIRE(table.intern(word.first) == word.second);
+            REQUIRE(table.text(word.second) == word.first);
+        }
+        REQUIRE_FALSE(rejected.empty());
+        REQUIRE(table.intern(rejected.front()) == INVALID_WORD_ID);
+        REQUIRE(table.find(rejected.front()) == INVALID_WORD_ID);
+    }
+
+    SECTION("ConcurrentInterning") {
+        WordTable table;
+        std::vector<std::vector<uint32_t>> ids(4);
+        std::vector<std::thread> threads;
+
+        // Intern the same vocabulary from several threads at once
+        for (size_t t = 0; t < ids.size(); ++t) {
+            threads.emplace_back([&table, &ids, t] {
+                for (int i = 0; i < 5000; ++i) {
+                    ids[t].push_back(table.intern("word" + std::to_string(i)));
+                }
+            });
+        }
+        for (auto& thread : threads) {
+            thread.join();
+        }
+
+        // Verify every thread saw the same ID for each word
+        for (size_t t = 1; t < ids.size(); ++t) {
+            REQUIRE(ids[t] == ids[0]);
+        }
+        REQUIRE(table.size() == 5000);
+        REQUIRE(table.text(ids[0][1234]) == "word1234");
+    }
+
+    SECTION("TablesDoNotShareCachedIds") {
+        // A table created after another is destroyed may take its address; the
+        // words the old one interned must not be found in the new one
+        {
+            WordTable table;
+            REQUIRE(table.intern("ephemeral") != INVALID_WORD_ID);
+        }
+        WordTable table;
+        REQUIRE(table.find("ephemeral") == INVALID_WORD_ID);
+        uint32_t id = table.intern("ephemeral");
+        REQUIRE(table.text(id) == "ephemeral");
+        REQUIRE(table.size() == 1);
+    }
+
+    SECTION("TokensCarryIds") {
+        WordTable table;
+        auto tokens = tokenizeText("the cat, the hat", table);
+
+        // Verify word tokens carry IDs and punctuation does not
+        REQUIRE(tokens[0].wordId == tokens[3].wordId);
+        REQUIRE(tokens[0].wordId != tokens[1].wordId);
+        REQUIRE(tokens[2].wordId == INVALID_WORD_ID);
+        REQUIRE(table.text(tokens[4].wordId) == "hat");
+    }
+}